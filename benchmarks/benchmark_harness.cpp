@@ -0,0 +1,269 @@
+#include "benchmark_harness.hpp"
+
+#include "hotplugpp/log.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+namespace hotplugpp {
+namespace bench {
+
+namespace {
+
+struct Registration {
+    std::string name;
+    BenchmarkFunc func;
+    size_t iterations;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;
+    size_t batchSize = 1;
+    double meanNs = 0.0;
+    double medianNs = 0.0;
+    double p99Ns = 0.0;
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    std::string error;
+};
+
+struct Options {
+    std::string filter;
+    std::string jsonPath;
+    double iterationScale = 1.0;
+};
+
+std::vector<Registration>& registry() {
+    static std::vector<Registration> s_registry;
+    return s_registry;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+Result summarize(const std::string& name, const State& state) {
+    Result result;
+    result.name = name;
+    result.error = state.getError();
+    result.batchSize = state.getBatchSize();
+
+    std::vector<double> samples = state.getSamples();
+    result.iterations = samples.size();
+    if (samples.empty()) {
+        return result;
+    }
+
+    // Samples are whole iterations; report per operation
+    for (double& sample : samples) {
+        sample /= static_cast<double>(result.batchSize);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result.meanNs = sum / static_cast<double>(samples.size());
+    result.medianNs = percentile(samples, 0.5);
+    result.p99Ns = percentile(samples, 0.99);
+    result.minNs = samples.front();
+    result.maxNs = samples.back();
+    return result;
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string currentDate() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << currentDate() << "\",\n";
+#ifdef NDEBUG
+    out << "    \"build_type\": \"release\",\n";
+#else
+    out << "    \"build_type\": \"debug\",\n";
+#endif
+    out << "    \"time_unit\": \"ns\"\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << escapeJson(result.name) << "\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"batch_size\": " << result.batchSize << ",\n";
+        out << "      \"mean_ns\": " << result.meanNs << ",\n";
+        out << "      \"median_ns\": " << result.medianNs << ",\n";
+        out << "      \"p99_ns\": " << result.p99Ns << ",\n";
+        out << "      \"min_ns\": " << result.minNs << ",\n";
+        out << "      \"max_ns\": " << result.maxNs;
+        if (!result.error.empty()) {
+            out << ",\n      \"error\": \"" << escapeJson(result.error) << "\"";
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void printTable(const std::vector<Result>& results) {
+    std::cout << std::left << std::setw(36) << "Benchmark" << std::right << std::setw(12)
+              << "median ns" << std::setw(12) << "p99 ns" << std::setw(12) << "max ns"
+              << std::setw(10) << "iters" << std::endl;
+    std::cout << std::string(82, '-') << std::endl;
+    for (const Result& result : results) {
+        std::cout << std::left << std::setw(36) << result.name << std::right;
+        if (!result.error.empty()) {
+            std::cout << "  ERROR: " << result.error << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(1) << std::setw(12) << result.medianNs
+                  << std::setw(12) << result.p99Ns << std::setw(12) << result.maxNs
+                  << std::setw(10) << result.iterations << std::endl;
+    }
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            options.filter = arg.substr(9);
+        } else if (arg.rfind("--json=", 0) == 0) {
+            options.jsonPath = arg.substr(7);
+        } else if (arg.rfind("--scale=", 0) == 0) {
+            options.iterationScale = std::atof(arg.c_str() + 8);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter=<substring>] [--json=<file|->] [--scale=<factor>]"
+                      << std::endl;
+            return false;
+        }
+    }
+    return options.iterationScale > 0.0;
+}
+
+} // namespace
+
+State::State(size_t iterations, size_t warmupIterations)
+    : m_iterations(iterations), m_warmupIterations(warmupIterations) {
+    m_samples.reserve(iterations);
+}
+
+bool State::keepRunning() {
+    if (m_started > 0) {
+        finishIteration();
+    }
+    if (!m_error.empty() || m_started == m_warmupIterations + m_iterations) {
+        return false;
+    }
+
+    ++m_started;
+    m_elapsed = Clock::duration(0);
+    m_running = true;
+    m_start = Clock::now();
+    return true;
+}
+
+void State::pauseTiming() {
+    if (m_running) {
+        m_elapsed += Clock::now() - m_start;
+        m_running = false;
+    }
+}
+
+void State::resumeTiming() {
+    if (!m_running) {
+        m_running = true;
+        m_start = Clock::now();
+    }
+}
+
+void State::skipWithError(const std::string& message) {
+    m_error = message;
+}
+
+void State::finishIteration() {
+    pauseTiming();
+    if (m_started > m_warmupIterations && m_error.empty()) {
+        m_samples.push_back(std::chrono::duration<double, std::nano>(m_elapsed).count());
+    }
+}
+
+int registerBenchmark(const std::string& name, BenchmarkFunc func, size_t iterations) {
+    registry().push_back(Registration{name, std::move(func), iterations});
+    return 0;
+}
+
+} // namespace bench
+} // namespace hotplugpp
+
+int main(int argc, char* argv[]) {
+    using namespace hotplugpp::bench;
+
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    // Loader diagnostics are not part of what is measured
+    hotplugpp::setLogLevel(hotplugpp::LogLevel::Off);
+
+    std::vector<Result> results;
+    for (const Registration& registration : registry()) {
+        if (registration.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        size_t iterations = std::max<size_t>(
+            1, static_cast<size_t>(static_cast<double>(registration.iterations) *
+                                   options.iterationScale));
+        State state(iterations, std::max<size_t>(1, iterations / 10));
+        {
+            ScopedSilence silence;
+            registration.func(state);
+        }
+        results.push_back(summarize(registration.name, state));
+    }
+
+    printTable(results);
+
+    if (options.jsonPath == "-") {
+        writeJson(std::cout, results);
+    } else if (!options.jsonPath.empty()) {
+        std::ofstream file(options.jsonPath);
+        if (!file) {
+            std::cerr << "Failed to open JSON output file: " << options.jsonPath << std::endl;
+            return 1;
+        }
+        writeJson(file, results);
+        std::cout << "Results written to " << options.jsonPath << std::endl;
+    }
+
+    for (const Result& result : results) {
+        if (!result.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace hotplugpp {
+namespace bench {
+
+/**
+ * @brief Timing state handed to a benchmark body
+ *
+ * The body runs its measured code in a `while (state.keepRunning())` loop.
+ * Every iteration is timed separately so the report can show percentiles;
+ * setup and teardown inside an iteration are excluded with pauseTiming()
+ * and resumeTiming().
+ */
+class State {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Create a state for a fixed number of measured iterations
+     * @param iterations Measured iterations
+     * @param warmupIterations Iterations run first and discarded
+     */
+    State(size_t iterations, size_t warmupIterations);
+
+    /**
+     * @brief Finish the current iteration and start the next one
+     * @return false once all iterations have run
+     */
+    bool keepRunning();
+
+    /**
+     * @brief Stop the clock for untimed setup or teardown work
+     */
+    void pauseTiming();
+
+    /**
+     * @brief Restart the clock after pauseTiming()
+     */
+    void resumeTiming();
+
+    /**
+     * @brief Declare how many operations one iteration performs
+     *
+     * Results are reported per operation. Use this for operations that are
+     * too short to time one by one.
+     *
+     * @param batchSize Operations per iteration
+     */
+    void setBatchSize(size_t batchSize) { m_batchSize = batchSize; }
+
+    /**
+     * @brief Mark the benchmark as failed, e.g. because the plugin did not load
+     * @param message Reason shown in the report
+     */
+    void skipWithError(const std::string& message);
+
+    size_t getBatchSize() const { return m_batchSize; }
+    const std::vector<double>& getSamples() const { return m_samples; }
+    const std::string& getError() const { return m_error; }
+
+  private:
+    size_t m_iterations;
+    size_t m_warmupIterations;
+    size_t m_started = 0;
+    size_t m_batchSize = 1;
+    bool m_running = false;
+    Clock::time_point m_start;
+    Clock::duration m_elapsed{0};
+    std::vector<double> m_samples;
+    std::string m_error;
+
+    void finishIteration();
+};
+
+/// Benchmark body
+using BenchmarkFunc = std::function<void(State&)>;
+
+/**
+ * @brief Register a benchmark with the harness
+ * @param name Unique name, conventionally "<Group>/<stage>"
+ * @param func Benchmark body
+ * @param iterations Default number of measured iterations
+ * @return Always 0, so it can initialize a static
+ */
+int registerBenchmark(const std::string& name, BenchmarkFunc func, size_t iterations);
+
+/**
+ * @brief Discards everything written to it, so plugin output does not skew timings
+ */
+class NullBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * @brief Redirects std::cout/std::cerr into a NullBuffer for its lifetime
+ */
+class ScopedSilence {
+  public:
+    ScopedSilence() : m_cout(std::cout.rdbuf(&m_null)), m_cerr(std::cerr.rdbuf(&m_null)) {}
+
+    ~ScopedSilence() {
+        std::cout.rdbuf(m_cout);
+        std::cerr.rdbuf(m_cerr);
+    }
+
+  private:
+    NullBuffer m_null;
+    std::streambuf* m_cout;
+    std::streambuf* m_cerr;
+};
+
+/**
+ * @brief Keep the compiler from optimizing away a computed value
+ * @param value Value to keep
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sink;
+    s_sink = &value;
+#endif
+}
+
+} // namespace bench
+} // namespace hotplugpp
+
+#define HOTPLUGPP_BENCH_CONCAT_IMPL(a, b) a##b
+#define HOTPLUGPP_BENCH_CONCAT(a, b) HOTPLUGPP_BENCH_CONCAT_IMPL(a, b)
+
+// Register a benchmark body at static initialization time
+#define HOTPLUGPP_BENCHMARK(name, iterations, func)                                               \
+    static const int HOTPLUGPP_BENCH_CONCAT(s_benchmark_, __LINE__) =                              \
+        ::hotplugpp::bench::registerBenchmark(name, func, iterations)
@@ -0,0 +1,491 @@
+#include "hotplugpp/message_bus.hpp"
+#include "hotplugpp/plugin_index.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+#include "hotplugpp/plugin_manager.hpp"
+#include "hotplugpp/plugin_metadata.hpp"
+#include "hotplugpp/remote_plugin.hpp"
+#include "hotplugpp/shared_library.hpp"
+
+#include "benchmark_harness.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace hotplugpp {
+namespace bench {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const char* const PLUGIN_PATH = BENCH_PLUGIN_PATH;
+const char* const BATCH_PLUGIN_PATH = BENCH_BATCH_PLUGIN_PATH;
+const char* const TABLE_PLUGIN_PATH = BENCH_TABLE_PLUGIN_PATH;
+const char* const BUS_PRODUCER_PLUGIN_PATH = BENCH_BUS_PRODUCER_PLUGIN_PATH;
+const char* const BUS_CONSUMER_PLUGIN_PATH = BENCH_BUS_CONSUMER_PLUGIN_PATH;
+
+/// Instances per updateAll() in the Update/ benchmarks
+constexpr int UPDATE_INSTANCES = 1000;
+/// Library files per scan() in the Discovery/ benchmarks
+constexpr int SCAN_FILES = 1000;
+/// Producer and consumer plugin instances in the Bus/ benchmark
+constexpr int BUS_PRODUCERS = 4;
+constexpr int BUS_CONSUMERS = 4;
+/// Messages each producer publishes per update, see bus_plugin.cpp
+constexpr int BUS_BATCH = 64;
+
+/// Private copy of test_plugin whose modification time the benchmark can bump
+class ScratchPlugin {
+  public:
+    explicit ScratchPlugin(const std::string& name)
+        : m_path(fs::temp_directory_path() / ("hotplugpp_bench_" + name + ".so")) {
+        fs::copy_file(PLUGIN_PATH, m_path, fs::copy_options::overwrite_existing);
+    }
+
+    ~ScratchPlugin() {
+        std::error_code ec;
+        fs::remove(m_path, ec);
+    }
+
+    std::string path() const { return m_path.string(); }
+
+    /// Move the modification time forward so the loader sees a new build
+    void touch() {
+        m_bumps++;
+        fs::last_write_time(m_path, fs::file_time_type::clock::now() +
+                                        std::chrono::seconds(m_bumps));
+    }
+
+  private:
+    fs::path m_path;
+    int m_bumps = 0;
+};
+
+void benchLoadLibrary(State& state) {
+    while (state.keepRunning()) {
+        LibraryHandle handle = loadLibrary(PLUGIN_PATH);
+        state.pauseTiming();
+        if (!handle) {
+            state.skipWithError("loadLibrary failed: " + getLastError());
+            return;
+        }
+        unloadLibrary(handle);
+        state.resumeTiming();
+    }
+}
+
+void benchGetFunction(State& state) {
+    LibraryHandle handle = loadLibrary(PLUGIN_PATH);
+    if (!handle) {
+        state.skipWithError("loadLibrary failed: " + getLastError());
+        return;
+    }
+
+    state.setBatchSize(100);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 100; ++i) {
+            doNotOptimize(getFunction(handle, "createPlugin"));
+        }
+    }
+    unloadLibrary(handle);
+}
+
+void benchCreatePlugin(State& state) {
+    LibraryHandle handle = loadLibrary(PLUGIN_PATH);
+    auto createFunc = reinterpret_cast<CreatePluginFunc>(getFunction(handle, "createPlugin"));
+    auto destroyFunc = reinterpret_cast<DestroyPluginFunc>(getFunction(handle, "destroyPlugin"));
+    if (!createFunc || !destroyFunc) {
+        state.skipWithError("Failed to resolve plugin factory functions");
+        unloadLibrary(handle);
+        return;
+    }
+
+    while (state.keepRunning()) {
+        IPlugin* plugin = createFunc();
+        state.pauseTiming();
+        destroyFunc(plugin);
+        state.resumeTiming();
+    }
+    unloadLibrary(handle);
+}
+
+void benchOnLoad(State& state) {
+    LibraryHandle handle = loadLibrary(PLUGIN_PATH);
+    auto createFunc = reinterpret_cast<CreatePluginFunc>(getFunction(handle, "createPlugin"));
+    auto destroyFunc = reinterpret_cast<DestroyPluginFunc>(getFunction(handle, "destroyPlugin"));
+    if (!createFunc || !destroyFunc) {
+        state.skipWithError("Failed to resolve plugin factory functions");
+        unloadLibrary(handle);
+        return;
+    }
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        IPlugin* plugin = createFunc();
+        state.resumeTiming();
+
+        bool loaded = plugin->onLoad();
+
+        state.pauseTiming();
+        if (loaded) {
+            plugin->onUnload();
+        }
+        destroyFunc(plugin);
+        state.resumeTiming();
+    }
+    unloadLibrary(handle);
+}
+
+void benchUnloadPlugin(State& state) {
+    PluginLoader loader;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        if (!loader.loadPlugin(PLUGIN_PATH)) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+        state.resumeTiming();
+
+        loader.unloadPlugin();
+    }
+}
+
+void benchLoadPlugin(State& state) {
+    PluginLoader loader;
+    while (state.keepRunning()) {
+        bool loaded = loader.loadPlugin(PLUGIN_PATH);
+
+        state.pauseTiming();
+        if (!loaded) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+        loader.unloadPlugin();
+        state.resumeTiming();
+    }
+}
+
+void benchLoadPluginShared(State& state) {
+    // Keeps the library open, so every timed load is a cache hit
+    PluginLoader holder;
+    if (!holder.loadPlugin(PLUGIN_PATH)) {
+        state.skipWithError("loadPlugin failed");
+        return;
+    }
+
+    PluginLoader loader;
+    while (state.keepRunning()) {
+        bool loaded = loader.loadPlugin(PLUGIN_PATH);
+
+        state.pauseTiming();
+        if (!loaded) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+        loader.unloadPlugin();
+        state.resumeTiming();
+    }
+}
+
+void benchReadPluginMetadata(State& state) {
+    PluginMetadata metadata;
+    while (state.keepRunning()) {
+        bool read = readPluginMetadata(PLUGIN_PATH, metadata);
+
+        state.pauseTiming();
+        if (!read) {
+            state.skipWithError("readPluginMetadata failed");
+            return;
+        }
+        state.resumeTiming();
+    }
+}
+
+void benchCheckAndReloadIdle(State& state) {
+    PluginLoader loader;
+    if (!loader.loadPlugin(PLUGIN_PATH)) {
+        state.skipWithError("loadPlugin failed");
+        return;
+    }
+
+    state.setBatchSize(100);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 100; ++i) {
+            doNotOptimize(loader.checkAndReload());
+        }
+    }
+}
+
+void benchCheckAndReloadCycle(State& state) {
+    ScratchPlugin plugin("reload");
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    if (!loader.loadPlugin(plugin.path())) {
+        state.skipWithError("loadPlugin failed");
+        return;
+    }
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        plugin.touch();
+        state.resumeTiming();
+
+        bool reloaded = loader.checkAndReload();
+
+        state.pauseTiming();
+        if (!reloaded) {
+            state.skipWithError("checkAndReload did not reload the modified plugin");
+            return;
+        }
+        state.resumeTiming();
+    }
+}
+
+void benchOnUpdate(State& state) {
+    PluginLoader loader;
+    if (!loader.loadPlugin(PLUGIN_PATH)) {
+        state.skipWithError("loadPlugin failed");
+        return;
+    }
+
+    // Dispatch through a pointer the compiler cannot see through
+    IPlugin* plugin = loader.getPlugin();
+    doNotOptimize(plugin);
+
+    state.setBatchSize(1000);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 1000; ++i) {
+            plugin->onUpdate(0.016f);
+        }
+    }
+}
+
+/**
+ * @brief onUpdate() inside a readPlugin() guard, the cost of reload-safe access from any thread
+ */
+void benchReadPluginUpdate(State& state) {
+    PluginLoader loader;
+    if (!loader.loadPlugin(PLUGIN_PATH)) {
+        state.skipWithError("loadPlugin failed");
+        return;
+    }
+
+    state.setBatchSize(1000);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 1000; ++i) {
+            PluginLoader::ReadGuard plugin = loader.readPlugin();
+            plugin->onUpdate(0.016f);
+        }
+    }
+}
+
+void benchFunctionTableUpdate(State& state) {
+    PluginLoader loader;
+    if (!loader.loadPlugin(TABLE_PLUGIN_PATH) || !loader.getFunctionTable()) {
+        state.skipWithError("loadPlugin failed or plugin has no function table");
+        return;
+    }
+
+    // Same call as Lifecycle/onUpdate, through the cached C entry point
+    void* instance = loader.getPlugin();
+    auto update = loader.getFunctionTable()->update;
+    doNotOptimize(instance);
+    doNotOptimize(update);
+
+    state.setBatchSize(1000);
+    while (state.keepRunning()) {
+        for (int i = 0; i < 1000; ++i) {
+            update(instance, 0.016f);
+        }
+    }
+}
+
+/**
+ * @brief Same call as Lifecycle/onUpdate, dispatched to a plugin process and awaited
+ */
+void benchRemoteUpdate(State& state) {
+    ScopedSilence silence;
+    RemotePlugin remote;
+    if (!remote.start(PLUGIN_PATH)) {
+        state.skipWithError("RemotePlugin::start failed");
+        return;
+    }
+
+    while (state.keepRunning()) {
+        bool updated = remote.update(0.016f);
+
+        state.pauseTiming();
+        if (!updated) {
+            state.skipWithError("RemotePlugin::update failed");
+            return;
+        }
+        state.resumeTiming();
+    }
+}
+
+/**
+ * @brief Directory holding SCAN_FILES copies of test_plugin, plus a saved index of it
+ */
+class ScratchPluginDirectory {
+  public:
+    ScratchPluginDirectory() : m_dir(fs::temp_directory_path() / "hotplugpp_bench_scan") {
+        fs::remove_all(m_dir);
+        fs::create_directories(m_dir);
+        for (int i = 0; i < SCAN_FILES; ++i) {
+            fs::copy_file(PLUGIN_PATH, m_dir / ("plugin_" + std::to_string(i) + ".so"));
+        }
+        PluginIndex index;
+        index.scan({path()});
+        index.save(indexPath());
+    }
+
+    ~ScratchPluginDirectory() {
+        std::error_code ec;
+        fs::remove_all(m_dir, ec);
+        fs::remove(indexPath(), ec);
+    }
+
+    std::string path() const { return m_dir.string(); }
+    std::string indexPath() const { return m_dir.string() + ".index"; }
+
+  private:
+    fs::path m_dir;
+};
+
+/**
+ * @brief Full scan of SCAN_FILES libraries, reported per file
+ */
+void benchScanCold(State& state) {
+    ScratchPluginDirectory directory;
+    state.setBatchSize(SCAN_FILES);
+    while (state.keepRunning()) {
+        PluginIndex index;
+        PluginScanStats stats = index.scan({directory.path()});
+
+        state.pauseTiming();
+        if (stats.probed != static_cast<size_t>(SCAN_FILES)) {
+            state.skipWithError("scan missed files");
+            return;
+        }
+        state.resumeTiming();
+    }
+}
+
+/**
+ * @brief Loading the saved index and revalidating SCAN_FILES unchanged libraries, per file
+ */
+void benchScanWarm(State& state) {
+    ScratchPluginDirectory directory;
+    state.setBatchSize(SCAN_FILES);
+    while (state.keepRunning()) {
+        PluginIndex index;
+        index.load(directory.indexPath());
+        PluginScanStats stats = index.scan({directory.path()});
+
+        state.pauseTiming();
+        if (stats.reused != static_cast<size_t>(SCAN_FILES)) {
+            state.skipWithError("warm scan probed files");
+            return;
+        }
+        state.resumeTiming();
+    }
+}
+
+/**
+ * @brief updateAll() over UPDATE_INSTANCES instances of one library, reported per instance
+ */
+void runUpdateAll(State& state, const char* path, bool expectBatch, bool timed = false) {
+    ScopedSilence silence;
+    PluginManager manager;
+    manager.enableUpdateTiming(timed);
+    for (int i = 0; i < UPDATE_INSTANCES; ++i) {
+        if (!manager.loadPlugin(path).isValid()) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+    }
+    if (manager.isBatchUpdated(manager.getHandleAt(0)) != expectBatch) {
+        state.skipWithError("unexpected batch entry point");
+        return;
+    }
+
+    state.setBatchSize(UPDATE_INSTANCES);
+    while (state.keepRunning()) {
+        manager.updateAll(0.016f);
+    }
+}
+
+void benchUpdateAllVirtual(State& state) {
+    runUpdateAll(state, PLUGIN_PATH, false);
+}
+
+void benchUpdateAllBatch(State& state) {
+    runUpdateAll(state, BATCH_PLUGIN_PATH, true);
+}
+
+void benchUpdateAllFunctionTable(State& state) {
+    runUpdateAll(state, TABLE_PLUGIN_PATH, true);
+}
+
+void benchUpdateAllTimed(State& state) {
+    runUpdateAll(state, PLUGIN_PATH, false, true);
+}
+
+/**
+ * @brief Producer plugins publish and consumer plugins drain one shared channel
+ *
+ * Every updateAll() publishes BUS_PRODUCERS * BUS_BATCH messages, each read
+ * by all BUS_CONSUMERS; reported per published message.
+ */
+void benchBusThroughput(State& state) {
+    ScopedSilence silence;
+    MessageBus bus;
+    PluginManager manager;
+    manager.setMessageBus(&bus);
+    // Consumers subscribe in onLoad, so they go first to see every message
+    for (int i = 0; i < BUS_CONSUMERS; ++i) {
+        if (!manager.loadPlugin(BUS_CONSUMER_PLUGIN_PATH).isValid()) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+    }
+    for (int i = 0; i < BUS_PRODUCERS; ++i) {
+        if (!manager.loadPlugin(BUS_PRODUCER_PLUGIN_PATH).isValid()) {
+            state.skipWithError("loadPlugin failed");
+            return;
+        }
+    }
+
+    state.setBatchSize(BUS_PRODUCERS * BUS_BATCH);
+    while (state.keepRunning()) {
+        manager.updateAll(0.016f);
+    }
+}
+
+} // namespace
+
+HOTPLUGPP_BENCHMARK("Lifecycle/loadLibrary", 200, benchLoadLibrary);
+HOTPLUGPP_BENCHMARK("Lifecycle/getFunction", 1000, benchGetFunction);
+HOTPLUGPP_BENCHMARK("Lifecycle/createFunc", 1000, benchCreatePlugin);
+HOTPLUGPP_BENCHMARK("Lifecycle/onLoad", 1000, benchOnLoad);
+HOTPLUGPP_BENCHMARK("Lifecycle/loadPlugin", 200, benchLoadPlugin);
+HOTPLUGPP_BENCHMARK("Lifecycle/loadPlugin_shared", 1000, benchLoadPluginShared);
+HOTPLUGPP_BENCHMARK("Lifecycle/readPluginMetadata", 1000, benchReadPluginMetadata);
+HOTPLUGPP_BENCHMARK("Lifecycle/unloadPlugin", 200, benchUnloadPlugin);
+HOTPLUGPP_BENCHMARK("Lifecycle/checkAndReload_idle", 1000, benchCheckAndReloadIdle);
+HOTPLUGPP_BENCHMARK("Lifecycle/checkAndReload_cycle", 50, benchCheckAndReloadCycle);
+HOTPLUGPP_BENCHMARK("Lifecycle/onUpdate", 1000, benchOnUpdate);
+HOTPLUGPP_BENCHMARK("Lifecycle/readPlugin_update", 1000, benchReadPluginUpdate);
+HOTPLUGPP_BENCHMARK("Lifecycle/functionTable_update", 1000, benchFunctionTableUpdate);
+HOTPLUGPP_BENCHMARK("Remote/update", 1000, benchRemoteUpdate);
+HOTPLUGPP_BENCHMARK("Bus/publish_drain", 1000, benchBusThroughput);
+HOTPLUGPP_BENCHMARK("Discovery/scan_cold", 20, benchScanCold);
+HOTPLUGPP_BENCHMARK("Discovery/scan_warm", 20, benchScanWarm);
+HOTPLUGPP_BENCHMARK("Update/updateAll_virtual", 1000, benchUpdateAllVirtual);
+HOTPLUGPP_BENCHMARK("Update/updateAll_batch", 1000, benchUpdateAllBatch);
+HOTPLUGPP_BENCHMARK("Update/updateAll_functionTable", 1000, benchUpdateAllFunctionTable);
+HOTPLUGPP_BENCHMARK("Update/updateAll_timed", 1000, benchUpdateAllTimed);
+
+} // namespace bench
+} // namespace hotplugpp
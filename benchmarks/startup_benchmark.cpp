@@ -0,0 +1,115 @@
+#include "hotplugpp/log.hpp"
+#include "hotplugpp/plugin_manager.hpp"
+
+#include "benchmark_harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+using hotplugpp::bench::ScopedSilence;
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t pluginCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 400;
+    const size_t threadCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+    const int repetitions = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    if (pluginCount == 0 || repetitions <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [plugin_count] [threads] [repetitions]" << std::endl;
+        return 1;
+    }
+
+    hotplugpp::setLogLevel(hotplugpp::LogLevel::Off);
+
+    // Every plugin needs its own file, otherwise dlopen just bumps a refcount
+    fs::path dir = fs::temp_directory_path() / "hotplugpp_startup_benchmark";
+    fs::create_directories(dir);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < pluginCount; ++i) {
+        fs::path path = dir / ("plugin_" + std::to_string(i) + ".so");
+        fs::copy_file(BENCH_PLUGIN_PATH, path, fs::copy_options::overwrite_existing);
+        paths.push_back(path.string());
+    }
+
+    std::vector<double> serialMs;
+    std::vector<double> parallelMs;
+    std::vector<double> serialInitMs;
+    std::vector<double> deferredMs;
+    std::vector<double> deferredInitMs;
+
+    for (int rep = 0; rep < repetitions; ++rep) {
+        {
+            hotplugpp::PluginManager manager;
+            ScopedSilence silence;
+            auto start = Clock::now();
+            for (const auto& path : paths) {
+                manager.loadPlugin(path);
+            }
+            auto end = Clock::now();
+            serialMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        {
+            // Lazy binding, onLoad() paid later in an idle window
+            hotplugpp::PluginManager manager;
+            manager.setLoadPolicy(hotplugpp::LoadPolicy::Deferred);
+            ScopedSilence silence;
+            auto start = Clock::now();
+            for (const auto& path : paths) {
+                manager.loadPlugin(path);
+            }
+            auto loaded = Clock::now();
+            manager.initializePending();
+            auto end = Clock::now();
+            deferredMs.push_back(std::chrono::duration<double, std::milli>(loaded - start).count());
+            deferredInitMs.push_back(
+                std::chrono::duration<double, std::milli>(end - loaded).count());
+        }
+
+        for (bool parallelInit : {true, false}) {
+            hotplugpp::PluginManager manager;
+            hotplugpp::BatchLoadOptions options;
+            options.threadCount = threadCount;
+            options.parallelInit = parallelInit;
+
+            ScopedSilence silence;
+            auto start = Clock::now();
+            manager.loadPlugins(paths, options);
+            auto end = Clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            (parallelInit ? parallelMs : serialInitMs).push_back(ms);
+        }
+    }
+
+    std::cout << "Startup benchmark: " << pluginCount << " plugins, " << repetitions
+              << " repetitions (median)" << std::endl;
+    std::cout << "  serial loadPlugin():                " << median(serialMs) << " ms" << std::endl;
+    std::cout << "  loadPlugins(), parallel onLoad:     " << median(parallelMs) << " ms"
+              << std::endl;
+    std::cout << "  loadPlugins(), serial onLoad:       " << median(serialInitMs) << " ms"
+              << std::endl;
+    std::cout << "  serial loadPlugin(), deferred:      " << median(deferredMs) << " ms"
+              << std::endl;
+    std::cout << "    later initializePending():        " << median(deferredInitMs) << " ms"
+              << std::endl;
+    std::cout << "  speedup (parallel onLoad):          " << median(serialMs) / median(parallelMs)
+              << "x" << std::endl;
+
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/update_scheduler.hpp"
+
+#include "benchmark_harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using hotplugpp::UpdateAccess;
+using hotplugpp::UpdateScheduler;
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+/// CPU-bound stand-in for a plugin's onUpdate(); a fixed amount of work, not a fixed time
+uint64_t spin(uint64_t iterations) {
+    uint64_t x = 88172645463325252ull;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+/// Number of spin() iterations that take roughly one microsecond on this machine
+uint64_t calibrate() {
+    const uint64_t iterations = 1000000;
+    auto start = Clock::now();
+    hotplugpp::bench::doNotOptimize(spin(iterations));
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    return std::max<uint64_t>(1, static_cast<uint64_t>(iterations / std::max(us, 1.0)));
+}
+
+/// Independent plugins, e.g. one per entity type
+std::vector<UpdateAccess> independentGraph(size_t taskCount) {
+    std::vector<UpdateAccess> accesses(taskCount);
+    for (size_t i = 0; i < taskCount; ++i) {
+        accesses[i].writes.push_back(hotplugpp::fnv1a64("entity." + std::to_string(i)));
+    }
+    return accesses;
+}
+
+/// Four stages (input, simulation, animation, render); each task reads two outputs of the last one
+std::vector<UpdateAccess> layeredGraph(size_t taskCount) {
+    const size_t layers = 4;
+    const size_t perLayer = std::max<size_t>(1, taskCount / layers);
+    auto output = [](size_t task) {
+        return hotplugpp::fnv1a64("output." + std::to_string(task));
+    };
+
+    std::vector<UpdateAccess> accesses(taskCount);
+    for (size_t i = 0; i < taskCount; ++i) {
+        if (i >= perLayer) {
+            size_t previous = i - perLayer;
+            size_t layerStart = previous - previous % perLayer;
+            accesses[i].reads.push_back(output(previous));
+            accesses[i].reads.push_back(output(layerStart + (previous + 1) % perLayer));
+        }
+        accesses[i].writes.push_back(output(i));
+    }
+    return accesses;
+}
+
+/**
+ * @brief Print median tick time, speedup and parallel efficiency for 1..maxThreads workers
+ */
+void reportScaling(const char* name, const std::vector<UpdateAccess>& accesses,
+                   uint64_t iterationsPerTask, size_t maxThreads, int ticks) {
+    UpdateScheduler probe(1);
+    probe.build(accesses);
+    std::cout << name << " (" << accesses.size() << " tasks, critical path "
+              << probe.getCriticalPathLength() << ")" << std::endl;
+    std::cout << "  threads   tick (us)   speedup   efficiency   stolen/tick" << std::endl;
+
+    double baseline = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; ++threads) {
+        UpdateScheduler scheduler(threads);
+        scheduler.build(accesses);
+        auto task = [iterationsPerTask](uint32_t) {
+            hotplugpp::bench::doNotOptimize(spin(iterationsPerTask));
+        };
+
+        // Warm up the workers and caches
+        for (int i = 0; i < 3; ++i) {
+            scheduler.run(task);
+        }
+        scheduler.resetStats();
+
+        std::vector<double> tickUs;
+        for (int i = 0; i < ticks; ++i) {
+            auto start = Clock::now();
+            scheduler.run(task);
+            auto elapsed = Clock::now() - start;
+            tickUs.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+        }
+
+        uint64_t stolen = 0;
+        for (size_t worker = 0; worker < scheduler.getThreadCount(); ++worker) {
+            stolen += scheduler.getWorkerStats(worker).stolen;
+        }
+
+        double tick = median(tickUs);
+        if (threads == 1) {
+            baseline = tick;
+        }
+        double speedup = baseline / tick;
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::setw(7) << threads
+                  << std::setw(12) << tick << std::setprecision(2) << std::setw(9) << speedup
+                  << "x" << std::setw(11) << speedup / threads * 100.0 << "%" << std::setw(14)
+                  << static_cast<double>(stolen) / ticks << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t taskCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    const uint64_t taskUs = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    size_t maxThreads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    const int ticks = argc > 4 ? std::atoi(argv[4]) : 200;
+
+    if (taskCount == 0 || ticks <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [tasks] [us_per_task] [max_threads] [ticks]"
+                  << std::endl;
+        return 1;
+    }
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const uint64_t iterationsPerTask = calibrate() * taskUs;
+    std::cout << "Update scaling benchmark: ~" << taskUs << " us per task, " << ticks
+              << " ticks per thread count (median)" << std::endl
+              << std::endl;
+
+    reportScaling("Independent plugins", independentGraph(taskCount), iterationsPerTask,
+                  maxThreads, ticks);
+    reportScaling("Four dependent stages", layeredGraph(taskCount), iterationsPerTask, maxThreads,
+                  ticks);
+    return 0;
+}
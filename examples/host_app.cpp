@@ -1,10 +1,12 @@
+#include "hotplugpp/frame_pacer.hpp"
 #include "hotplugpp/plugin_loader.hpp"
+#include "hotplugpp/service_registry.hpp"
+#include "math_plugin/math_service.hpp"
 
 #include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <string>
-#include <thread>
 
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " <plugin_path>" << std::endl;
@@ -29,8 +31,11 @@ int main(int argc, char* argv[]) {
 
     std::string pluginPath = argv[1];
 
-    // Create plugin loader
+    // Create plugin loader; plugins can provide services through the registry
+    hotplugpp::ServiceRegistry services;
+    hotplugpp::ServiceRef<IMathService> math = services.find<IMathService>();
     hotplugpp::PluginLoader loader;
+    loader.setServiceRegistry(&services);
 
     // Set up reload callback
     loader.setReloadCallback([]() {
@@ -46,6 +51,14 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // The linker writes the library in several bursts; reload once it has been quiet for a moment
+    loader.setReloadDebounce(std::chrono::milliseconds(200));
+
+    // Watch the plugin file on a background thread so checking for changes is free
+    if (!loader.enableFileWatcher()) {
+        std::cerr << "File watcher unavailable, falling back to polling" << std::endl;
+    }
+
     std::cout << std::endl;
     std::cout << "Plugin loaded successfully!" << std::endl;
 
@@ -62,39 +75,46 @@ int main(int argc, char* argv[]) {
               << std::endl;
     std::cout << std::endl;
 
-    // Main loop
-    const float targetFPS = 60.0f;
-    const float deltaTime = 1.0f / targetFPS;
-    const auto frameDuration = std::chrono::microseconds(
-        static_cast<long long>(deltaTime * 1000000));
+    // Main loop: fixed 60 Hz steps, caught up after slow frames
+    hotplugpp::FramePacer pacer;
+    const float deltaTime = pacer.getTimestepSeconds();
+    auto toMs = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
 
-    uint64_t frameCount = 0;
-    while (true) {
-        auto frameStart = std::chrono::high_resolution_clock::now();
+    bool running = true;
+    while (running) {
+        uint32_t steps = pacer.beginFrame();
 
-        // Check for plugin reload every 60 frames (once per second at 60 FPS)
-        if (frameCount % 60 == 0) {
-            loader.checkAndReload();
-        }
+        // Drains the watcher's event queue; no system calls unless the plugin changed
+        loader.checkAndReload();
 
         // Update the plugin
-        plugin = loader.getPlugin();
-        if (plugin) {
+        for (; steps > 0; --steps) {
+            plugin = loader.getPlugin();
+            if (!plugin) {
+                std::cerr << "Plugin is not loaded!" << std::endl;
+                running = false;
+                break;
+            }
             plugin->onUpdate(deltaTime);
-        } else {
-            std::cerr << "Plugin is not loaded!" << std::endl;
-            break;
         }
 
-        frameCount++;
-
-        // Sleep to maintain target frame rate
-        auto frameEnd = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - frameStart);
-        auto sleepTime = frameDuration - elapsed;
-
-        if (sleepTime.count() > 0) {
-            std::this_thread::sleep_for(sleepTime);
+        // Report pacing every 10 seconds
+        if (pacer.getFrameCount() % 600 == 0) {
+            hotplugpp::LatencyStats frames = pacer.getFrameTimes().getStats();
+            hotplugpp::LatencyStats late = pacer.getWakeLatency().getStats();
+            std::cout << "[pacer] frame p50 " << toMs(frames.p50) << " ms, p99 "
+                      << toMs(frames.p99) << " ms, max " << toMs(frames.max)
+                      << " ms; wake-up p99 +" << toMs(late.p99) << " ms; dropped steps "
+                      << pacer.getDroppedSteps() << std::endl;
+
+            // Bound once above; follows MathPlugin across reloads
+            if (IMathService* service = math.get()) {
+                std::cout << "[math] " << service->getFibonacciCount()
+                          << " Fibonacci numbers, latest " << service->getLatestFibonacci()
+                          << std::endl;
+            }
         }
     }
 
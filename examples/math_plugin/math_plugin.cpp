@@ -1,22 +1,32 @@
-#include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/plugin_allocator.hpp"
+#include "hotplugpp/service_registry.hpp"
+
+#include "math_service.hpp"
 
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <vector>
 
+HOTPLUGPP_USE_SERVICE_REGISTRY()
+
 /**
  * @brief A more complex plugin demonstrating state management and computations
  *
  * This plugin calculates various mathematical sequences and demonstrates:
  * - Stateful plugin behavior
  * - More complex update logic
- * - Resource management
+ * - Resource management in a host-provided arena
+ * - State handoff across hot reloads
+ * - Providing a service through the host's registry
  */
-class MathPlugin : public hotplugpp::IPlugin {
+class MathPlugin : public hotplugpp::IPlugin, public IMathService {
   public:
-    MathPlugin() : m_frameCount(0), m_accumulatedTime(0.0f) {}
+    explicit MathPlugin(const HotPlugPPAllocator* allocator = nullptr)
+        : m_frameCount(0), m_accumulatedTime(0.0f),
+          m_fibonacci(hotplugpp::PluginAllocator<uint64_t>(allocator)) {}
 
     ~MathPlugin() override = default;
 
@@ -28,6 +38,11 @@ class MathPlugin : public hotplugpp::IPlugin {
         m_fibonacci.push_back(0);
         m_fibonacci.push_back(1);
 
+        // Withdrawn by the host on unload; a reloaded build takes over the same bindings
+        if (hotplugppServiceRegistry) {
+            hotplugppServiceRegistry->provide<IMathService>(this, this);
+        }
+
         std::cout << "[MathPlugin] Ready! Computing mathematical sequences." << std::endl;
         return true;
     }
@@ -77,7 +92,68 @@ class MathPlugin : public hotplugpp::IPlugin {
         return "Demonstrates state management with mathematical computations";
     }
 
+    size_t getFibonacciCount() const override { return m_fibonacci.size(); }
+
+    uint64_t getLatestFibonacci() const override {
+        return m_fibonacci.empty() ? 0 : m_fibonacci.back();
+    }
+
+    // The sequence and counters survive hot reloads instead of starting over
+    uint32_t getStateVersion() const override { return STATE_VERSION; }
+
+    size_t getStateSize() const override {
+        return sizeof(StateHeader) + m_fibonacci.size() * sizeof(uint64_t);
+    }
+
+    bool saveState(void* buffer, size_t size) override {
+        if (size < getStateSize()) {
+            return false;
+        }
+
+        StateHeader header;
+        header.frameCount = m_frameCount;
+        header.fibonacciCount = m_fibonacci.size();
+        header.accumulatedTime = m_accumulatedTime;
+        std::memcpy(buffer, &header, sizeof(header));
+        std::memcpy(static_cast<char*>(buffer) + sizeof(header), m_fibonacci.data(),
+                    m_fibonacci.size() * sizeof(uint64_t));
+        return true;
+    }
+
+    bool loadState(const void* data, size_t size, uint32_t version) override {
+        // Only one layout exists so far; older layouts would be migrated here
+        if (version != STATE_VERSION || size < sizeof(StateHeader)) {
+            return false;
+        }
+
+        const auto* header = static_cast<const StateHeader*>(data);
+        if (size < sizeof(StateHeader) + header->fibonacciCount * sizeof(uint64_t)) {
+            return false;
+        }
+
+        const auto* values = reinterpret_cast<const uint64_t*>(header + 1);
+        m_frameCount = header->frameCount;
+        m_accumulatedTime = header->accumulatedTime;
+        m_fibonacci.assign(values, values + header->fibonacciCount);
+
+        std::cout << "[MathPlugin] Restored " << m_fibonacci.size()
+                  << " Fibonacci numbers from the previous version" << std::endl;
+        return true;
+    }
+
   private:
+    static constexpr uint32_t STATE_VERSION = 1;
+
+    /// Layout of the saved state, followed by the Fibonacci numbers
+    struct StateHeader {
+        uint64_t frameCount;
+        uint64_t fibonacciCount;
+        float accumulatedTime;
+        uint32_t reserved = 0;
+    };
+    static_assert(sizeof(StateHeader) % alignof(uint64_t) == 0,
+                  "Fibonacci numbers must follow the header aligned");
+
     void computeNextFibonacci() {
         if (m_fibonacci.size() < 2)
             return;
@@ -99,8 +175,9 @@ class MathPlugin : public hotplugpp::IPlugin {
 
     uint64_t m_frameCount;
     float m_accumulatedTime;
-    std::vector<uint64_t> m_fibonacci;
+    // Allocated from the plugin's arena, which the host frees as a whole on unload
+    std::vector<uint64_t, hotplugpp::PluginAllocator<uint64_t>> m_fibonacci;
 };
 
 // Export the plugin
-HOTPLUGPP_CREATE_PLUGIN(MathPlugin)
+HOTPLUGPP_CREATE_PLUGIN_WITH_ALLOCATOR(MathPlugin)
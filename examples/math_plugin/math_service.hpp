@@ -0,0 +1,28 @@
+#pragma once
+
+#include "hotplugpp/service_registry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Service provided by MathPlugin to the host and other plugins
+ */
+class IMathService {
+  public:
+    HOTPLUGPP_SERVICE("IMathService", 1, 0)
+
+    virtual ~IMathService() = default;
+
+    /**
+     * @brief Get the number of Fibonacci numbers computed so far
+     * @return Sequence length
+     */
+    virtual size_t getFibonacciCount() const = 0;
+
+    /**
+     * @brief Get the latest Fibonacci number
+     * @return Last number of the sequence
+     */
+    virtual uint64_t getLatestFibonacci() const = 0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "plugin_allocator.hpp"
+
+#include <cstddef>
+
+namespace hotplugpp {
+
+/**
+ * @brief Chunked bump-pointer allocator that owns all memory of one plugin instance
+ *
+ * Allocation bumps a pointer through the current chunk and starts a new,
+ * larger chunk when it runs out. Individual frees are ignored except for the
+ * most recent allocation, which is rolled back so growing containers can
+ * reuse their space. Everything is released together by release() or the
+ * destructor, at a cost proportional to the number of chunks rather than the
+ * number of allocations, and whatever the plugin leaked goes with it.
+ *
+ * Not thread-safe: a plugin instance is updated by one thread at a time.
+ */
+class Arena {
+  public:
+    /// Size of the first chunk; later chunks double up to MAX_CHUNK_SIZE
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+
+    /**
+     * @brief Create an empty arena; no memory is reserved until the first allocation
+     * @param chunkSize Size of the first chunk in bytes
+     */
+    explicit Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Release all chunks
+     */
+    ~Arena();
+
+    // Disable copy: the allocator interface points back at this object
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate memory
+     * @param size Bytes to allocate
+     * @param alignment Power-of-two alignment
+     * @return Pointer to the memory, or nullptr if the system is out of memory
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Return memory early; only the most recent allocation is reclaimed
+     * @param ptr Pointer returned by allocate()
+     * @param size Size passed to allocate()
+     */
+    void deallocate(void* ptr, size_t size);
+
+    /**
+     * @brief Free every chunk; all pointers handed out become invalid
+     */
+    void release();
+
+    /**
+     * @brief Get the allocator interface to hand to a plugin
+     * @return Interface forwarding to this arena, valid for its lifetime
+     */
+    const HotPlugPPAllocator* getAllocator() const { return &m_allocator; }
+
+    /**
+     * @brief Get the bytes currently allocated, excluding alignment padding
+     * @return Bytes in use
+     */
+    size_t getBytesUsed() const { return m_bytesUsed; }
+
+    /**
+     * @brief Get the bytes reserved from the system
+     * @return Total size of all chunks
+     */
+    size_t getBytesReserved() const { return m_bytesReserved; }
+
+    /**
+     * @brief Get the number of chunks reserved from the system
+     * @return Chunk count
+     */
+    size_t getChunkCount() const { return m_chunkCount; }
+
+  private:
+    /// Header at the start of every chunk, followed by its data
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    bool addChunk(size_t minSize);
+
+    Chunk* m_chunks = nullptr;
+    char* m_top = nullptr;
+    char* m_end = nullptr;
+    /// Start of the most recent allocation, the only one deallocate() can roll back
+    char* m_last = nullptr;
+    size_t m_nextChunkSize;
+    size_t m_bytesUsed = 0;
+    size_t m_bytesReserved = 0;
+    size_t m_chunkCount = 0;
+    HotPlugPPAllocator m_allocator;
+};
+
+} // namespace hotplugpp
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace hotplugpp {
+
+/**
+ * @brief Epoch-based reclamation: lock-free readers, writers wait out a grace period
+ *
+ * Readers bracket every access to shared objects with enter()/leave(), which
+ * costs two atomic increments on a counter of their own epoch parity. A
+ * writer that unpublished an object calls synchronize(), which flips the
+ * epoch and waits until every reader of the previous epoch has left; after
+ * that no reader can still hold the object and it may be destroyed.
+ *
+ * Counters are striped over cache lines by thread so concurrent readers do
+ * not contend on one line. A thread must not call synchronize() while it is
+ * inside a critical section of the same domain; it would wait for itself.
+ */
+class EpochDomain {
+  public:
+    /// Reader counter stripes per epoch parity
+    static constexpr size_t STRIPES = 8;
+
+    /**
+     * @brief Ticket of an entered critical section, to be passed to leave()
+     */
+    struct Ticket {
+        uint32_t parity = 0;
+        uint32_t stripe = 0;
+    };
+
+    EpochDomain() = default;
+
+    // Disable copy
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    /**
+     * @brief Enter a read-side critical section; never blocks
+     * @return Ticket for leave()
+     */
+    Ticket enter() {
+        Ticket ticket;
+        ticket.stripe = threadStripe();
+        for (;;) {
+            const uint64_t epoch = m_epoch.load();
+            ticket.parity = static_cast<uint32_t>(epoch & 1);
+            std::atomic<uint64_t>& readers = m_readers[ticket.parity][ticket.stripe].count;
+            readers.fetch_add(1);
+            // A writer flipped in between and may not have seen this reader; retry in the new epoch
+            if (m_epoch.load() == epoch) {
+                return ticket;
+            }
+            readers.fetch_sub(1);
+        }
+    }
+
+    /**
+     * @brief Leave a read-side critical section
+     * @param ticket Ticket returned by enter()
+     */
+    void leave(Ticket ticket) { m_readers[ticket.parity][ticket.stripe].count.fetch_sub(1); }
+
+    /**
+     * @brief Wait until every critical section entered before this call has been left
+     *
+     * Objects unpublished before the call may be destroyed afterwards.
+     * Readers entering meanwhile count towards the next epoch and are not
+     * waited for.
+     */
+    void synchronize() {
+        std::lock_guard<std::mutex> lock(m_synchronizing);
+        const uint64_t epoch = m_epoch.fetch_add(1);
+        const uint32_t parity = static_cast<uint32_t>(epoch & 1);
+        for (size_t stripe = 0; stripe < STRIPES; ++stripe) {
+            while (m_readers[parity][stripe].count.load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of grace periods completed or in progress
+     * @return Current epoch
+     */
+    uint64_t getEpoch() const { return m_epoch.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Counter {
+        std::atomic<uint64_t> count{0};
+    };
+
+    /// Stripe of the calling thread, assigned round-robin on first use
+    static uint32_t threadStripe() {
+        static std::atomic<uint32_t> s_nextStripe{0};
+        thread_local const uint32_t stripe =
+            s_nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return stripe;
+    }
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_epoch{0};
+    Counter m_readers[2][STRIPES];
+    std::mutex m_synchronizing;
+};
+
+/**
+ * @brief Scoped read-side critical section of an EpochDomain
+ */
+class EpochGuard {
+  public:
+    explicit EpochGuard(EpochDomain& domain) : m_domain(&domain), m_ticket(domain.enter()) {}
+
+    EpochGuard(EpochGuard&& other) noexcept
+        : m_domain(other.m_domain), m_ticket(other.m_ticket) {
+        other.m_domain = nullptr;
+    }
+
+    ~EpochGuard() {
+        if (m_domain) {
+            m_domain->leave(m_ticket);
+        }
+    }
+
+    // Disable copy and assignment
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+    EpochGuard& operator=(EpochGuard&&) = delete;
+
+  private:
+    EpochDomain* m_domain;
+    EpochDomain::Ticket m_ticket;
+};
+
+} // namespace hotplugpp
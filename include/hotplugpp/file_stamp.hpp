@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace hotplugpp {
+
+/**
+ * @brief Identity and version of a file as reported by the file system
+ *
+ * Two stamps compare equal only if modification time (at nanosecond
+ * resolution where the platform provides it), size, inode and device all
+ * match, so a rebuild within the same second or an atomic rename onto the
+ * path is never missed.
+ */
+struct FileStamp {
+    /// Modification time in nanoseconds since the epoch
+    int64_t modifiedNs = 0;
+    uint64_t size = 0;
+    /// Inode and device number, 0 where the platform has none
+    uint64_t inode = 0;
+    uint64_t device = 0;
+    bool exists = false;
+
+    bool operator==(const FileStamp& other) const {
+        return modifiedNs == other.modifiedNs && size == other.size && inode == other.inode &&
+               device == other.device && exists == other.exists;
+    }
+
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+
+    /**
+     * @brief Get the modification time as a time point
+     * @return Modification time
+     */
+    std::chrono::system_clock::time_point getModificationTime() const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(modifiedNs)));
+    }
+};
+
+/**
+ * @brief Read the stamp of a file
+ * @param path File path
+ * @return Stamp of the file; exists is false if it could not be read
+ */
+FileStamp getFileStamp(const std::string& path);
+
+/**
+ * @brief Hash the contents of a file with xxhash64()
+ * @param path File path
+ * @param hash Receives the hash of the contents
+ * @return true if the file could be read
+ */
+bool hashFileContents(const std::string& path, uint64_t& hash);
+
+} // namespace hotplugpp
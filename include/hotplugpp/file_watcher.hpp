@@ -0,0 +1,147 @@
+#pragma once
+
+#include "spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace hotplugpp {
+
+/**
+ * @brief Kind of change reported by the FileWatcher
+ */
+enum class FileEventType : uint8_t {
+    /// File contents or attributes changed and the writer closed it
+    Modified,
+    /// File appeared, e.g. through an atomic rename onto the watched path
+    Created,
+    /// File was deleted or renamed away
+    Removed,
+    /// Events were lost; every watched file must be treated as changed
+    Overflow,
+};
+
+/**
+ * @brief Change notification for one watched file
+ */
+struct FileEvent {
+    uint32_t fileId = 0;
+    FileEventType type = FileEventType::Modified;
+};
+
+/**
+ * @brief Watches plugin files on a background thread
+ *
+ * On Linux the watcher thread blocks on inotify for the directories that
+ * contain watched files and reacts to close-after-write, rename and delete
+ * events; other platforms fall back to polling modification times on the
+ * watcher thread. Events are handed to the consumer through a lock-free
+ * queue, so draining it when nothing changed costs a single atomic load and
+ * no system calls.
+ *
+ * pollEvent() must only be called from one thread at a time.
+ */
+class FileWatcher {
+  public:
+    static constexpr uint32_t INVALID_FILE_ID = 0;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    // Disable copy
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Start watching a file
+     *
+     * The file does not have to exist yet, but its directory does.
+     *
+     * @param path Path to the file
+     * @return ID reported in FileEvent::fileId, or INVALID_FILE_ID on failure
+     */
+    uint32_t watchFile(const std::string& path);
+
+    /**
+     * @brief Stop watching a file
+     * @param fileId ID returned by watchFile()
+     */
+    void unwatchFile(uint32_t fileId);
+
+    /**
+     * @brief Start the watcher thread
+     * @return true if the watcher is running
+     */
+    bool start();
+
+    /**
+     * @brief Stop and join the watcher thread
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the watcher thread is running
+     * @return true if running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Check whether native change notifications (inotify) are used
+     * @return true for native notifications, false for the polling fallback
+     */
+    bool isUsingNativeEvents() const;
+
+    /**
+     * @brief Set the polling interval of the fallback implementation
+     * @param interval Time between two scans of the watched files
+     */
+    void setPollInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Pop the next pending event without blocking
+     * @param event Receives the event
+     * @return false if no event is pending
+     */
+    bool pollEvent(FileEvent& event);
+
+  private:
+    struct WatchedFile {
+        std::string path;
+        std::string directory;
+        std::string fileName;
+        int64_t lastModified = 0;
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    SpscQueue<FileEvent, QUEUE_CAPACITY> m_events;
+    std::atomic<bool> m_overflowed{false};
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::thread m_thread;
+
+    // Registration state, shared with the watcher thread
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint32_t, WatchedFile> m_files;
+    uint32_t m_nextFileId = 1;
+    std::chrono::milliseconds m_pollInterval{100};
+
+    // inotify state (Linux only)
+    int m_inotifyFd = -1;
+    int m_wakeFd = -1;
+    std::unordered_map<std::string, int> m_directoryWatches;
+    std::unordered_map<int, std::string> m_watchDirectories;
+
+    void post(uint32_t fileId, FileEventType type);
+    void runNative();
+    void runPolling();
+    bool addDirectoryWatch(const std::string& directory);
+    void removeDirectoryWatchIfUnused(const std::string& directory);
+};
+
+} // namespace hotplugpp
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "latency_histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace hotplugpp {
+
+/**
+ * @brief Settings of a FramePacer
+ */
+struct FramePacerConfig {
+    /// Length of one fixed update step
+    std::chrono::nanoseconds timestep{std::chrono::nanoseconds(1000000000) / 60};
+    /// Most steps run in one frame; a longer backlog is dropped instead of caught up
+    uint32_t maxCatchUpSteps = 5;
+    /// Stop sleeping this long before a deadline and spin for the rest, to absorb timer slack
+    std::chrono::nanoseconds spinThreshold{std::chrono::milliseconds(2)};
+};
+
+/**
+ * @brief Block until a deadline, sleeping first and spinning for the last stretch
+ *
+ * OS sleeps overshoot by the scheduler's timer slack, often by a millisecond
+ * or more, so the final @p spinThreshold before the deadline is spent
+ * yielding on the monotonic clock instead.
+ *
+ * @param deadline Point on the steady clock to wait for
+ * @param spinThreshold How long before the deadline to stop sleeping
+ */
+void waitUntil(std::chrono::steady_clock::time_point deadline,
+               std::chrono::nanoseconds spinThreshold);
+
+/**
+ * @brief Paces a host loop to a fixed timestep
+ *
+ * Elapsed time is accumulated and paid out in whole fixed steps, so the
+ * simulation advances by exactly one timestep per step regardless of how
+ * long individual frames take. Frame deadlines stay on the timestep grid
+ * rather than being measured from the end of the previous frame, so they do
+ * not drift. After a slow frame the missed steps are caught up, at most
+ * maxCatchUpSteps per frame; anything beyond that is dropped so a long stall
+ * cannot send the loop into a spiral of ever longer frames.
+ *
+ * @code
+ * FramePacer pacer;
+ * while (running) {
+ *     for (uint32_t steps = pacer.beginFrame(); steps > 0; --steps) {
+ *         manager.updateAll(pacer.getTimestepSeconds());
+ *     }
+ * }
+ * @endcode
+ */
+class FramePacer {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Create a pacer; its clock starts with the first frame
+     * @param config Timestep, catch-up limit and spin threshold
+     */
+    explicit FramePacer(const FramePacerConfig& config = FramePacerConfig());
+
+    // Disable copy
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * @brief Wait for the next frame and get the number of steps to run
+     *
+     * The first call returns immediately with one step.
+     *
+     * @return Fixed steps due this frame, between 1 and maxCatchUpSteps
+     */
+    uint32_t beginFrame();
+
+    /**
+     * @brief Account the time up to a given point without waiting
+     *
+     * beginFrame() waits for getNextDeadline() and then calls this with the
+     * current time. Exposed for hosts that wait on something else (vsync, an
+     * event loop) and for tests.
+     *
+     * @param now Start of the frame, not earlier than the previous one
+     * @return Fixed steps due, at most maxCatchUpSteps
+     */
+    uint32_t advance(Clock::time_point now);
+
+    /**
+     * @brief Get the point at which the next step becomes due
+     * @return Deadline of the next frame, or the epoch before the first frame
+     */
+    Clock::time_point getNextDeadline() const { return m_nextDeadline; }
+
+    /**
+     * @brief Get the fixed timestep
+     * @return Timestep in seconds, for onUpdate()
+     */
+    float getTimestepSeconds() const {
+        return std::chrono::duration<float>(m_config.timestep).count();
+    }
+
+    /**
+     * @brief Get how far the accumulated time is into the next step
+     * @return Fraction between 0 and 1, for interpolating between the last two steps
+     */
+    float getInterpolationAlpha() const {
+        return static_cast<float>(m_accumulator.count()) /
+               static_cast<float>(m_config.timestep.count());
+    }
+
+    /**
+     * @brief Get the number of frames begun
+     * @return Frame count
+     */
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+    /**
+     * @brief Get the number of steps dropped because a frame exceeded maxCatchUpSteps
+     * @return Dropped step count
+     */
+    uint64_t getDroppedSteps() const { return m_droppedSteps; }
+
+    /**
+     * @brief Get the time between the starts of consecutive frames
+     * @return Frame time histogram
+     */
+    const LatencyHistogram& getFrameTimes() const { return m_frameTimes; }
+
+    /**
+     * @brief Get how late beginFrame() returned past its deadline
+     * @return Wake-up jitter histogram
+     */
+    const LatencyHistogram& getWakeLatency() const { return m_wakeLatency; }
+
+    /**
+     * @brief Restart the clock with the next frame and clear all statistics
+     */
+    void reset();
+
+  private:
+    FramePacerConfig m_config;
+    bool m_started = false;
+    Clock::time_point m_lastFrame;
+    Clock::time_point m_nextDeadline;
+    /// Time accounted for but not yet paid out as a step, always below one timestep
+    std::chrono::nanoseconds m_accumulator{0};
+    uint64_t m_frameCount = 0;
+    uint64_t m_droppedSteps = 0;
+    LatencyHistogram m_frameTimes;
+    LatencyHistogram m_wakeLatency;
+};
+
+} // namespace hotplugpp
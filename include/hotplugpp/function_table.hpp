@@ -0,0 +1,132 @@
+#pragma once
+
+#include "i_plugin.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/// Bumped whenever a field of HotPlugPPFunctionTable changes meaning; new fields are appended
+#define HOTPLUGPP_FUNCTION_TABLE_VERSION 1
+
+extern "C" {
+
+/**
+ * @brief Flat table of hot-path entry points exported by a plugin
+ *
+ * Only C types cross the boundary: instances are the opaque pointers returned
+ * by createPlugin(), passed as void*, so the calls do not depend on the
+ * vtable layout of the compiler that built the host. Hosts resolve the table
+ * once at load time through getPluginFunctionTable() and may cache the
+ * function pointers until the plugin is reloaded or unloaded.
+ */
+struct HotPlugPPFunctionTable {
+    /// HOTPLUGPP_FUNCTION_TABLE_VERSION the plugin was built against
+    uint32_t version;
+    /// sizeof the table as built by the plugin, so later versions can append fields
+    uint32_t size;
+    /// Update one instance; required
+    void (*update)(void* instance, float deltaTime);
+    /// Update count instances created by this library; may be null
+    void (*updateBatch)(void* const* instances, size_t count, float deltaTime);
+    /// Copy the value identified by key (usually fnv1a64 of a name) into buffer; returns the
+    /// number of bytes written, 0 if the key is unknown or the buffer is too small. May be null
+    size_t (*query)(void* instance, uint64_t key, void* buffer, size_t size);
+};
+
+typedef const HotPlugPPFunctionTable* (*GetFunctionTableFunc)();
+}
+
+namespace hotplugpp {
+namespace detail {
+
+template <typename T, typename = void>
+struct HasUpdateBatch : std::false_type {};
+
+template <typename T>
+struct HasUpdateBatch<T, std::void_t<decltype(T::onUpdateBatch(
+                             std::declval<IPlugin* const*>(), size_t(), 0.0f))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct HasQuery : std::false_type {};
+
+template <typename T>
+struct HasQuery<T, std::void_t<decltype(std::declval<T&>().onQuery(
+                       uint64_t(), std::declval<void*>(), size_t()))>> : std::true_type {};
+
+/**
+ * @brief Function table entry points of one plugin class
+ *
+ * The calls are qualified, so the plugin's own compiler binds them statically
+ * instead of going through the vtable.
+ */
+template <typename PluginClass>
+struct FunctionTableThunks {
+    static PluginClass* cast(void* instance) {
+        return static_cast<PluginClass*>(static_cast<IPlugin*>(instance));
+    }
+
+    static void update(void* instance, float deltaTime) {
+        cast(instance)->PluginClass::onUpdate(deltaTime);
+    }
+
+    static void updateBatch(void* const* instances, size_t count, float deltaTime) {
+        if constexpr (HasUpdateBatch<PluginClass>::value) {
+            // onUpdateBatch() takes IPlugin pointers; convert in chunks on the stack
+            constexpr size_t CHUNK = 256;
+            IPlugin* chunk[CHUNK];
+            for (size_t first = 0; first < count; first += CHUNK) {
+                size_t n = count - first < CHUNK ? count - first : CHUNK;
+                for (size_t i = 0; i < n; ++i) {
+                    chunk[i] = static_cast<IPlugin*>(instances[first + i]);
+                }
+                PluginClass::onUpdateBatch(chunk, n, deltaTime);
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                cast(instances[i])->PluginClass::onUpdate(deltaTime);
+            }
+        }
+    }
+
+    static size_t query(void* instance, uint64_t key, void* buffer, size_t size) {
+        if constexpr (HasQuery<PluginClass>::value) {
+            return cast(instance)->onQuery(key, buffer, size);
+        } else {
+            (void)instance;
+            (void)key;
+            (void)buffer;
+            (void)size;
+            return 0;
+        }
+    }
+
+    static const HotPlugPPFunctionTable* table() {
+        static const HotPlugPPFunctionTable s_table = {
+            HOTPLUGPP_FUNCTION_TABLE_VERSION,
+            static_cast<uint32_t>(sizeof(HotPlugPPFunctionTable)),
+            &update,
+            &updateBatch,
+            HasQuery<PluginClass>::value ? &query : nullptr,
+        };
+        return &s_table;
+    }
+};
+
+} // namespace detail
+} // namespace hotplugpp
+
+/**
+ * Export a function table for PluginClass, next to HOTPLUGPP_CREATE_PLUGIN
+ *
+ * update and updateBatch call PluginClass::onUpdate() non-virtually;
+ * updateBatch uses a static PluginClass::onUpdateBatch() if there is one (see
+ * HOTPLUGPP_UPDATE_BATCH). query is filled in if PluginClass has a member
+ *     size_t onQuery(uint64_t key, void* buffer, size_t size);
+ */
+#define HOTPLUGPP_FUNCTION_TABLE(PluginClass) \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API const HotPlugPPFunctionTable* getPluginFunctionTable() { \
+        return hotplugpp::detail::FunctionTableThunks<PluginClass>::table(); \
+    }
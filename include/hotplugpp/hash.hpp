@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hotplugpp {
+
+/**
+ * @brief 64-bit FNV-1a hash, usable in constant expressions
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @return Hash value
+ */
+constexpr uint64_t fnv1a64(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a string
+ * @param str String to hash
+ * @return Hash value
+ */
+constexpr uint64_t fnv1a64(std::string_view str) {
+    return fnv1a64(str.data(), str.size());
+}
+
+/**
+ * @brief 64-bit xxHash (XXH64) of a block of memory
+ *
+ * Processes 32-byte stripes in four independent lanes, so throughput is
+ * bound by memory bandwidth rather than multiply latency. Use it for large
+ * inputs such as whole library files; fnv1a64 is simpler for short keys.
+ *
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @param seed Hash seed
+ * @return Hash value, identical to the reference XXH64 implementation
+ */
+uint64_t xxhash64(const void* data, size_t size, uint64_t seed = 0);
+
+} // namespace hotplugpp
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
+/// Layout version of the IPlugin vtable, exported by HOTPLUGPP_CREATE_PLUGIN. Virtual functions
+/// are only ever appended, and the host calls none that a plugin's version lacks:
+/// 1 lifecycle and metadata, 2 state handoff, 3 getInitStatus(), 4 getUpdateBudget()
+#define HOTPLUGPP_INTERFACE_VERSION 4
+
 namespace hotplugpp {
 
 /**
@@ -13,7 +20,7 @@ struct Version {
     uint32_t minor;
     uint32_t patch;
 
-    Version(uint32_t maj = 1, uint32_t min = 0, uint32_t pat = 0)
+    constexpr Version(uint32_t maj = 1, uint32_t min = 0, uint32_t pat = 0)
         : major(maj), minor(min), patch(pat) {}
 
     bool isCompatible(const Version& other) const {
@@ -47,11 +54,25 @@ struct Version {
     bool operator>=(const Version& other) const { return !(*this < other); }
 };
 
+/**
+ * @brief Progress of a plugin's initialization, see IPlugin::getInitStatus()
+ */
+enum class InitStatus {
+    /// Setup is complete; the plugin may be updated
+    Ready,
+    /// onLoad() succeeded but setup continues in the background
+    Initializing,
+    /// Background setup failed; the plugin is unloaded
+    Failed,
+};
+
 /**
  * @brief Base interface for all plugins
  *
  * This interface defines the contract that all plugins must implement.
- * It provides lifecycle management and metadata access.
+ * It provides lifecycle management and metadata access. The hooks after
+ * getDescription() are optional and only called on plugins built against a
+ * header that declares them, see HOTPLUGPP_INTERFACE_VERSION.
  */
 class IPlugin {
   public:
@@ -91,6 +112,89 @@ class IPlugin {
      * @return Plugin description string
      */
     virtual const char* getDescription() const = 0;
+
+    /**
+     * @brief Get the layout version of the state handed over across reloads
+     *
+     * State handoff is optional. Plugins that keep expensive state (caches,
+     * counters, computed tables) override the four state hooks so a reloaded
+     * build continues where the previous one stopped instead of starting cold.
+     *
+     * @return Layout version of the saved state, 0 if the plugin keeps no state
+     */
+    virtual uint32_t getStateVersion() const { return 0; }
+
+    /**
+     * @brief Get the number of bytes saveState() needs
+     * @return State size in bytes
+     */
+    virtual size_t getStateSize() const { return 0; }
+
+    /**
+     * @brief Write the plugin state into a host-provided buffer
+     *
+     * Called on the old instance during a reload, before its onUnload().
+     *
+     * @param buffer Contiguous buffer aligned to alignof(std::max_align_t)
+     * @param size Size of the buffer, as returned by getStateSize()
+     * @return true if the state was written
+     */
+    virtual bool saveState(void* buffer, size_t size) {
+        (void)buffer;
+        (void)size;
+        return false;
+    }
+
+    /**
+     * @brief Take over the state saved by the previous version
+     *
+     * Called on the new instance after its onLoad() and before its first
+     * onUpdate(). The buffer stays valid and unchanged until the plugin is
+     * reloaded again or unloaded, so when @p version matches getStateVersion()
+     * the instance may use the data in place instead of copying it. Otherwise
+     * the plugin migrates from the older layout or returns false to start
+     * with fresh state.
+     *
+     * @param data State written by the previous instance's saveState()
+     * @param size Size of the state in bytes
+     * @param version Layout version reported by the previous instance
+     * @return true if the state was adopted
+     */
+    virtual bool loadState(const void* data, size_t size, uint32_t version) {
+        (void)data;
+        (void)size;
+        (void)version;
+        return false;
+    }
+
+    /**
+     * @brief Report whether setup started in onLoad() has finished
+     *
+     * Asynchronous initialization is optional. A plugin with slow setup
+     * (reading large data files, building caches) may start it on its own
+     * thread in onLoad(), return true, and report InitStatus::Initializing
+     * until it is done. The host polls this from its update thread and only
+     * calls onUpdate() once the plugin reports InitStatus::Ready; on
+     * InitStatus::Failed the plugin is unloaded through onUnload(), which
+     * may also run while setup is in progress and must stop it. A reload
+     * waits for the new build to become ready before it replaces the old one.
+     *
+     * @return Initialization progress, InitStatus::Ready by default
+     */
+    virtual InitStatus getInitStatus() { return InitStatus::Ready; }
+
+    /**
+     * @brief Declare how long one onUpdate() call is expected to take
+     *
+     * Optional. A host that times updates reports every call running longer
+     * than this to its budget callback, naming the plugin. Read once after
+     * onLoad(); the host may override it.
+     *
+     * @return Time budget per update, zero (the default) for none
+     */
+    virtual std::chrono::microseconds getUpdateBudget() const {
+        return std::chrono::microseconds::zero();
+    }
 };
 
 } // namespace hotplugpp
@@ -99,6 +203,9 @@ class IPlugin {
 extern "C" {
 typedef hotplugpp::IPlugin* (*CreatePluginFunc)();
 typedef void (*DestroyPluginFunc)(hotplugpp::IPlugin*);
+typedef void (*UpdateBatchFunc)(hotplugpp::IPlugin* const* instances, size_t count,
+                                float deltaTime);
+typedef uint32_t (*GetInterfaceVersionFunc)();
 }
 
 // Macro to simplify plugin implementation
@@ -117,4 +224,25 @@ typedef void (*DestroyPluginFunc)(hotplugpp::IPlugin*);
     } \
     HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void destroyPlugin(hotplugpp::IPlugin* plugin) { \
         delete plugin; \
+    } \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API uint32_t hotplugppInterfaceVersion() { \
+        return HOTPLUGPP_INTERFACE_VERSION; \
+    }
+
+/**
+ * Optional batch update entry point, exported next to the factory functions
+ *
+ * PluginClass must declare
+ *     static void onUpdateBatch(hotplugpp::IPlugin* const* instances, size_t count,
+ *                               float deltaTime);
+ * PluginManager::updateAll() then calls it once per tick with every instance
+ * created by this library instead of calling onUpdate() on each of them. All
+ * instances were created by createPlugin() of the same library, so they can be
+ * static_cast to PluginClass. onUpdate() must still update a single instance:
+ * it is used by PluginLoader and by parallel updates.
+ */
+#define HOTPLUGPP_UPDATE_BATCH(PluginClass) \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void updatePluginBatch( \
+        hotplugpp::IPlugin* const* instances, size_t count, float deltaTime) { \
+        PluginClass::onUpdateBatch(instances, count, deltaTime); \
     }
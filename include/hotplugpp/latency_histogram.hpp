@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace hotplugpp {
+
+/**
+ * @brief Summary of a LatencyHistogram
+ */
+struct LatencyStats {
+    uint64_t count = 0;
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
+};
+
+/**
+ * @brief Fixed-size log-linear histogram of durations
+ *
+ * Every power of two is split into 8 linear sub-buckets, so percentiles are
+ * accurate to within 12.5% from 1 ns up to several minutes, while the exact
+ * maximum is tracked separately. Recording is lock-free, never allocates
+ * and may happen from several threads at once.
+ */
+class LatencyHistogram {
+  public:
+    LatencyHistogram() = default;
+
+    // Disable copy
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one duration
+     * @param duration Duration to record, negative values count as 0
+     */
+    void record(std::chrono::nanoseconds duration) {
+        const uint64_t ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+        m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Get the number of recorded durations
+     * @return Sample count
+     */
+    uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the longest recorded duration
+     * @return Exact maximum, 0 if nothing was recorded
+     */
+    std::chrono::nanoseconds getMax() const {
+        return std::chrono::nanoseconds(m_max.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Get the duration below which a given fraction of samples fall
+     * @param fraction Fraction between 0 and 1, e.g. 0.99 for p99
+     * @return Upper bound of the matching bucket, capped at the maximum
+     */
+    std::chrono::nanoseconds getPercentile(double fraction) const;
+
+    /**
+     * @brief Get count, p50, p99 and max in one call
+     * @return Histogram summary
+     */
+    LatencyStats getStats() const;
+
+    /**
+     * @brief Forget all recorded durations
+     */
+    void reset();
+
+  private:
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t LINEAR_LIMIT = 2 * SUB_BUCKETS;
+    static constexpr size_t BUCKET_COUNT = LINEAR_LIMIT + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    static size_t bucketIndex(uint64_t ns);
+    static uint64_t bucketUpperBound(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+inline size_t LatencyHistogram::bucketIndex(uint64_t ns) {
+    if (ns < LINEAR_LIMIT) {
+        return static_cast<size_t>(ns);
+    }
+
+    // Position of the highest set bit, at least SUB_BUCKET_BITS + 1 here
+    uint32_t exponent = 63;
+    while (!(ns >> exponent)) {
+        --exponent;
+    }
+    const uint64_t subBucket = (ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return LINEAR_LIMIT + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKETS +
+           static_cast<size_t>(subBucket);
+}
+
+} // namespace hotplugpp
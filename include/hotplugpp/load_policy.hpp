@@ -0,0 +1,30 @@
+#pragma once
+
+namespace hotplugpp {
+
+/**
+ * @brief How much work loading a plugin does up front
+ */
+enum class LoadPolicy {
+    /// Resolve all symbols when the library is opened and call onLoad() right away
+    Eager,
+    /// Open the library with lazy symbol binding and create the instance, but call
+    /// onLoad() only when the plugin is first used or an idle window initializes it
+    Deferred,
+};
+
+/**
+ * @brief Where a plugin is on its way from being requested to being updated
+ */
+enum class PluginLoadState {
+    /// Not loaded: never requested, unloaded, or the load failed
+    Unloaded,
+    /// The library is being opened and onLoad() runs on a background thread
+    Loading,
+    /// Loaded, but onLoad() is deferred or the plugin still reports InitStatus::Initializing
+    Initializing,
+    /// Loaded, initialized and updated by the host
+    Ready,
+};
+
+} // namespace hotplugpp
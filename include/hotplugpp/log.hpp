@@ -0,0 +1,179 @@
+#pragma once
+
+#include "mpmc_queue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HOTPLUGPP_PRINTF_FORMAT(formatIndex, firstArg)                                             \
+    __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#define HOTPLUGPP_PRINTF_FORMAT(formatIndex, firstArg)
+#endif
+
+namespace hotplugpp {
+
+/**
+ * @brief Severity of a diagnostic message
+ */
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    /// Disables all messages when used as the minimum level
+    Off,
+};
+
+/**
+ * @brief Get a printable name for a log level
+ * @param level Log level
+ * @return Static string such as "Warning"
+ */
+const char* toString(LogLevel level);
+
+/**
+ * @brief Destination for loader and manager diagnostics
+ *
+ * Implement this to route HotPlugPP messages into the host's own logging
+ * system. write() may be called from several threads at once, including
+ * reload and batch-load worker threads.
+ */
+class ILogSink {
+  public:
+    virtual ~ILogSink() = default;
+
+    /**
+     * @brief Handle one formatted message
+     * @param level Message severity
+     * @param message Message text without trailing newline, not null-terminated
+     * @param length Length of the message in bytes
+     */
+    virtual void write(LogLevel level, const char* message, size_t length) = 0;
+
+    /**
+     * @brief Block until all messages written so far have been delivered
+     */
+    virtual void flush() {}
+};
+
+/**
+ * @brief Log sink that hands messages to a background thread
+ *
+ * write() copies the message into a fixed-size slot of a lock-free ring
+ * buffer and returns without locking, allocating or doing I/O; a background
+ * thread prints them, Info and below to stdout and Warning and above to
+ * stderr. Messages longer than MAX_MESSAGE_LENGTH are truncated, and
+ * messages that find the ring full are dropped and counted.
+ */
+class AsyncLogSink : public ILogSink {
+  public:
+    static constexpr size_t MAX_MESSAGE_LENGTH = 246;
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    AsyncLogSink();
+    ~AsyncLogSink() override;
+
+    // Disable copy
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    void write(LogLevel level, const char* message, size_t length) override;
+    void flush() override;
+
+    /**
+     * @brief Deliver pending messages and stop the background thread
+     *
+     * Messages written afterwards are printed synchronously.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of messages dropped because the ring was full
+     * @return Dropped message count
+     */
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of messages printed, asynchronously or after stop()
+     * @return Delivered message count
+     */
+    uint64_t getDeliveredCount() const { return m_delivered.load(std::memory_order_acquire); }
+
+  private:
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        uint8_t length = 0;
+        char text[MAX_MESSAGE_LENGTH];
+    };
+
+    MpmcQueue<Record, QUEUE_CAPACITY> m_queue;
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_delivered{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<bool> m_running{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    std::thread m_thread;
+
+    void run();
+
+    /**
+     * @brief Print what is queued on the calling thread; used once the thread has stopped
+     */
+    void drain();
+
+    static void print(LogLevel level, const char* message, size_t length);
+};
+
+/**
+ * @brief Route diagnostics to a custom sink
+ *
+ * The sink is not owned and must outlive all logging; set it before loading
+ * plugins.
+ *
+ * @param sink Sink, or nullptr to restore the default AsyncLogSink
+ */
+void setLogSink(ILogSink* sink);
+
+/**
+ * @brief Get the sink diagnostics are currently written to
+ * @return Active sink, never null
+ */
+ILogSink* getLogSink();
+
+/**
+ * @brief Set the minimum severity that is formatted and forwarded to the sink
+ * @param level Minimum level, LogLevel::Info by default
+ */
+void setLogLevel(LogLevel level);
+
+/**
+ * @brief Get the minimum severity that reaches the sink
+ * @return Minimum level
+ */
+LogLevel getLogLevel();
+
+/**
+ * @brief Format a message on the stack and pass it to the active sink
+ *
+ * Messages below the current log level cost a single atomic load.
+ *
+ * @param level Message severity
+ * @param format printf-style format string
+ */
+void logMessage(LogLevel level, const char* format, ...) HOTPLUGPP_PRINTF_FORMAT(2, 3);
+
+/**
+ * @brief Block until the active sink delivered all messages written so far
+ */
+void flushLog();
+
+} // namespace hotplugpp
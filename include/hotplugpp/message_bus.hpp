@@ -0,0 +1,352 @@
+#pragma once
+
+#include "hash.hpp"
+#include "i_plugin.hpp"
+#include "mpmc_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace hotplugpp {
+
+/**
+ * @brief Typed publish/subscribe channel with a fixed pool of message slots
+ *
+ * Messages are built and read in place: a publisher acquire()s a free slot,
+ * fills it and publish()es it, and every subscriber receives a pointer to
+ * the same slot, which returns to the pool once the last subscriber released
+ * it. Slot indices travel through MpmcQueues, so any number of threads may
+ * publish and receive at once without locks or allocation.
+ *
+ * Subscribers are identified by name. Subscribing again under the same name
+ * returns the existing subscription with its pending messages, which is how a
+ * reloaded plugin picks up where its previous build stopped. Only subscribe()
+ * and unsubscribe() take a (spin) lock.
+ *
+ * @tparam T Message type, must be trivially copyable so no plugin code is
+ *         needed to destroy it
+ * @tparam Capacity Number of message slots, must be a power of two
+ */
+template <typename T, size_t Capacity = 256>
+class MessageChannel {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "MessageChannel messages must be trivially copyable");
+
+  public:
+    /// Subscribers a channel can hold at once
+    static constexpr uint32_t MAX_SUBSCRIBERS = 16;
+    static constexpr uint32_t INVALID_SUBSCRIBER = ~0u;
+
+    MessageChannel() {
+        for (uint32_t i = 0; i < Capacity; ++i) {
+            m_free.tryPush(i);
+        }
+    }
+
+    // Disable copy
+    MessageChannel(const MessageChannel&) = delete;
+    MessageChannel& operator=(const MessageChannel&) = delete;
+
+    /**
+     * @brief Reserve a slot to build a message in
+     * @return Slot to fill and pass to publish(), or nullptr if every slot is in flight
+     */
+    T* acquire() {
+        uint32_t index;
+        if (!m_free.tryPop(index)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &m_values[index];
+    }
+
+    /**
+     * @brief Hand a filled slot to every current subscriber
+     *
+     * The slot must not be touched afterwards. Without subscribers it goes
+     * straight back to the pool.
+     *
+     * @param message Slot returned by acquire()
+     */
+    void publish(T* message) {
+        const uint32_t index = indexOf(message);
+        // The publisher holds one reference until every subscriber got its own
+        m_references[index].store(1, std::memory_order_relaxed);
+        for (Subscriber& subscriber : m_subscribers) {
+            if (subscriber.hash.load(std::memory_order_acquire) == 0) {
+                continue;
+            }
+            m_references[index].fetch_add(1, std::memory_order_relaxed);
+            // Never full: the queue has a place for every slot of the pool
+            subscriber.pending.tryPush(index);
+        }
+        m_published.fetch_add(1, std::memory_order_relaxed);
+        release(message);
+    }
+
+    /**
+     * @brief Copy a message into a slot and publish it
+     * @param value Message
+     * @return false if every slot is in flight
+     */
+    bool publish(const T& value) {
+        T* message = acquire();
+        if (!message) {
+            return false;
+        }
+        *message = value;
+        publish(message);
+        return true;
+    }
+
+    /**
+     * @brief Subscribe under a name, or rebind to the subscription of that name
+     * @param name Subscriber name, unique per channel
+     * @return Subscriber ID, or INVALID_SUBSCRIBER if the channel is full
+     */
+    uint32_t subscribe(std::string_view name) {
+        const uint64_t hash = subscriberHash(name);
+        SpinLock lock(m_subscribing);
+        uint32_t vacant = INVALID_SUBSCRIBER;
+        for (uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i) {
+            const uint64_t current = m_subscribers[i].hash.load(std::memory_order_relaxed);
+            if (current == hash) {
+                return i;
+            }
+            if (current == 0 && vacant == INVALID_SUBSCRIBER) {
+                vacant = i;
+            }
+        }
+        if (vacant != INVALID_SUBSCRIBER) {
+            // A publish racing the previous unsubscribe may have left a message behind
+            drainPending(m_subscribers[vacant]);
+            m_subscribers[vacant].hash.store(hash, std::memory_order_release);
+        }
+        return vacant;
+    }
+
+    /**
+     * @brief End a subscription and release its pending messages
+     * @param subscriber ID returned by subscribe()
+     */
+    void unsubscribe(uint32_t subscriber) {
+        if (subscriber >= MAX_SUBSCRIBERS) {
+            return;
+        }
+        SpinLock lock(m_subscribing);
+        m_subscribers[subscriber].hash.store(0, std::memory_order_release);
+        drainPending(m_subscribers[subscriber]);
+    }
+
+    /**
+     * @brief Take the oldest pending message of a subscriber
+     *
+     * The message stays valid until it is passed to release(). One thread at a
+     * time should receive for a given subscriber to keep messages in order.
+     *
+     * @param subscriber ID returned by subscribe()
+     * @return Message, or nullptr if none is pending
+     */
+    const T* receive(uint32_t subscriber) {
+        uint32_t index;
+        if (!m_subscribers[subscriber].pending.tryPop(index)) {
+            return nullptr;
+        }
+        return &m_values[index];
+    }
+
+    /**
+     * @brief Give a received message back; the last reference returns its slot to the pool
+     * @param message Message returned by receive()
+     */
+    void release(const T* message) {
+        const uint32_t index = indexOf(message);
+        if (m_references[index].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_free.tryPush(index);
+        }
+    }
+
+    /**
+     * @brief Receive and release every pending message of a subscriber
+     * @param subscriber ID returned by subscribe()
+     * @param handler Called with each message
+     * @return Number of messages handled
+     */
+    template <typename Handler>
+    size_t drain(uint32_t subscriber, Handler&& handler) {
+        size_t count = 0;
+        while (const T* message = receive(subscriber)) {
+            handler(*message);
+            release(message);
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Get the number of messages published so far
+     * @return Published message count
+     */
+    uint64_t getPublishedCount() const { return m_published.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of acquire() calls that found no free slot
+     * @return Dropped message count
+     */
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of message slots
+     * @return Channel capacity
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Subscriber {
+        /// fnv1a64 of the name, 0 while the entry is vacant
+        std::atomic<uint64_t> hash{0};
+        MpmcQueue<uint32_t, Capacity> pending;
+    };
+
+    class SpinLock {
+      public:
+        explicit SpinLock(std::atomic<bool>& flag) : m_flag(flag) {
+            while (m_flag.exchange(true, std::memory_order_acquire)) {
+            }
+        }
+        ~SpinLock() { m_flag.store(false, std::memory_order_release); }
+
+      private:
+        std::atomic<bool>& m_flag;
+    };
+
+    static uint64_t subscriberHash(std::string_view name) {
+        const uint64_t hash = fnv1a64(name);
+        // 0 marks a vacant entry
+        return hash != 0 ? hash : 1;
+    }
+
+    uint32_t indexOf(const T* message) const { return static_cast<uint32_t>(message - m_values); }
+
+    void drainPending(Subscriber& subscriber) {
+        uint32_t index;
+        while (subscriber.pending.tryPop(index)) {
+            release(&m_values[index]);
+        }
+    }
+
+    MpmcQueue<uint32_t, Capacity> m_free;
+    Subscriber m_subscribers[MAX_SUBSCRIBERS];
+    std::atomic<bool> m_subscribing{false};
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_published{0};
+    std::atomic<uint64_t> m_dropped{0};
+    alignas(CACHE_LINE) std::atomic<uint32_t> m_references[Capacity] = {};
+    alignas(CACHE_LINE) T m_values[Capacity];
+};
+
+/**
+ * @brief Host-owned set of named MessageChannels shared by plugins
+ *
+ * Channels are created on first use and live as long as the bus, so
+ * pointers returned by getChannel() may be cached and stay valid across
+ * plugin reloads. Messages are trivially copyable and channels trivially
+ * destructible, so destroying the bus runs no code of any plugin, which may
+ * have been unloaded by then.
+ *
+ * Attach the bus with PluginLoader::setMessageBus() or
+ * PluginManager::setMessageBus(); plugins declared with
+ * HOTPLUGPP_USE_MESSAGE_BUS() receive it before every onLoad().
+ */
+class MessageBus {
+  public:
+    MessageBus() = default;
+
+    ~MessageBus() {
+        for (auto& entry : m_channels) {
+            ::operator delete(entry.second.storage, std::align_val_t(entry.second.alignment));
+        }
+    }
+
+    // Disable copy
+    MessageBus(const MessageBus&) = delete;
+    MessageBus& operator=(const MessageBus&) = delete;
+
+    /**
+     * @brief Get a channel by name, creating it on first use
+     *
+     * Takes a lock; look channels up in onLoad() and keep the pointer.
+     *
+     * @tparam T Message type
+     * @tparam Capacity Number of message slots
+     * @param name Channel name
+     * @return Channel, or nullptr if the name is in use with another type or capacity
+     */
+    template <typename T, size_t Capacity = 256>
+    MessageChannel<T, Capacity>* getChannel(const std::string& name) {
+        using Channel = MessageChannel<T, Capacity>;
+        static_assert(std::is_trivially_destructible<Channel>::value,
+                      "Channels are released without running their destructor");
+
+        // Type names compare equal across libraries even where type_info objects do not
+        const char* type = typeid(Channel).name();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_channels.find(name);
+        if (it != m_channels.end()) {
+            return it->second.type == type ? static_cast<Channel*>(it->second.storage) : nullptr;
+        }
+
+        void* storage = ::operator new(sizeof(Channel), std::align_val_t(alignof(Channel)));
+        Channel* channel = new (storage) Channel();
+        m_channels.emplace(name, Entry{type, storage, alignof(Channel)});
+        return channel;
+    }
+
+    /**
+     * @brief Get the number of channels created so far
+     * @return Channel count
+     */
+    size_t getChannelCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_channels.size();
+    }
+
+  private:
+    struct Entry {
+        std::string type;
+        void* storage;
+        size_t alignment;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_channels;
+};
+
+} // namespace hotplugpp
+
+extern "C" {
+typedef void (*AttachMessageBusFunc)(hotplugpp::MessageBus* bus);
+}
+
+/**
+ * Receive the host's MessageBus in a plugin library
+ *
+ * Use once per library, next to HOTPLUGPP_CREATE_PLUGIN. Defines
+ * `hotplugppMessageBus`, which the host sets before every onLoad() of an
+ * instance of this library, and leaves null if it has no bus.
+ */
+#define HOTPLUGPP_USE_MESSAGE_BUS() \
+    static hotplugpp::MessageBus* hotplugppMessageBus = nullptr; \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void hotplugppAttachMessageBus( \
+        hotplugpp::MessageBus* bus) { \
+        hotplugppMessageBus = bus; \
+    }
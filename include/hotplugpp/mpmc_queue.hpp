@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace hotplugpp {
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer ring buffer
+ *
+ * Any number of threads may push and pop concurrently without locks or
+ * allocation. Each slot carries a sequence number that tells producers and
+ * consumers whose turn it is, so a push or pop costs one compare-and-swap
+ * on the shared index in the uncontended case.
+ *
+ * @tparam T Element type, must be default constructible and copy/move assignable
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class MpmcQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpmcQueue capacity must be a power of two");
+
+  public:
+    MpmcQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Disable copy
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Push an element
+     * @param value Element to push
+     * @return false if the queue is full
+     */
+    bool tryPush(const T& value) {
+        Slot* slot = claim(m_tail, 0);
+        if (!slot) {
+            return false;
+        }
+        slot->value = value;
+        slot->sequence.store(slot->claimed + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element
+     * @param value Receives the element
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& value) {
+        Slot* slot = claim(m_head, 1);
+        if (!slot) {
+            return false;
+        }
+        value = std::move(slot->value);
+        slot->sequence.store(slot->claimed + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Check whether the queue looked empty at the time of the call
+     * @return true if there was nothing to pop
+     */
+    bool isEmpty() const {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return m_slots[head & MASK].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    /**
+     * @brief Get the number of slots
+     * @return Queue capacity
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+  private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        /// Position the slot was claimed for, only touched by the claiming thread
+        size_t claimed = 0;
+        T value;
+    };
+
+    /**
+     * @brief Reserve the slot at an index for the calling thread
+     * @param index m_tail to push or m_head to pop
+     * @param ready Sequence offset marking the slot as ready for this side
+     * @return Claimed slot, or nullptr if the queue is full/empty
+     */
+    Slot* claim(std::atomic<size_t>& index, size_t ready) {
+        size_t position = index.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[position & MASK];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + ready);
+            if (diff == 0) {
+                if (index.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    slot.claimed = position;
+                    return &slot;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                position = index.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+
+    // Producer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+
+    alignas(CACHE_LINE) Slot m_slots[Capacity];
+};
+
+} // namespace hotplugpp
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "latency_histogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace hotplugpp {
+
+/**
+ * @brief Stage of loading, unloading or reloading a plugin
+ */
+enum class LoadPhase : uint8_t {
+    /// Copying the library for a reload (shadow copy)
+    CopyLibrary,
+    /// dlopen()/LoadLibrary(), including relocation and static constructors
+    LoadLibrary,
+    /// Looking up createPlugin/destroyPlugin
+    ResolveSymbols,
+    /// createPlugin()
+    CreateInstance,
+    /// IPlugin::onLoad()
+    OnLoad,
+    /// Handing state from the old instance to the new one
+    TransferState,
+    /// IPlugin::onUnload()
+    OnUnload,
+    /// destroyPlugin()
+    DestroyInstance,
+    /// dlclose()/FreeLibrary(), including static destructors
+    UnloadLibrary,
+    /// Time checkAndReload() spent on the calling thread for a reload
+    Reload,
+    Count,
+};
+
+/// Number of LoadPhase values
+constexpr size_t LOAD_PHASE_COUNT = static_cast<size_t>(LoadPhase::Count);
+
+/**
+ * @brief Get a printable name for a phase
+ * @param phase Phase
+ * @return Static string such as "LoadLibrary"
+ */
+const char* toString(LoadPhase phase);
+
+/**
+ * @brief Called after every timed phase
+ *
+ * May be invoked from a worker thread while a staged reload is loading.
+ */
+using PhaseCallback = std::function<void(LoadPhase phase, std::chrono::nanoseconds duration)>;
+
+/**
+ * @brief Latency histograms for every LoadPhase
+ *
+ * Recording only touches preallocated atomic counters, so it is safe from
+ * several threads and never allocates.
+ */
+class PhaseTimings {
+  public:
+    PhaseTimings() = default;
+
+    // Disable copy
+    PhaseTimings(const PhaseTimings&) = delete;
+    PhaseTimings& operator=(const PhaseTimings&) = delete;
+
+    /**
+     * @brief Record the duration of a phase and notify the callback
+     * @param phase Phase that finished
+     * @param duration Time it took
+     */
+    void record(LoadPhase phase, std::chrono::nanoseconds duration) {
+        m_histograms[static_cast<size_t>(phase)].record(duration);
+        if (m_callback) {
+            m_callback(phase, duration);
+        }
+    }
+
+    /**
+     * @brief Get the histogram of a phase
+     * @param phase Phase
+     * @return Histogram of all recorded durations of the phase
+     */
+    const LatencyHistogram& getHistogram(LoadPhase phase) const {
+        return m_histograms[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * @brief Get count, p50, p99 and max of a phase
+     * @param phase Phase
+     * @return Phase summary
+     */
+    LatencyStats getStats(LoadPhase phase) const { return getHistogram(phase).getStats(); }
+
+    /**
+     * @brief Set the callback invoked after every recorded phase
+     *
+     * Must not be changed while phases are being recorded on another thread.
+     *
+     * @param callback Callback, or nullptr to disable
+     */
+    void setCallback(PhaseCallback callback) { m_callback = std::move(callback); }
+
+    /**
+     * @brief Forget all recorded durations
+     */
+    void reset() {
+        for (auto& histogram : m_histograms) {
+            histogram.reset();
+        }
+    }
+
+  private:
+    std::array<LatencyHistogram, LOAD_PHASE_COUNT> m_histograms;
+    PhaseCallback m_callback;
+};
+
+/**
+ * @brief Records the lifetime of a scope as one phase
+ *
+ * Does nothing when constructed with a null PhaseTimings.
+ */
+class ScopedPhaseTimer {
+  public:
+    ScopedPhaseTimer(PhaseTimings* timings, LoadPhase phase) : m_timings(timings), m_phase(phase) {
+        if (m_timings) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedPhaseTimer() {
+        if (m_timings) {
+            m_timings->record(m_phase, std::chrono::steady_clock::now() - m_start);
+        }
+    }
+
+    // Disable copy
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+  private:
+    PhaseTimings* m_timings;
+    LoadPhase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace hotplugpp
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "i_plugin.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+extern "C" {
+
+/**
+ * @brief Memory interface the host hands to a plugin
+ *
+ * Plain C so it does not depend on the standard library the host was built
+ * with. Everything allocated through it belongs to the plugin instance and is
+ * released by the host in one step after the instance is destroyed, so
+ * deallocate may be a no-op.
+ */
+struct HotPlugPPAllocator {
+    void* context;
+    /// Return size bytes aligned to alignment (a power of two), or null when out of memory
+    void* (*allocate)(void* context, size_t size, size_t alignment);
+    /// Give back an allocation early; the host may ignore this
+    void (*deallocate)(void* context, void* ptr, size_t size);
+};
+
+typedef hotplugpp::IPlugin* (*CreatePluginWithAllocatorFunc)(const HotPlugPPAllocator* allocator);
+}
+
+namespace hotplugpp {
+
+/**
+ * @brief Standard allocator over a HotPlugPPAllocator, for plugin containers
+ *
+ * A default-constructed PluginAllocator uses the global heap, so the same
+ * plugin code works whether or not the host provided an allocator.
+ */
+template <typename T>
+class PluginAllocator {
+  public:
+    using value_type = T;
+
+    PluginAllocator() noexcept = default;
+
+    explicit PluginAllocator(const HotPlugPPAllocator* allocator) noexcept
+        : m_allocator(allocator) {}
+
+    template <typename U>
+    PluginAllocator(const PluginAllocator<U>& other) noexcept : m_allocator(other.get()) {}
+
+    T* allocate(size_t count) {
+        if (!m_allocator) {
+            return std::allocator<T>().allocate(count);
+        }
+        void* memory = m_allocator->allocate(m_allocator->context, count * sizeof(T), alignof(T));
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (!m_allocator) {
+            std::allocator<T>().deallocate(ptr, count);
+            return;
+        }
+        m_allocator->deallocate(m_allocator->context, ptr, count * sizeof(T));
+    }
+
+    const HotPlugPPAllocator* get() const noexcept { return m_allocator; }
+
+    template <typename U>
+    bool operator==(const PluginAllocator<U>& other) const noexcept {
+        return m_allocator == other.get();
+    }
+
+    template <typename U>
+    bool operator!=(const PluginAllocator<U>& other) const noexcept {
+        return m_allocator != other.get();
+    }
+
+  private:
+    const HotPlugPPAllocator* m_allocator = nullptr;
+};
+
+namespace detail {
+
+/**
+ * @brief Construct a plugin in host-provided memory
+ *
+ * Passes the allocator to the constructor if the plugin class accepts one.
+ */
+template <typename PluginClass>
+IPlugin* createPluginWithAllocator(const HotPlugPPAllocator* allocator) {
+    void* memory = allocator->allocate(allocator->context, sizeof(PluginClass),
+                                       alignof(PluginClass));
+    if (!memory) {
+        return nullptr;
+    }
+    if constexpr (std::is_constructible<PluginClass, const HotPlugPPAllocator*>::value) {
+        return new (memory) PluginClass(allocator);
+    } else {
+        return new (memory) PluginClass();
+    }
+}
+
+} // namespace detail
+} // namespace hotplugpp
+
+/**
+ * Factory functions for a plugin that lives in a host-provided arena
+ *
+ * Exports the regular createPlugin/destroyPlugin pair for hosts without
+ * arenas, plus createPluginWithAllocator(), which constructs the instance in
+ * allocator memory, and destroyPluginWithAllocator(), which runs the
+ * destructor and leaves the memory to the host. A constructor taking
+ * `const HotPlugPPAllocator*` receives the allocator, e.g. to build
+ * PluginAllocator-backed containers.
+ */
+#define HOTPLUGPP_CREATE_PLUGIN_WITH_ALLOCATOR(PluginClass) \
+    HOTPLUGPP_CREATE_PLUGIN(PluginClass) \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API hotplugpp::IPlugin* createPluginWithAllocator( \
+        const HotPlugPPAllocator* allocator) { \
+        return hotplugpp::detail::createPluginWithAllocator<PluginClass>(allocator); \
+    } \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void destroyPluginWithAllocator( \
+        hotplugpp::IPlugin* plugin) { \
+        plugin->~IPlugin(); \
+    }
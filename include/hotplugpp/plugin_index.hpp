@@ -0,0 +1,131 @@
+#pragma once
+
+#include "file_stamp.hpp"
+#include "plugin_metadata.hpp"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hotplugpp {
+
+/**
+ * @brief One library file found by PluginIndex::scan()
+ */
+struct PluginIndexEntry {
+    std::string path;
+    /// Stamp of the file when its metadata was read
+    FileStamp stamp;
+    /// false for libraries without a HOTPLUGPP_PLUGIN_METADATA record
+    bool isPlugin = false;
+    /// Valid only if isPlugin is true
+    PluginMetadata metadata;
+};
+
+/**
+ * @brief Options for PluginIndex::scan()
+ */
+struct PluginScanOptions {
+    /// Worker threads used for probing files, 0 to use the hardware concurrency
+    size_t threadCount = 0;
+};
+
+/**
+ * @brief What a PluginIndex::scan() had to do
+ */
+struct PluginScanStats {
+    /// Library files found in the scanned directories
+    size_t files = 0;
+    /// Files whose metadata had to be read because they are new or changed
+    size_t probed = 0;
+    /// Files whose entry was kept because their stamp is unchanged
+    size_t reused = 0;
+    /// Entries dropped because their file is gone
+    size_t removed = 0;
+};
+
+/**
+ * @brief Catalog of the plugins in a set of directories
+ *
+ * scan() lists the shared libraries in each directory and reads their
+ * metadata with readPluginMetadata() on a pool of worker threads, without
+ * loading any of them. The index can be saved to a file; after load() the
+ * next scan() only probes files whose path, inode, device, modification
+ * time or size differ from the saved entry, so a warm restart over
+ * thousands of unchanged libraries costs one stat() each. Plugins are
+ * looked up by name through a hash index.
+ */
+class PluginIndex {
+  public:
+    /**
+     * @brief Bring the index up to date with the libraries in some directories
+     *
+     * Afterwards the index holds exactly the libraries found there; entries of
+     * files that disappeared or live elsewhere are dropped.
+     *
+     * @param directories Directories to list, not recursed into
+     * @param options Threading options
+     * @return Counts of probed, reused and removed entries
+     */
+    PluginScanStats scan(const std::vector<std::string>& directories,
+                         const PluginScanOptions& options = PluginScanOptions());
+
+    /**
+     * @brief Find a plugin by the name in its metadata
+     *
+     * If several files carry the same name, the one with the highest version
+     * wins, and among equal versions the first path in sort order.
+     *
+     * @param name Plugin name
+     * @return Entry of the plugin, or nullptr if none has that name; valid until
+     *         the next scan(), load() or clear()
+     */
+    const PluginIndexEntry* find(const std::string& name) const;
+
+    /**
+     * @brief Get every file in the index, sorted by path
+     * @return Entries, including libraries that are no plugins
+     */
+    const std::vector<PluginIndexEntry>& getEntries() const { return m_entries; }
+
+    /**
+     * @brief Get the number of plugins in the index
+     * @return Number of entries with metadata
+     */
+    size_t getPluginCount() const;
+
+    /**
+     * @brief Replace the index with one saved by save()
+     *
+     * Entries are not checked against the file system until the next scan().
+     *
+     * @param indexPath Path of the index file
+     * @return true if the file was read; on failure the index is left empty
+     */
+    bool load(const std::string& indexPath);
+
+    /**
+     * @brief Write the index to a file
+     *
+     * The file is written next to its destination and renamed over it, so a
+     * crash never leaves a torn index behind.
+     *
+     * @param indexPath Path of the index file
+     * @return true if the file was written
+     */
+    bool save(const std::string& indexPath) const;
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+  private:
+    std::vector<PluginIndexEntry> m_entries;
+    std::unordered_map<std::string, size_t> m_byName;
+
+    void rebuildNameIndex();
+};
+
+} // namespace hotplugpp
@@ -1,21 +1,25 @@
 #pragma once
 
+#include "arena.hpp"
+#include "epoch.hpp"
+#include "file_stamp.hpp"
+#include "file_watcher.hpp"
+#include "function_table.hpp"
 #include "i_plugin.hpp"
+#include "load_policy.hpp"
+#include "message_bus.hpp"
+#include "phase_timings.hpp"
+#include "service_registry.hpp"
+#include "shared_library.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 
-// Platform-specific includes
-#ifdef _WIN32
-#include <windows.h>
-typedef HMODULE LibraryHandle;
-#else
-#include <dlfcn.h>
-typedef void* LibraryHandle;
-#endif
-
 namespace hotplugpp {
 
 /**
@@ -27,15 +31,54 @@ struct PluginInfo {
     IPlugin* instance = nullptr;
     CreatePluginFunc createFunc = nullptr;
     DestroyPluginFunc destroyFunc = nullptr;
+    /// HOTPLUGPP_INTERFACE_VERSION the library was built against; hooks it lacks are not called
+    uint32_t interfaceVersion = 1;
+    /// Optional C function table exported by the plugin
+    const HotPlugPPFunctionTable* functionTable = nullptr;
+    /// Memory of the instance if the plugin was created with a host allocator, owned by the loader
+    Arena* arena = nullptr;
+    /// Registry the instance was attached to; its services are revoked on unload
+    ServiceRegistry* serviceRegistry = nullptr;
     std::chrono::system_clock::time_point lastModified;
     bool isLoaded = false;
+    /// false while onLoad() is deferred, see LoadPolicy::Deferred
+    bool isInitialized = false;
+    /// true while the instance reports InitStatus::Initializing after onLoad()
+    bool isInitializing = false;
+    /// Private copy the library was loaded from by a reload, if it still exists
+    std::string shadowPath;
+    /// File version the instance was loaded from; lastModified mirrors its mtime
+    FileStamp fileStamp;
+    /// xxhash64 of the file contents, 0 unless content hashing is enabled
+    uint64_t contentHash = 0;
+};
+
+/**
+ * @brief How checkAndReload() brings in a modified plugin
+ *
+ * In both modes the new version is loaded from a private copy of the library
+ * and fully initialized before the old instance is unloaded, so a broken
+ * build leaves the old version running.
+ */
+enum class ReloadMode {
+    /// Load and initialize the new version inside checkAndReload()
+    Blocking,
+    /// Load and initialize the new version on a worker thread; a later
+    /// checkAndReload() swaps it in once it is ready
+    Staged,
 };
 
 /**
  * @brief Manages dynamic loading, unloading, and hot-reloading of plugins
+ *
+ * Loading, reloading and acquirePlugin() belong to one owning thread. Other
+ * threads reach the plugin through readPlugin(), which takes no lock and
+ * keeps the instance and its library alive while a reload or unload runs.
  */
 class PluginLoader {
   public:
+    class ReadGuard;
+
     PluginLoader();
     ~PluginLoader();
 
@@ -50,23 +93,144 @@ class PluginLoader {
      */
     bool loadPlugin(const std::string& path);
 
+    /**
+     * @brief Start loading a plugin on a background thread
+     *
+     * Unloads the current plugin, then opens the library and runs onLoad()
+     * on a worker thread (with LoadPolicy::Deferred only the library is
+     * opened), so a plugin that reads large files while loading does not
+     * stall the caller. Call pollLoad() once per frame to adopt the result.
+     *
+     * @param path Path to the plugin library (.so/.dll/.dylib)
+     */
+    void loadPluginAsync(const std::string& path);
+
+    /**
+     * @brief Adopt a finished asynchronous load and check whether the plugin is ready
+     *
+     * Never blocks. A plugin that reports InitStatus::Failed is unloaded.
+     *
+     * @return Load state after the poll
+     */
+    PluginLoadState pollLoad();
+
+    /**
+     * @brief Get how far the plugin has come towards being usable
+     * @return Load state as of the last poll, see pollLoad()
+     */
+    PluginLoadState getLoadState() const;
+
     /**
      * @brief Unload the currently loaded plugin
+     *
+     * A load started by loadPluginAsync() is waited for and thrown away.
      */
     void unloadPlugin();
 
     /**
      * @brief Check if plugin file has been modified and reload if necessary
+     *
+     * Call once per frame. In ReloadMode::Staged the call that detects a
+     * change only starts loading the new version; the old instance keeps
+     * working until a later call swaps in the ready successor. If the new
+     * version fails to load, the old one stays loaded. Plugins that implement
+     * the IPlugin state hooks hand their state to the new instance.
+     *
      * @return true if plugin was reloaded, false otherwise
      */
     bool checkAndReload();
 
     /**
      * @brief Get the loaded plugin instance
-     * @return Pointer to plugin instance or nullptr if not loaded
+     *
+     * Runs and polls nothing; use acquirePlugin() to complete a deferred or
+     * asynchronous load on the way.
+     *
+     * @return Pointer to plugin instance or nullptr if not loaded, initialized and ready
      */
     IPlugin* getPlugin() const;
 
+    /**
+     * @brief Get the loaded plugin instance, completing its load first
+     *
+     * Runs a deferred onLoad() first. If it fails, the plugin is unloaded and
+     * nullptr is returned. Also polls like pollLoad(), and returns nullptr
+     * while an asynchronous load runs or the plugin reports
+     * InitStatus::Initializing, so it is not updated before it is ready.
+     *
+     * @return Pointer to plugin instance or nullptr if not loaded or not ready
+     */
+    IPlugin* acquirePlugin();
+
+    /**
+     * @brief Access the plugin from any thread, safe against concurrent reloads
+     *
+     * Takes no lock: the guard enters an epoch critical section and reads
+     * the current instance. Until it is destroyed, checkAndReload(),
+     * unloadPlugin() and loadPlugin() wait before tearing that instance
+     * down, so hold it for one call or one frame, never on the owning
+     * thread while calling those. A deferred onLoad() is not run; the guard
+     * is empty until the owning thread initializes the plugin and it is ready.
+     * While a reload hands state over, the guard is briefly empty, so no
+     * reader calls into the old instance after its saveState() ran.
+     *
+     * @return Guard holding the instance, or an empty guard if none is initialized
+     */
+    ReadGuard readPlugin() const;
+
+    /**
+     * @brief Run a deferred onLoad() now, e.g. in an idle window
+     *
+     * If onLoad() fails, the plugin is unloaded.
+     *
+     * @return true if the plugin is loaded and initialized
+     */
+    bool initializePlugin();
+
+    /**
+     * @brief Check whether onLoad() has run for the loaded plugin
+     * @return false if not loaded or onLoad() is still deferred
+     */
+    bool isInitialized() const;
+
+    /**
+     * @brief Get the C function table exported by the loaded plugin
+     *
+     * Valid until the plugin is reloaded or unloaded; pass getPlugin() as the
+     * instance argument.
+     *
+     * @return Function table, or nullptr if not loaded or the plugin exports none
+     */
+    const HotPlugPPFunctionTable* getFunctionTable() const;
+
+    /**
+     * @brief Get the arena the loaded plugin allocates from
+     *
+     * Plugins built with HOTPLUGPP_CREATE_PLUGIN_WITH_ALLOCATOR live in an
+     * arena of their own that is released as a whole when they are unloaded
+     * or replaced by a reload.
+     *
+     * @return Arena, or nullptr if not loaded or the plugin uses the global heap
+     */
+    const Arena* getArena() const;
+
+    /**
+     * @brief Get the number of live plugin instances sharing this loader's library
+     *
+     * Every loader and manager in the process that loads the same file shares
+     * one library handle; it is unloaded when the last of them lets go.
+     *
+     * @return Instance count including this one, 0 if not loaded
+     */
+    size_t getLibraryInstanceCount() const;
+
+    /**
+     * @brief Get the number of live plugin instances created from a library file
+     * @param path Path to the plugin library
+     * @return Instance count across all loaders and managers, 0 if the file is not loaded
+     */
+    static size_t getLibraryInstanceCount(const std::string& path);
+
     /**
      * @brief Check if a plugin is currently loaded
      * @return true if plugin is loaded, false otherwise
@@ -79,49 +243,318 @@ class PluginLoader {
      */
     std::string getPluginPath() const;
 
+    /**
+     * @brief Choose how much work loadPlugin() does up front
+     *
+     * With LoadPolicy::Deferred the library is opened with lazy symbol
+     * binding and onLoad() runs on the first acquirePlugin() or
+     * initializePlugin() call. Until then reloads replace the instance
+     * without initializing it. Takes effect with the next load.
+     *
+     * @param policy Load policy, LoadPolicy::Eager by default
+     */
+    void setLoadPolicy(LoadPolicy policy);
+
+    /**
+     * @brief Get the load policy
+     * @return Current load policy
+     */
+    LoadPolicy getLoadPolicy() const;
+
+    /**
+     * @brief Hand a message bus to the plugin
+     *
+     * Libraries declared with HOTPLUGPP_USE_MESSAGE_BUS() receive the bus
+     * before each instance is created, including the new build on every
+     * reload, so subscriptions made in onLoad() are re-bound automatically.
+     * Takes effect with the next load or reload.
+     *
+     * @param bus Bus owned by the host, which must outlive the plugin; nullptr to detach
+     */
+    void setMessageBus(MessageBus* bus);
+
+    /**
+     * @brief Get the message bus handed to the plugin
+     * @return Bus, or nullptr if none is set
+     */
+    MessageBus* getMessageBus() const;
+
+    /**
+     * @brief Hand a service registry to the plugin
+     *
+     * Libraries declared with HOTPLUGPP_USE_SERVICE_REGISTRY() receive the
+     * registry before each instance is created. Services the instance
+     * provided are revoked before it is unloaded; the new build provides
+     * them again on reload, which rebinds every cached ServiceRef. Takes
+     * effect with the next load or reload.
+     *
+     * @param registry Registry owned by the host, which must outlive the plugin; nullptr to
+     *                 detach
+     */
+    void setServiceRegistry(ServiceRegistry* registry);
+
+    /**
+     * @brief Get the service registry handed to the plugin
+     * @return Registry, or nullptr if none is set
+     */
+    ServiceRegistry* getServiceRegistry() const;
+
     /**
      * @brief Set callback for when plugin is reloaded
      * @param callback Function to call when plugin is reloaded
      */
     void setReloadCallback(std::function<void()> callback);
 
+    /**
+     * @brief Choose how modified plugins are reloaded
+     * @param mode Reload mode, ReloadMode::Staged by default
+     */
+    void setReloadMode(ReloadMode mode);
+
+    /**
+     * @brief Get the reload mode
+     * @return Current reload mode
+     */
+    ReloadMode getReloadMode() const;
+
+    /**
+     * @brief Check whether a staged reload is loading in the background
+     * @return true if a new version is being prepared
+     */
+    bool isReloadPending() const;
+
+    /**
+     * @brief Watch the plugin file on a background thread instead of polling it
+     *
+     * While enabled, checkAndReload() only drains the watcher's event queue and
+     * makes no system calls unless the file actually changed.
+     *
+     * @param enable true to start the watcher, false to go back to polling
+     * @return true if the requested mode is active
+     */
+    bool enableFileWatcher(bool enable = true);
+
+    /**
+     * @brief Check whether the background file watcher is in use
+     * @return true if enabled
+     */
+    bool isFileWatcherEnabled() const;
+
+    /**
+     * @brief Compare file contents before reloading
+     *
+     * A file counts as changed when its modification time (in nanoseconds),
+     * size or inode differ from the loaded version. With content hashing
+     * enabled, a changed file is additionally hashed, and a byte-identical
+     * rebuild or a plain touch skips the unload/load cycle.
+     *
+     * @param enable true to hash plugin files, false to rely on file stamps only
+     */
+    void setContentHashing(bool enable);
+
+    /**
+     * @brief Check whether plugin files are hashed before reloading
+     * @return true if content hashing is enabled
+     */
+    bool isContentHashingEnabled() const;
+
+    /**
+     * @brief Wait for a modified plugin file to stop changing before reloading it
+     *
+     * Linkers write a library in several bursts, and loading it in between
+     * either fails or reloads the plugin several times per build. With a
+     * debounce interval set, a change is only acted on once the file's
+     * modification time and size have stayed the same for that long, so every
+     * build causes exactly one reload. A file renamed onto the plugin path is
+     * complete by construction and, when the file watcher reports it, is
+     * reloaded without waiting.
+     *
+     * checkAndReload() has to keep being called while a change settles.
+     *
+     * @param debounce Quiet period, 0 (default) to reload on the first change seen
+     */
+    void setReloadDebounce(std::chrono::milliseconds debounce);
+
+    /**
+     * @brief Get the quiet period a modified plugin file must observe before reloading
+     * @return Debounce interval
+     */
+    std::chrono::milliseconds getReloadDebounce() const;
+
+    /**
+     * @brief Get the latency of one load/unload/reload phase
+     * @param phase Phase
+     * @return Count, p50, p99 and max of all recorded durations of the phase
+     */
+    LatencyStats getPhaseStats(LoadPhase phase) const;
+
+    /**
+     * @brief Get the latency histograms of all phases
+     * @return Phase timings recorded by this loader
+     */
+    const PhaseTimings& getPhaseTimings() const;
+
+    /**
+     * @brief Set a callback invoked after every timed phase
+     *
+     * Phases of a staged reload are reported from the worker thread that
+     * loads the new version. Waits for a pending staged reload to finish
+     * loading before the callback is replaced.
+     *
+     * @param callback Callback, or nullptr to disable
+     */
+    void setPhaseCallback(PhaseCallback callback);
+
+    /**
+     * @brief Forget all recorded phase timings
+     */
+    void resetPhaseTimings();
+
   private:
+    /**
+     * @brief Instance and function table as seen by readPlugin(), replaced as a whole
+     */
+    struct PublishedPlugin {
+        IPlugin* instance = nullptr;
+        const HotPlugPPFunctionTable* functionTable = nullptr;
+    };
+
     PluginInfo m_pluginInfo;
+    /// Read-side critical sections of readPlugin()
+    mutable EpochDomain m_epochs;
+    std::atomic<const PublishedPlugin*> m_published{nullptr};
+    /// Owns what m_published points to
+    std::unique_ptr<PublishedPlugin> m_publishedPlugin;
     std::function<void()> m_reloadCallback;
+    std::unique_ptr<FileWatcher> m_fileWatcher;
+    uint32_t m_watchedFileId = FileWatcher::INVALID_FILE_ID;
+    std::string m_watchedPath;
+    ReloadMode m_reloadMode = ReloadMode::Staged;
+    LoadPolicy m_loadPolicy = LoadPolicy::Eager;
+    MessageBus* m_messageBus = nullptr;
+    ServiceRegistry* m_serviceRegistry = nullptr;
+    std::future<PluginInfo> m_stagedReload;
+    /// Load started by loadPluginAsync(), not adopted yet
+    std::future<PluginInfo> m_pendingLoad;
+    /// State handed to the current instance by its predecessor, see IPlugin::loadState()
+    std::unique_ptr<std::max_align_t[]> m_stateBuffer;
+    PhaseTimings m_phaseTimings;
+    bool m_contentHashing = false;
+    std::chrono::milliseconds m_reloadDebounce{0};
+    /// Changed file version waiting out the debounce interval
+    FileStamp m_pendingStamp;
+    std::chrono::steady_clock::time_point m_pendingSince;
 
     /**
-     * @brief Get the last modification time of a file
-     * @param path File path
-     * @return Last modification time
+     * @brief Show a plugin to readPlugin() and wait until no reader holds the previous one
+     * @param info Plugin to publish, or nullptr; published only if loaded and initialized
      */
-    std::chrono::system_clock::time_point getFileModificationTime(const std::string& path);
+    void publishPlugin(const PluginInfo* info);
 
     /**
-     * @brief Load a shared library
-     * @param path Library path
-     * @return Library handle or nullptr on failure
+     * @brief Make a freshly loaded plugin the current one
+     * @param info Result of loading; nothing happens if isLoaded is false
+     * @return true if the plugin was adopted
      */
-    LibraryHandle loadLibrary(const std::string& path);
+    bool adoptPlugin(PluginInfo info);
 
     /**
-     * @brief Unload a shared library
-     * @param handle Library handle
+     * @brief Ask a plugin that is still initializing whether it is done
+     *
+     * Publishes the plugin once it is ready and unloads it if it failed.
      */
-    void unloadLibrary(LibraryHandle handle);
+    void pollInitStatus();
 
     /**
-     * @brief Get a function pointer from a library
-     * @param handle Library handle
-     * @param name Function name
-     * @return Function pointer or nullptr on failure
+     * @brief Forget the current plugin after its module was unloaded or discarded
      */
-    void* getFunction(LibraryHandle handle, const std::string& name);
+    void clearPluginInfo();
 
     /**
-     * @brief Get the last error message from dynamic library loading
-     * @return Error message string
+     * @brief Point the file watcher at the current plugin path
      */
-    std::string getLastError();
+    void updateWatchedFile();
+
+    /**
+     * @brief Drain the file watcher's event queue
+     * @param replaced Set to true if a complete file was renamed onto the plugin path
+     * @return true if the plugin file may have changed
+     */
+    bool consumeFileEvents(bool& replaced);
+
+    /**
+     * @brief Compare the plugin file against the version that is loaded
+     *
+     * A touched but byte-identical file updates the stored stamp and does
+     * not count as changed, and neither does a file that is still being written.
+     *
+     * @param replaced true if the file is known to be complete, skipping the debounce
+     * @return true if the plugin file should be reloaded
+     */
+    bool hasPluginFileChanged(bool replaced);
+
+    /**
+     * @brief Swap in a staged plugin version, or keep the current one if it failed
+     *
+     * A version staged without onLoad() whose predecessor has been used since
+     * is not initialized here; it goes back to a worker as a new staged reload.
+     *
+     * @param staged Result of loading the new version
+     * @return true if the new version is now active
+     */
+    bool commitReload(PluginInfo staged);
+
+    /**
+     * @brief Wait for a pending staged reload and throw its result away
+     */
+    void discardStagedReload();
+
+    /**
+     * @brief Wait for a pending asynchronous load and throw its result away
+     */
+    void discardPendingLoad();
 };
 
+/**
+ * @brief Plugin instance held by PluginLoader::readPlugin()
+ *
+ * Move-only; the instance and its library stay valid until the guard is
+ * destroyed.
+ */
+class PluginLoader::ReadGuard {
+  public:
+    ReadGuard(ReadGuard&&) = default;
+
+    /**
+     * @brief Get the instance
+     * @return Instance, or nullptr if no plugin was initialized
+     */
+    IPlugin* get() const { return m_plugin ? m_plugin->instance : nullptr; }
+
+    IPlugin* operator->() const { return get(); }
+
+    explicit operator bool() const { return get() != nullptr; }
+
+    /**
+     * @brief Get the function table of the instance
+     * @return Function table, or nullptr if none
+     */
+    const HotPlugPPFunctionTable* getFunctionTable() const {
+        return m_plugin ? m_plugin->functionTable : nullptr;
+    }
+
+  private:
+    friend class PluginLoader;
+
+    ReadGuard(EpochDomain& epochs, const std::atomic<const PublishedPlugin*>& published)
+        : m_epoch(epochs), m_plugin(published.load(std::memory_order_seq_cst)) {}
+
+    EpochGuard m_epoch;
+    const PublishedPlugin* m_plugin;
+};
+
+inline PluginLoader::ReadGuard PluginLoader::readPlugin() const {
+    return ReadGuard(m_epochs, m_published);
+}
+
 } // namespace hotplugpp
\ No newline at end of file
@@ -0,0 +1,927 @@
+#pragma once
+
+#include "arena.hpp"
+#include "file_stamp.hpp"
+#include "file_watcher.hpp"
+#include "function_table.hpp"
+#include "i_plugin.hpp"
+#include "latency_histogram.hpp"
+#include "load_policy.hpp"
+#include "message_bus.hpp"
+#include "service_registry.hpp"
+#include "shared_library.hpp"
+#include "update_scheduler.hpp"
+#include "update_watchdog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hotplugpp {
+
+namespace detail {
+struct LoadedModule;
+} // namespace detail
+
+/**
+ * @brief Generational handle to a plugin owned by a PluginManager
+ *
+ * A handle stays valid across successful hot-reloads of its plugin. Once the
+ * plugin is unloaded the slot's generation is bumped, so old copies of the
+ * handle resolve to nullptr instead of dangling.
+ */
+struct PluginHandle {
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+
+    /// Pack the handle into a single 64-bit ID
+    uint64_t toId() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+    /// Rebuild a handle from an ID produced by toId()
+    static PluginHandle fromId(uint64_t id) {
+        PluginHandle handle;
+        handle.index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        handle.generation = static_cast<uint32_t>(id >> 32);
+        return handle;
+    }
+
+    bool operator==(const PluginHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const PluginHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief One entry of a batch load
+ */
+struct PluginLoadRequest {
+    /// Path to the plugin library
+    std::string path;
+    /// Paths of other requests in the same batch whose onLoad() must finish first
+    std::vector<std::string> dependencies;
+};
+
+/**
+ * @brief Outcome of one entry of a batch load
+ */
+struct PluginLoadResult {
+    std::string path;
+    /// Handle of the loaded plugin, invalid on failure
+    PluginHandle handle;
+    bool success = false;
+    /// Description of the failure, empty on success
+    std::string error;
+};
+
+/**
+ * @brief Options for PluginManager::loadPlugins()
+ */
+struct BatchLoadOptions {
+    /// Worker threads used for loading, 0 to use the hardware concurrency
+    size_t threadCount = 0;
+    /// Run onLoad() on the workers as well; otherwise it runs on the calling thread
+    bool parallelInit = true;
+};
+
+/**
+ * @brief onUpdate() timings of one plugin, see PluginManager::enableUpdateTiming()
+ */
+struct UpdateStats {
+    uint64_t updateCount = 0;
+    std::chrono::nanoseconds lastDuration{0};
+    std::chrono::nanoseconds maxDuration{0};
+    std::chrono::nanoseconds totalDuration{0};
+    /// Updates that took longer than the plugin's budget
+    uint64_t overBudgetCount = 0;
+};
+
+/**
+ * @brief An update that ran over a time limit, see PluginManager::setBudgetCallback()
+ */
+struct UpdateOverrun {
+    PluginHandle handle;
+    /// Plugin name, valid during the callback
+    const char* name = nullptr;
+    /// How long the update took, or has been running for if reported by the watchdog
+    std::chrono::nanoseconds duration{0};
+    /// Budget or hard limit that was exceeded
+    std::chrono::nanoseconds limit{0};
+};
+
+/**
+ * @brief Owns many loaded plugins and addresses them through PluginHandles
+ *
+ * Plugins are kept in a dense structure-of-arrays table (instance, library,
+ * factories, modification time), so iterating over all plugins touches only
+ * the columns it needs. A sparse slot array maps handle indices to dense rows
+ * in O(1); plugin names are looked up through a hash index.
+ */
+class PluginManager {
+  public:
+    PluginManager();
+    ~PluginManager();
+
+    // Disable copy
+    PluginManager(const PluginManager&) = delete;
+    PluginManager& operator=(const PluginManager&) = delete;
+
+    /**
+     * @brief Load a plugin from a shared library
+     * @param path Path to the plugin library (.so/.dll/.dylib)
+     * @return Handle to the plugin, or an invalid handle on failure
+     */
+    PluginHandle loadPlugin(const std::string& path);
+
+    /**
+     * @brief Start loading a plugin on a background thread
+     *
+     * Opening the library and onLoad() run on a worker thread (with
+     * LoadPolicy::Deferred only the library is opened), so a plugin that reads
+     * large files while loading does not stall the caller. The handle reports
+     * PluginLoadState::Loading and resolves to nullptr until pollLoads() or
+     * updateAll() adopts the finished load; if the load fails it goes stale.
+     * Unloading the handle before then cancels the load.
+     *
+     * @param path Path to the plugin library (.so/.dll/.dylib)
+     * @return Handle to the plugin being loaded
+     */
+    PluginHandle loadPluginAsync(const std::string& path);
+
+    /**
+     * @brief Adopt finished asynchronous loads and check plugins that are still initializing
+     *
+     * Never blocks. Plugins whose getInitStatus() reports InitStatus::Failed
+     * are unloaded. Reloaded builds that finished loading and their setup
+     * replace the previous version now, and the reload callback runs; a
+     * build that failed is dropped and the previous version kept. Called by
+     * updateAll(), so hosts that update every frame need not call it
+     * themselves.
+     *
+     * @return Number of plugins that became ready
+     */
+    size_t pollLoads();
+
+    /**
+     * @brief Get how far a plugin has come towards being updated
+     * @param handle Plugin handle, e.g. returned by loadPluginAsync()
+     * @return Load state, PluginLoadState::Unloaded if the handle is invalid, stale or its
+     *         load failed
+     */
+    PluginLoadState getLoadState(PluginHandle handle) const;
+
+    /**
+     * @brief Load a batch of plugins on a pool of worker threads
+     *
+     * Libraries are opened and instances created concurrently. onLoad() of a
+     * plugin only runs once the onLoad() of every plugin it depends on has
+     * succeeded; plugins with a failed, unknown or cyclic dependency fail
+     * without being initialized. Successful plugins are added to the manager
+     * in request order.
+     *
+     * With LoadPolicy::Deferred no onLoad() runs here; dependencies are only
+     * checked for unknown paths and cycles, and plugins are added in
+     * dependency order so that deferred initialization follows it.
+     *
+     * @param requests Plugins to load and their dependencies
+     * @param options Threading options
+     * @return One result per request, in request order
+     */
+    std::vector<PluginLoadResult> loadPlugins(const std::vector<PluginLoadRequest>& requests,
+                                              const BatchLoadOptions& options = BatchLoadOptions());
+
+    /**
+     * @brief Load a batch of independent plugins on a pool of worker threads
+     * @param paths Paths to the plugin libraries
+     * @param options Threading options
+     * @return One result per path, in input order
+     */
+    std::vector<PluginLoadResult> loadPlugins(const std::vector<std::string>& paths,
+                                              const BatchLoadOptions& options = BatchLoadOptions());
+
+    /**
+     * @brief Unload a plugin and invalidate its handle
+     * @param handle Plugin handle
+     * @return true if the handle referred to a live plugin
+     */
+    bool unloadPlugin(PluginHandle handle);
+
+    /**
+     * @brief Unload every plugin owned by the manager
+     */
+    void unloadAll();
+
+    /**
+     * @brief Check all plugin files for modifications and start reloading changed plugins
+     *
+     * The new version of a plugin is loaded from a private copy of its library
+     * and initialized on a worker thread, so this call never waits for a
+     * library to open or for onLoad(). The old instance keeps running until
+     * pollLoads() (or updateAll()) sees the new one ready, including any
+     * setup it reports through getInitStatus(), and swaps it in between
+     * frames; the reload callback runs then. Handles of reloaded plugins stay
+     * valid; if the new version fails to load, the old one keeps running.
+     * Plugins that implement the IPlugin state hooks hand their state to the
+     * new instance.
+     *
+     * @return Number of reloads started by this call
+     */
+    size_t checkAndReload();
+
+    /**
+     * @brief Check whether a reload of a plugin has started but not been swapped in yet
+     * @param handle Plugin handle
+     * @return true while a new version is loading or finishing its setup
+     */
+    bool isReloadPending(PluginHandle handle) const;
+
+    /**
+     * @brief Call onUpdate() on every loaded plugin
+     *
+     * Instances of a library that exports a batch entry point (see
+     * HOTPLUGPP_UPDATE_BATCH and HOTPLUGPP_FUNCTION_TABLE) are updated together
+     * by one call to it, at the position of the first of them. Plugins with a
+     * function table are called through it instead of the IPlugin vtable.
+     * With parallel update enabled, plugins whose declared access does not
+     * conflict run concurrently and every instance is updated on its own; the
+     * call returns once all have finished.
+     *
+     * Finished asynchronous loads are adopted and deferred plugins are
+     * initialized first, see pollLoads() and initializePending(). Plugins
+     * still reporting InitStatus::Initializing are skipped.
+     *
+     * @param deltaTime Time elapsed since last update in seconds
+     */
+    void updateAll(float deltaTime);
+
+    /**
+     * @brief Choose how much work loading a plugin does up front
+     *
+     * With LoadPolicy::Deferred libraries are opened with lazy symbol binding
+     * and onLoad() runs when the plugin is first resolved through acquirePlugin(),
+     * by the next updateAll(), or by initializePending() in an idle window.
+     * Plugins whose deferred onLoad() fails are unloaded. Takes effect with
+     * the next load.
+     *
+     * @param policy Load policy, LoadPolicy::Eager by default
+     */
+    void setLoadPolicy(LoadPolicy policy);
+
+    /**
+     * @brief Get the load policy
+     * @return Current load policy
+     */
+    LoadPolicy getLoadPolicy() const;
+
+    /**
+     * @brief Hand a message bus to every plugin
+     *
+     * Libraries declared with HOTPLUGPP_USE_MESSAGE_BUS() receive the bus
+     * before each instance is created, including the new build on every
+     * reload. Takes effect with the next load or reload.
+     *
+     * @param bus Bus owned by the host, which must outlive the plugins; nullptr to detach
+     */
+    void setMessageBus(MessageBus* bus);
+
+    /**
+     * @brief Get the message bus handed to plugins
+     * @return Bus, or nullptr if none is set
+     */
+    MessageBus* getMessageBus() const;
+
+    /**
+     * @brief Hand a service registry to every plugin
+     *
+     * Libraries declared with HOTPLUGPP_USE_SERVICE_REGISTRY() receive the
+     * registry before each instance is created. Services an instance
+     * provided are revoked before it is unloaded, and rebound when its
+     * reloaded build provides them again. Takes effect with the next load or
+     * reload.
+     *
+     * @param registry Registry owned by the host, which must outlive the plugins; nullptr to
+     *                 detach
+     */
+    void setServiceRegistry(ServiceRegistry* registry);
+
+    /**
+     * @brief Get the service registry handed to plugins
+     * @return Registry, or nullptr if none is set
+     */
+    ServiceRegistry* getServiceRegistry() const;
+
+    /**
+     * @brief Run deferred onLoad() calls in load order
+     * @param budget Stop starting new onLoad() calls once this much time has passed; at
+     *        least one plugin is always initialized. 0 to initialize every pending plugin
+     * @return Number of plugins initialized successfully
+     */
+    size_t initializePending(std::chrono::microseconds budget = std::chrono::microseconds(0));
+
+    /**
+     * @brief Get the number of plugins whose onLoad() is still deferred
+     * @return Pending plugin count
+     */
+    size_t getPendingInitCount() const;
+
+    /**
+     * @brief Check whether onLoad() has run for a plugin
+     * @param handle Plugin handle
+     * @return false if onLoad() is still deferred or the handle is invalid
+     */
+    bool isInitialized(PluginHandle handle) const;
+
+    /**
+     * @brief Run updateAll() on a work-stealing thread pool
+     *
+     * The calling thread takes part in every update, so a thread count of 1
+     * runs plugins inline but still honours the declared order and records
+     * UpdateStats. Plugins that have not declared their access through
+     * setUpdateAccess() conflict with every other plugin and run alone.
+     *
+     * @param enable true to schedule updates in parallel, false to call plugins one by one
+     * @param threadCount Threads including the caller, 0 for the hardware concurrency
+     */
+    void enableParallelUpdate(bool enable = true, size_t threadCount = 0);
+
+    /**
+     * @brief Check whether updateAll() uses the parallel scheduler
+     * @return true if enabled
+     */
+    bool isParallelUpdateEnabled() const;
+
+    /**
+     * @brief Declare which shared resources a plugin touches in onUpdate()
+     *
+     * Resources are arbitrary names such as "physics.bodies". A plugin that
+     * writes a resource never runs concurrently with another plugin reading
+     * or writing it; conflicting plugins update in the order they were loaded.
+     * The declaration survives hot reloads.
+     *
+     * @param handle Plugin handle
+     * @param reads Resources the plugin only reads
+     * @param writes Resources the plugin modifies
+     * @return false if the handle is invalid or stale
+     */
+    bool setUpdateAccess(PluginHandle handle, const std::vector<std::string>& reads,
+                         const std::vector<std::string>& writes);
+
+    /**
+     * @brief Time every onUpdate() call made by updateAll()
+     *
+     * Each call is recorded into the plugin's UpdateStats and latency
+     * histogram and checked against its update budget. Updates are always
+     * timed while parallel update is enabled or the watchdog runs. Plugins
+     * updated through a batch entry point keep being called as one batch and
+     * are timed as a whole, so each is charged an equal share: their
+     * histograms and budget checks are approximate, and the watchdog reports
+     * every plugin of a batch while the batch call runs.
+     *
+     * @param enable true to time updates
+     */
+    void enableUpdateTiming(bool enable = true);
+
+    /**
+     * @brief Check whether updateAll() times plugin updates
+     * @return true if timing was enabled, parallel update is enabled or the watchdog runs
+     */
+    bool isUpdateTimingEnabled() const;
+
+    /**
+     * @brief Get the onUpdate() timings of a plugin
+     *
+     * Only recorded while updates are timed, see enableUpdateTiming().
+     *
+     * @param handle Plugin handle
+     * @return Timings, all zero if the handle is invalid or stale
+     */
+    UpdateStats getUpdateStats(PluginHandle handle) const;
+
+    /**
+     * @brief Get the distribution of a plugin's onUpdate() durations
+     *
+     * Valid until the plugin is unloaded; it keeps recording across reloads.
+     *
+     * @param handle Plugin handle
+     * @return Histogram, or nullptr if no update was timed yet or the handle is invalid
+     */
+    const LatencyHistogram* getUpdateHistogram(PluginHandle handle) const;
+
+    /**
+     * @brief Override the time budget a plugin declared through IPlugin::getUpdateBudget()
+     *
+     * The override survives hot reloads.
+     *
+     * @param handle Plugin handle
+     * @param budget Longest expected onUpdate() call, zero for none
+     * @return false if the handle is invalid or stale
+     */
+    bool setUpdateBudget(PluginHandle handle, std::chrono::nanoseconds budget);
+
+    /**
+     * @brief Get the time budget of a plugin's updates
+     * @param handle Plugin handle
+     * @return Budget, zero if none or the handle is invalid
+     */
+    std::chrono::nanoseconds getUpdateBudget(PluginHandle handle) const;
+
+    /**
+     * @brief Set a callback for timed updates that ran over their plugin's budget
+     *
+     * Called on the thread calling updateAll(), after every plugin was
+     * updated, once per overrun.
+     *
+     * @param callback Function called with each overrun
+     */
+    void setBudgetCallback(std::function<void(const UpdateOverrun&)> callback);
+
+    /**
+     * @brief Watch updateAll() for plugin updates that do not return in time
+     *
+     * A background thread reports every update still running after the hard
+     * limit, such as an infinite loop after a bad reload, with a warning and
+     * the callback. The callback runs on the watchdog thread while the
+     * update is stuck and must not call back into the manager. The update
+     * itself cannot be interrupted.
+     *
+     * @param limit Hard limit per update
+     * @param callback Function called with each stalled update, may be empty
+     * @return false if the limit is not positive
+     */
+    bool startWatchdog(std::chrono::nanoseconds limit,
+                       std::function<void(const UpdateOverrun&)> callback = nullptr);
+
+    /**
+     * @brief Stop the watchdog thread
+     */
+    void stopWatchdog();
+
+    /**
+     * @brief Check whether the watchdog runs
+     * @return true if started
+     */
+    bool isWatchdogRunning() const;
+
+    /**
+     * @brief Check whether a plugin is updated through its library's batch entry point
+     * @param handle Plugin handle
+     * @return true if the library exports updatePluginBatch or a function table with
+     *         updateBatch, false otherwise or if invalid
+     */
+    bool isBatchUpdated(PluginHandle handle) const;
+
+    /**
+     * @brief Get the C function table exported by a plugin
+     *
+     * Valid until the plugin is reloaded or unloaded; pass getPlugin() as the
+     * instance argument.
+     *
+     * @param handle Plugin handle
+     * @return Function table, or nullptr if the plugin exports none or the handle is invalid
+     */
+    const HotPlugPPFunctionTable* getFunctionTable(PluginHandle handle) const;
+
+    /**
+     * @brief Get the arena a plugin allocates from
+     *
+     * Plugins built with HOTPLUGPP_CREATE_PLUGIN_WITH_ALLOCATOR get an arena
+     * per instance, released as a whole when the instance is unloaded or
+     * replaced by a reload.
+     *
+     * @param handle Plugin handle
+     * @return Arena, or nullptr if the plugin uses the global heap or the handle is invalid
+     */
+    const Arena* getArena(PluginHandle handle) const;
+
+    /**
+     * @brief Get the number of live plugin instances sharing a plugin's library
+     *
+     * Instances of the same file share one library handle across all managers
+     * and loaders in the process, so the count may include instances this
+     * manager does not own.
+     *
+     * @param handle Plugin handle
+     * @return Instance count, 0 if the handle is invalid
+     */
+    size_t getLibraryInstanceCount(PluginHandle handle) const;
+
+    /**
+     * @brief Get the scheduler behind parallel updates, e.g. to inspect the dependency graph
+     *
+     * The graph is rebuilt by the next updateAll() after plugins were added,
+     * removed or changed their access.
+     *
+     * @return Scheduler, or nullptr if parallel update is disabled
+     */
+    const UpdateScheduler* getUpdateScheduler() const;
+
+    /**
+     * @brief Resolve a handle to its plugin instance
+     *
+     * Runs nothing; use acquirePlugin() to complete a deferred load on the way.
+     *
+     * @param handle Plugin handle
+     * @return Plugin instance, or nullptr if the handle is invalid, stale, not initialized or
+     *         still reporting InitStatus::Initializing
+     */
+    IPlugin* getPlugin(PluginHandle handle) const;
+
+    /**
+     * @brief Resolve a handle to its plugin instance, completing its load first
+     *
+     * Runs a deferred onLoad() first; if it fails, the plugin is unloaded.
+     *
+     * @param handle Plugin handle
+     * @return Plugin instance, or nullptr if the handle is invalid or stale or the plugin is
+     *         not ready yet
+     */
+    IPlugin* acquirePlugin(PluginHandle handle);
+
+    /**
+     * @brief Find a loaded plugin by the name it reports through getName()
+     * @param name Plugin name
+     * @return Handle to the plugin, or an invalid handle if none matches
+     */
+    PluginHandle findPlugin(std::string_view name) const;
+
+    /**
+     * @brief Check whether a handle refers to a live plugin
+     * @param handle Plugin handle
+     * @return true if the handle is neither invalid nor stale
+     */
+    bool isValid(PluginHandle handle) const;
+
+    /**
+     * @brief Get the library path a plugin was loaded from
+     * @param handle Plugin handle
+     * @return Plugin path or empty string if the handle is stale
+     */
+    std::string getPluginPath(PluginHandle handle) const;
+
+    /**
+     * @brief Get the number of loaded plugins
+     * @return Plugin count
+     */
+    size_t getPluginCount() const;
+
+    /**
+     * @brief Get the handle of the plugin stored at a dense position
+     * @param position Position in [0, getPluginCount())
+     * @return Plugin handle
+     */
+    PluginHandle getHandleAt(size_t position) const;
+
+    /**
+     * @brief Set callback for when a plugin is reloaded
+     *
+     * Runs from pollLoads() or updateAll() once the new version replaced the
+     * old one; it may load, reload or unload plugins.
+     *
+     * @param callback Function to call with the handle of the reloaded plugin
+     */
+    void setReloadCallback(std::function<void(PluginHandle)> callback);
+
+    /**
+     * @brief Watch plugin files on a background thread instead of polling them
+     *
+     * While enabled, checkAndReload() only drains the watcher's event queue and
+     * touches the file system only for plugins that actually changed.
+     *
+     * @param enable true to start the watcher, false to go back to polling
+     * @return true if the requested mode is active
+     */
+    bool enableFileWatcher(bool enable = true);
+
+    /**
+     * @brief Check whether the background file watcher is in use
+     * @return true if enabled
+     */
+    bool isFileWatcherEnabled() const;
+
+    /**
+     * @brief Compare file contents before reloading
+     *
+     * With content hashing enabled, a plugin file whose stamp changed is
+     * hashed first, and a byte-identical rebuild or a plain touch skips the
+     * unload/load cycle.
+     *
+     * @param enable true to hash plugin files, false to rely on file stamps only
+     */
+    void setContentHashing(bool enable);
+
+    /**
+     * @brief Check whether plugin files are hashed before reloading
+     * @return true if content hashing is enabled
+     */
+    bool isContentHashingEnabled() const;
+
+    /**
+     * @brief Wait for modified plugin files to stop changing before reloading them
+     *
+     * A change is only acted on once the file's modification time and size
+     * have stayed the same for the debounce interval, so a library written
+     * by the linker in several bursts is reloaded once, and never while it is
+     * half-written. Files the file watcher reports as renamed onto the plugin
+     * path are complete and reload without waiting.
+     *
+     * @param debounce Quiet period, 0 (default) to reload on the first change seen
+     */
+    void setReloadDebounce(std::chrono::milliseconds debounce);
+
+    /**
+     * @brief Get the quiet period a modified plugin file must observe before reloading
+     * @return Debounce interval
+     */
+    std::chrono::milliseconds getReloadDebounce() const;
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    /// Written by whichever worker updates the plugin, so each row gets its own cache line
+    struct alignas(CACHE_LINE) UpdateStatsRow {
+        UpdateStats stats;
+        /// Allocated by the first timed update
+        std::unique_ptr<LatencyHistogram> histogram;
+        std::chrono::nanoseconds budget{0};
+        /// Duration of an overrun not yet reported to the budget callback, else zero
+        std::chrono::nanoseconds overrun{0};
+        /// Set by setUpdateBudget(); the plugin's own budget is ignored from then on
+        bool budgetOverridden = false;
+    };
+
+    // Sparse slots, indexed by PluginHandle::index
+    std::vector<uint32_t> m_slotGenerations;
+    std::vector<uint32_t> m_slotToDense;
+    std::vector<uint32_t> m_freeSlots;
+
+    // Dense columns, one row per loaded plugin
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<IPlugin*> m_instances;
+    std::vector<LibraryHandle> m_libraries;
+    std::vector<CreatePluginFunc> m_createFuncs;
+    std::vector<DestroyPluginFunc> m_destroyFuncs;
+    // HOTPLUGPP_INTERFACE_VERSION of each library; hooks it lacks are not called
+    std::vector<uint32_t> m_interfaceVersions;
+    std::vector<UpdateBatchFunc> m_updateBatchFuncs;
+    std::vector<const HotPlugPPFunctionTable*> m_functionTables;
+    std::vector<Arena*> m_arenas;
+    std::vector<ServiceRegistry*> m_serviceRegistries;
+    std::vector<FileStamp> m_fileStamps;
+    std::vector<uint64_t> m_contentHashes;
+    // Changed file versions waiting out the debounce interval
+    std::vector<FileStamp> m_pendingStamps;
+    std::vector<std::chrono::steady_clock::time_point> m_pendingSince;
+    std::vector<uint64_t> m_nameHashes;
+    // getName() of the instance, read by the watchdog thread while the plugin runs
+    std::vector<const char*> m_names;
+    std::vector<std::string> m_paths;
+    std::vector<std::string> m_shadowPaths;
+    std::vector<std::unique_ptr<std::max_align_t[]>> m_stateBuffers;
+    std::vector<uint32_t> m_watchIds;
+    std::vector<UpdateAccess> m_updateAccess;
+    std::vector<UpdateStatsRow> m_updateStats;
+    // Monotonic load counter; orders conflicting plugins in the update graph
+    std::vector<uint64_t> m_loadSequence;
+    // 1 while onLoad() is deferred
+    std::vector<uint8_t> m_initPending;
+    size_t m_pendingInitCount = 0;
+    // 1 while the plugin reports InitStatus::Initializing; not updated until it is ready
+    std::vector<uint8_t> m_initializing;
+    size_t m_initializingCount = 0;
+    LoadPolicy m_loadPolicy = LoadPolicy::Eager;
+    MessageBus* m_messageBus = nullptr;
+    ServiceRegistry* m_serviceRegistry = nullptr;
+
+    // Plugin name hash -> slot index
+    std::unordered_map<uint64_t, uint32_t> m_nameIndex;
+
+    std::function<void(PluginHandle)> m_reloadCallback;
+
+    bool m_contentHashing = false;
+    std::chrono::milliseconds m_reloadDebounce{0};
+
+    std::unique_ptr<UpdateScheduler> m_updateScheduler;
+    // Update graph task -> dense row, in load order
+    std::vector<uint32_t> m_updateOrder;
+    bool m_updateGraphDirty = true;
+    uint64_t m_nextLoadSequence = 0;
+
+    /// Instances handed to one batch entry point, or a single instance updated on its own
+    struct UpdateBatch {
+        /// Called through the table if set, else through func, else through onUpdate()
+        const HotPlugPPFunctionTable* table = nullptr;
+        UpdateBatchFunc func = nullptr;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    // Serial update plan; instances of a batch are contiguous in m_batchInstances and,
+    // as opaque pointers for function tables, in m_batchHandles
+    std::vector<UpdateBatch> m_updateBatches;
+    std::vector<IPlugin*> m_batchInstances;
+    std::vector<void*> m_batchHandles;
+    // Dense row of each instance, for timing
+    std::vector<uint32_t> m_batchRows;
+    bool m_updateBatchesDirty = true;
+
+    bool m_updateTiming = false;
+    std::function<void(const UpdateOverrun&)> m_budgetCallback;
+    // Rows with an unreported overrun; workers of a parallel update add to it
+    std::atomic<uint32_t> m_pendingOverruns{0};
+    std::vector<UpdateOverrun> m_overruns;
+    // Slots are dense rows
+    std::unique_ptr<UpdateWatchdog> m_watchdog;
+
+    std::unique_ptr<FileWatcher> m_fileWatcher;
+    // Watch ID -> slot index
+    std::unordered_map<uint32_t, uint32_t> m_watchIdToSlot;
+    std::vector<uint32_t> m_changedSlots;
+    // Slots renamed onto by the last batch of events, see setReloadDebounce()
+    std::vector<uint32_t> m_replacedSlots;
+    // Slots whose file change is still settling and must be rechecked without events
+    std::vector<uint32_t> m_settlingSlots;
+
+    struct AsyncLoad;
+    // Loads started by loadPluginAsync(), in request order
+    std::vector<std::unique_ptr<AsyncLoad>> m_asyncLoads;
+    struct PendingReload;
+    // Reloads still loading or initializing, at most one per slot that is not cancelled
+    std::vector<std::unique_ptr<PendingReload>> m_pendingReloads;
+
+    /**
+     * @brief Get the dense row of a handle
+     * @param handle Plugin handle
+     * @return Dense row, or INVALID_INDEX if the handle is invalid or stale
+     */
+    uint32_t denseIndex(PluginHandle handle) const;
+
+    /**
+     * @brief Take a free slot or grow the slot array
+     * @return Slot index, not yet mapped to a dense row
+     */
+    uint32_t allocateSlot();
+
+    /**
+     * @brief Append a module as a new row
+     * @param path Library path the module was loaded from
+     * @param module Opened module
+     * @param initialized false if onLoad() is deferred
+     * @param slot Slot reserved by loadPluginAsync(), or PluginHandle::INVALID_INDEX to
+     *        allocate one
+     * @return Handle to the new row
+     */
+    PluginHandle addPlugin(const std::string& path, const detail::LoadedModule& module,
+                           bool initialized = true,
+                           uint32_t slot = PluginHandle::INVALID_INDEX);
+
+    /**
+     * @brief Find the asynchronous load behind a handle
+     * @param handle Handle returned by loadPluginAsync()
+     * @return Load, or nullptr if the handle is not loading
+     */
+    AsyncLoad* findAsyncLoad(PluginHandle handle);
+
+    /**
+     * @brief Wait for an asynchronous load and add its plugin, or release it if cancelled
+     * @param load Load taken out of m_asyncLoads
+     * @return true if the plugin was added and is ready
+     */
+    bool adoptAsyncLoad(AsyncLoad& load);
+
+    void addNameIndex(uint32_t dense);
+    void removeNameIndex(uint32_t dense);
+
+    /**
+     * @brief Unload the plugin at a dense row and free its slot
+     * @param dense Dense row
+     */
+    void removeAt(uint32_t dense);
+
+    /**
+     * @brief Run the deferred onLoad() of a dense row, removing the row if it fails
+     * @param dense Dense row whose onLoad() is pending
+     * @return true if the plugin is now initialized
+     */
+    bool initializeAt(uint32_t dense);
+
+    /**
+     * @brief Start reloading the plugin at a dense row in place
+     *
+     * The new version is opened and initialized on a worker and parked in
+     * m_pendingReloads; pollReloads() swaps it in once it is ready.
+     *
+     * @param dense Dense row
+     */
+    void reloadAt(uint32_t dense);
+
+    /**
+     * @brief Replace the instance of a dense row, handing over its state
+     * @param dense Dense row
+     * @param module New version
+     * @param initialized false if onLoad() of both versions is still deferred
+     */
+    void replaceAt(uint32_t dense, const detail::LoadedModule& module, bool initialized);
+
+    /**
+     * @brief Swap in reloaded builds that became ready, drop those that failed, then run
+     *        the reload callback for each swapped plugin
+     */
+    void pollReloads();
+
+    /**
+     * @brief Drop the reload of a slot, if any
+     *
+     * A build that is still loading is released by pollReloads() or
+     * unloadAll() once its worker finishes.
+     *
+     * @param slot Slot index
+     */
+    void cancelReload(uint32_t slot);
+
+    /**
+     * @brief Wait for the worker of a reload and unload the build it produced
+     * @param pending Reload to release
+     */
+    void releaseReload(PendingReload& pending);
+
+    /**
+     * @brief Gather the columns of a dense row into a module
+     * @param dense Dense row
+     * @return Module view of the row
+     */
+    detail::LoadedModule moduleAt(uint32_t dense) const;
+
+    /**
+     * @brief Stat every plugin file and reload the modified ones
+     * @return Number of plugins that were reloaded
+     */
+    size_t reloadByFileStamp();
+
+    /**
+     * @brief Compare a plugin file against the version that is loaded
+     *
+     * A touched but byte-identical file updates the stored stamp and does
+     * not count as changed, and neither does a file that is still being written.
+     *
+     * @param dense Dense row
+     * @param replaced true if the file is known to be complete, skipping the debounce
+     * @return true if the plugin file should be reloaded
+     */
+    bool hasFileChanged(uint32_t dense, bool replaced);
+
+    /**
+     * @brief Rebuild the update graph from the access declarations, in load order
+     */
+    void rebuildUpdateGraph();
+
+    /**
+     * @brief Group the rows for serial updates, batching rows that share a batch entry point
+     */
+    void rebuildUpdateBatches();
+
+    /**
+     * @brief Hand one batch of the serial update plan to its entry point
+     * @param batch Batch to update
+     * @param deltaTime Time since the last update
+     */
+    void callBatch(const UpdateBatch& batch, float deltaTime);
+
+    /**
+     * @brief Call every batch of the serial update plan, timing each one
+     * @param deltaTime Time since the last update
+     */
+    void updateBatchesTimed(float deltaTime);
+
+    /**
+     * @brief Add one timed update to a row's stats and check it against the budget
+     * @param dense Dense row
+     * @param duration Duration of the update
+     */
+    void recordUpdate(uint32_t dense, std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Pass the overruns recorded by the last update to the budget callback
+     */
+    void reportOverruns();
+
+    /**
+     * @brief Read a row's update budget from its instance unless the host set one
+     * @param dense Dense row
+     */
+    void refreshUpdateBudget(uint32_t dense);
+
+    void watchRow(uint32_t dense);
+    void unwatchRow(uint32_t dense);
+};
+
+} // namespace hotplugpp
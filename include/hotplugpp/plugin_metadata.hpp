@@ -0,0 +1,89 @@
+#pragma once
+
+#include "i_plugin.hpp"
+
+#include <cstdint>
+#include <string>
+
+/// Name of the section that holds the metadata record
+#define HOTPLUGPP_METADATA_SECTION "hotplugpp_meta"
+/// First bytes of every metadata record
+#define HOTPLUGPP_METADATA_MAGIC "HPPMETA"
+/// Layout version of HotPlugPPMetadata; bumped on incompatible changes
+#define HOTPLUGPP_METADATA_VERSION 1
+
+extern "C" {
+
+/**
+ * @brief Plugin description embedded in the library file
+ *
+ * Plain data with a fixed layout, so a host can read it straight out of the
+ * file without loading the library or running any of its code.
+ */
+struct HotPlugPPMetadata {
+    /// HOTPLUGPP_METADATA_MAGIC, zero-padded
+    char magic[8];
+    /// HOTPLUGPP_METADATA_VERSION the plugin was built with
+    uint32_t formatVersion;
+    /// sizeof(HotPlugPPMetadata) the plugin was built with
+    uint32_t size;
+    uint32_t versionMajor;
+    uint32_t versionMinor;
+    uint32_t versionPatch;
+    uint32_t reserved;
+    /// Zero-terminated unless it fills the array
+    char name[64];
+    char description[256];
+};
+}
+
+namespace hotplugpp {
+
+/**
+ * @brief Metadata of a plugin file, see readPluginMetadata()
+ */
+struct PluginMetadata {
+    std::string name;
+    Version version;
+    std::string description;
+};
+
+/**
+ * @brief Read the metadata record of a plugin without loading it
+ *
+ * Parses the section headers of the file and reads the record from the
+ * HOTPLUGPP_METADATA_SECTION section; the library is never mapped for
+ * execution and none of its code runs, so thousands of candidates can be
+ * scanned and checked with Version::isCompatible() cheaply. Only ELF files
+ * are supported; elsewhere the call fails.
+ *
+ * @param path Path to the plugin library
+ * @param metadata Receives the metadata on success
+ * @return true if the file is a plugin built with HOTPLUGPP_PLUGIN_METADATA
+ */
+bool readPluginMetadata(const std::string& path, PluginMetadata& metadata);
+
+} // namespace hotplugpp
+
+#if defined(__APPLE__)
+#define HOTPLUGPP_METADATA_ATTRIBUTES \
+    __attribute__((used, section("__DATA," HOTPLUGPP_METADATA_SECTION)))
+#elif defined(_WIN32)
+#define HOTPLUGPP_METADATA_ATTRIBUTES
+#else
+#define HOTPLUGPP_METADATA_ATTRIBUTES __attribute__((used, section(HOTPLUGPP_METADATA_SECTION)))
+#endif
+
+/**
+ * Embed a metadata record in the plugin library
+ *
+ * Use once per library, next to HOTPLUGPP_CREATE_PLUGIN. The values should
+ * match what the plugin's getName(), getVersion() and getDescription()
+ * return. The record is also exported as `hotplugppMetadata`. Strings that
+ * do not fit the record fail to compile.
+ */
+#define HOTPLUGPP_PLUGIN_METADATA(name, major, minor, patch, description) \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API HOTPLUGPP_METADATA_ATTRIBUTES const HotPlugPPMetadata \
+        hotplugppMetadata = {HOTPLUGPP_METADATA_MAGIC, HOTPLUGPP_METADATA_VERSION, \
+                             sizeof(HotPlugPPMetadata), (major), (minor), (patch), 0, name, \
+                             description};
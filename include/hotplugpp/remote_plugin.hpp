@@ -0,0 +1,161 @@
+#pragma once
+
+#include "i_plugin.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hotplugpp {
+
+namespace detail {
+struct RemoteChannel;
+struct RemoteMessage;
+} // namespace detail
+
+/**
+ * @brief Options for RemotePlugin::start()
+ */
+struct RemotePluginOptions {
+    /// Path of the hotplugpp_plugin_host executable; empty to use the one next to
+    /// the running executable
+    std::string hostExecutable;
+    /// Longest time a call waits for the plugin process before giving up on it
+    std::chrono::milliseconds timeout{2000};
+};
+
+/**
+ * @brief A plugin running in a child process
+ *
+ * start() spawns hotplugpp_plugin_host, which loads the plugin with a
+ * regular PluginLoader. Calls travel through a pair of lock-free SPSC rings
+ * in shared memory; each side spins briefly for the other and then sleeps on
+ * a futex, so a round trip costs a few microseconds when both processes have
+ * a core and no system call while they keep up with each other.
+ *
+ * A plugin that crashes or hangs only takes its own process down: the call
+ * in flight fails, isRunning() turns false and the host carries on. start()
+ * may be called again to restart the plugin. The plugin process exits on its
+ * own once the host process is gone, whichever thread called start(). Only
+ * supported on Linux.
+ *
+ * Not thread-safe; one thread drives a RemotePlugin at a time.
+ */
+class RemotePlugin {
+  public:
+    RemotePlugin();
+
+    /**
+     * @brief Stop the plugin process
+     */
+    ~RemotePlugin();
+
+    // Disable copy
+    RemotePlugin(const RemotePlugin&) = delete;
+    RemotePlugin& operator=(const RemotePlugin&) = delete;
+
+    /**
+     * @brief Spawn a plugin process and load a plugin in it
+     *
+     * Stops a previously started process first.
+     *
+     * @param pluginPath Path to the plugin library
+     * @param options Executable and timeout
+     * @return true once the plugin process reports that onLoad() succeeded
+     */
+    bool start(const std::string& pluginPath,
+               const RemotePluginOptions& options = RemotePluginOptions());
+
+    /**
+     * @brief Unload the plugin and wait for its process to exit
+     *
+     * A process that does not exit within the timeout is killed.
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the plugin process is up
+     * @return false before start(), after stop() or once the process died
+     */
+    bool isRunning() const { return m_pid > 0; }
+
+    /**
+     * @brief Call onUpdate() in the plugin process and wait for it to return
+     * @param deltaTime Time elapsed since last update in seconds
+     * @return false if the process is not running, crashed or timed out
+     */
+    bool update(float deltaTime);
+
+    /**
+     * @brief Query a value through the plugin's function table
+     * @param key Value key, usually fnv1a64() of a name
+     * @param buffer Receives the value
+     * @param size Size of the buffer
+     * @return Bytes written, 0 if the key is unknown, the plugin has no query entry
+     *         point, the value does not fit or the call failed
+     */
+    size_t query(uint64_t key, void* buffer, size_t size);
+
+    /**
+     * @brief Get the name the plugin reported
+     * @return Plugin name, empty if not running
+     */
+    const std::string& getName() const { return m_name; }
+
+    /**
+     * @brief Get the version the plugin reported
+     * @return Plugin version
+     */
+    Version getVersion() const { return m_version; }
+
+    /**
+     * @brief Get the description the plugin reported
+     * @return Plugin description, empty if not running
+     */
+    const std::string& getDescription() const { return m_description; }
+
+    /**
+     * @brief Get the process ID of the plugin process
+     * @return Process ID, 0 if not running
+     */
+    int getProcessId() const { return m_pid; }
+
+  private:
+    detail::RemoteChannel* m_channel = nullptr;
+    int m_pid = 0;
+    // Write end of the pipe whose end-of-file tells the plugin process the host is gone
+    int m_hostPipe = -1;
+    uint32_t m_sequence = 0;
+    std::chrono::milliseconds m_timeout{2000};
+    std::string m_name;
+    Version m_version;
+    std::string m_description;
+
+    /**
+     * @brief Send a request and wait for its reply
+     * @return false if the process died, stopped reading or did not answer in time; it is
+     *         reaped and released then
+     */
+    bool call(detail::RemoteMessage& message);
+
+    /**
+     * @brief Wait for the reply with a given sequence, watching the process
+     */
+    bool awaitReply(uint32_t sequence, detail::RemoteMessage& reply);
+
+    /**
+     * @brief Reap the plugin process if it exited
+     * @return true if it is gone
+     */
+    bool reapIfExited();
+
+    /**
+     * @brief Kill and reap the plugin process, then release its resources
+     */
+    void killProcess();
+
+    void releaseProcess();
+};
+
+} // namespace hotplugpp
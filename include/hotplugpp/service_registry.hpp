@@ -0,0 +1,257 @@
+#pragma once
+
+#include "hash.hpp"
+#include "i_plugin.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace hotplugpp {
+
+/**
+ * @brief Compute the ID of a service interface at compile time
+ *
+ * Only the major version takes part: interfaces stay compatible while they
+ * only grow within a major version, so a consumer built against 1.2 finds a
+ * provider built against 1.3, and never one built against 2.0.
+ *
+ * @param name Interface name, unique in the process
+ * @param version Interface version
+ * @return fnv1a64 of the name and major version
+ */
+constexpr uint64_t serviceId(std::string_view name, const Version& version) {
+    uint64_t hash = fnv1a64(name);
+    for (int shift = 0; shift < 32; shift += 8) {
+        hash ^= static_cast<uint8_t>(version.major >> shift);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Registry entry of one service ID; lives as long as the registry
+ */
+struct ServiceSlot {
+    explicit ServiceSlot(uint64_t serviceId) : id(serviceId) {}
+
+    const uint64_t id;
+    /// Current implementation, nullptr while no plugin provides it
+    std::atomic<void*> service{nullptr};
+    /// Bumped whenever the implementation changes
+    std::atomic<uint32_t> generation{0};
+    /// Plugin instance that provided the implementation; guarded by the registry
+    const IPlugin* owner = nullptr;
+    /// Implementation it replaced, restored if the replacement is revoked first, as when a
+    /// reloaded build fails after providing; guarded by the registry
+    void* previousService = nullptr;
+    const IPlugin* previousOwner = nullptr;
+};
+
+/**
+ * @brief Cached binding to a service
+ *
+ * Resolving is a single atomic load of the registry slot, with no lookup.
+ * The registry rebinds the slot when the providing plugin is reloaded and
+ * clears it when the plugin is unloaded, so get() must be checked for
+ * nullptr and not be kept across frames.
+ *
+ * @tparam T Service interface declared with HOTPLUGPP_SERVICE()
+ */
+template <typename T>
+class ServiceRef {
+  public:
+    ServiceRef() = default;
+    explicit ServiceRef(const ServiceSlot* slot) : m_slot(slot) {}
+
+    /**
+     * @brief Get the current implementation
+     * @return Service, or nullptr if none is provided
+     */
+    T* get() const {
+        return m_slot ? static_cast<T*>(m_slot->service.load(std::memory_order_acquire))
+                      : nullptr;
+    }
+
+    T* operator->() const { return get(); }
+
+    explicit operator bool() const { return get() != nullptr; }
+
+    /**
+     * @brief Get a counter that changes whenever the implementation is replaced
+     *
+     * Lets consumers refresh state derived from the previous implementation.
+     *
+     * @return Generation of the binding
+     */
+    uint32_t getGeneration() const {
+        return m_slot ? m_slot->generation.load(std::memory_order_acquire) : 0;
+    }
+
+  private:
+    const ServiceSlot* m_slot = nullptr;
+};
+
+/**
+ * @brief Host-owned directory of services that plugins provide to each other
+ *
+ * Services are interfaces declared with HOTPLUGPP_SERVICE() and looked up by
+ * their compile-time ID, never by name. A plugin provides an implementation
+ * in onLoad(); consumers find() a ServiceRef once and resolve it on every
+ * use. The host revokes everything an instance provided before it is
+ * unloaded, and a reloaded build providing again rebinds every cached
+ * ServiceRef. Like the MessageBus, the registry is header-only because
+ * plugins do not link the host library.
+ *
+ * provide(), find() and revoke() take a lock; ServiceRef::get() does not.
+ */
+class ServiceRegistry {
+  public:
+    ServiceRegistry() = default;
+
+    // Disable copy
+    ServiceRegistry(const ServiceRegistry&) = delete;
+    ServiceRegistry& operator=(const ServiceRegistry&) = delete;
+
+    /**
+     * @brief Publish an implementation of a service
+     *
+     * Replaces the current implementation, so the new build of a reloading
+     * plugin takes over before the old one is unloaded.
+     *
+     * @tparam T Service interface
+     * @param owner Providing plugin instance, whose unload revokes the service
+     * @param service Implementation, must stay valid until revoked
+     * @return false if service is null
+     */
+    template <typename T>
+    bool provide(const IPlugin* owner, T* service) {
+        if (!service) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ServiceSlot& slot = slotFor(T::SERVICE_ID);
+        if (slot.owner != owner) {
+            slot.previousService = slot.service.load(std::memory_order_relaxed);
+            slot.previousOwner = slot.owner;
+        }
+        bind(slot, owner, static_cast<void*>(service));
+        return true;
+    }
+
+    /**
+     * @brief Bind to a service, whether or not it is provided yet
+     *
+     * Takes a lock; call it once, e.g. in onLoad(), and keep the result.
+     *
+     * @tparam T Service interface
+     * @return Binding that follows the current implementation
+     */
+    template <typename T>
+    ServiceRef<T> find() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return ServiceRef<T>(&slotFor(T::SERVICE_ID));
+    }
+
+    /**
+     * @brief Withdraw every service an instance still provides
+     *
+     * Called by the host before the instance is unloaded. Services another
+     * instance has taken over are left alone; services it took over from
+     * another instance fall back to that one.
+     *
+     * @param owner Plugin instance
+     * @return Number of services withdrawn
+     */
+    size_t revoke(const IPlugin* owner) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t revoked = 0;
+        for (auto& entry : m_slots) {
+            ServiceSlot& slot = *entry.second;
+            if (slot.previousOwner == owner) {
+                slot.previousService = nullptr;
+                slot.previousOwner = nullptr;
+            }
+            if (slot.owner != owner || !slot.service.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            bind(slot, slot.previousOwner, slot.previousService);
+            slot.previousService = nullptr;
+            slot.previousOwner = nullptr;
+            ++revoked;
+        }
+        return revoked;
+    }
+
+    /**
+     * @brief Get the number of services currently provided
+     * @return Provided service count
+     */
+    size_t getServiceCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t count = 0;
+        for (const auto& entry : m_slots) {
+            if (entry.second->service.load(std::memory_order_relaxed)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+  private:
+    static void bind(ServiceSlot& slot, const IPlugin* owner, void* service) {
+        slot.owner = owner;
+        slot.service.store(service, std::memory_order_release);
+        slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    ServiceSlot& slotFor(uint64_t id) {
+        std::unique_ptr<ServiceSlot>& slot = m_slots[id];
+        if (!slot) {
+            slot = std::make_unique<ServiceSlot>(id);
+        }
+        return *slot;
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<ServiceSlot>> m_slots;
+};
+
+} // namespace hotplugpp
+
+extern "C" {
+typedef void (*AttachServiceRegistryFunc)(hotplugpp::ServiceRegistry* registry);
+}
+
+/**
+ * Declare a service interface
+ *
+ * Use inside the interface class; computes its ID at compile time:
+ *
+ *     class IMathService {
+ *       public:
+ *         HOTPLUGPP_SERVICE("IMathService", 1, 0)
+ *         virtual uint64_t fibonacci(size_t index) = 0;
+ *     };
+ */
+#define HOTPLUGPP_SERVICE(Name, Major, Minor) \
+    static constexpr hotplugpp::Version SERVICE_VERSION{Major, Minor, 0}; \
+    static constexpr uint64_t SERVICE_ID = hotplugpp::serviceId(Name, SERVICE_VERSION);
+
+/**
+ * Receive the host's ServiceRegistry in a plugin library
+ *
+ * Use once per library, next to HOTPLUGPP_CREATE_PLUGIN. Defines
+ * `hotplugppServiceRegistry`, which the host sets before every onLoad() of
+ * an instance of this library, and leaves null if it has no registry.
+ */
+#define HOTPLUGPP_USE_SERVICE_REGISTRY() \
+    static hotplugpp::ServiceRegistry* hotplugppServiceRegistry = nullptr; \
+    HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void hotplugppAttachServiceRegistry( \
+        hotplugpp::ServiceRegistry* registry) { \
+        hotplugppServiceRegistry = registry; \
+    }
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+
+// Platform-specific includes
+#ifdef _WIN32
+#include <windows.h>
+typedef HMODULE LibraryHandle;
+#else
+#include <dlfcn.h>
+typedef void* LibraryHandle;
+#endif
+
+namespace hotplugpp {
+
+/**
+ * @brief When the dynamic loader resolves a library's function references
+ */
+enum class SymbolBinding {
+    /// Resolve everything while loading (RTLD_NOW); missing symbols fail the load
+    Now,
+    /// Resolve each function on its first call (RTLD_LAZY); a missing symbol aborts at
+    /// that call. Windows binds imports at load time regardless.
+    Lazy,
+};
+
+/**
+ * @brief Load a shared library
+ * @param path Library path
+ * @param binding When to resolve the library's function references
+ * @return Library handle or nullptr on failure
+ */
+LibraryHandle loadLibrary(const std::string& path, SymbolBinding binding = SymbolBinding::Now);
+
+/**
+ * @brief Unload a shared library
+ * @param handle Library handle
+ */
+void unloadLibrary(LibraryHandle handle);
+
+/**
+ * @brief Get a function pointer from a library
+ * @param handle Library handle
+ * @param name Function name
+ * @return Function pointer or nullptr on failure
+ */
+void* getFunction(LibraryHandle handle, const std::string& name);
+
+/**
+ * @brief Get the last error message from dynamic library loading
+ * @return Error message string
+ */
+std::string getLastError();
+
+} // namespace hotplugpp
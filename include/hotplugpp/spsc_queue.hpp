@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace hotplugpp {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer
+ *
+ * One thread may push and one other thread may pop concurrently without
+ * locks or allocation. Producer and consumer indices live on separate cache
+ * lines to avoid false sharing.
+ *
+ * @tparam T Element type, must be default constructible and copy/move assignable
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+  public:
+    SpscQueue() = default;
+
+    // Disable copy
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Push an element (producer thread only)
+     * @param value Element to push
+     * @return false if the queue is full
+     */
+    bool tryPush(const T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) {
+                return false;
+            }
+        }
+        m_slots[tail & MASK] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element (consumer thread only)
+     * @param value Receives the element
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head & MASK]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Check whether the queue is empty (consumer thread only)
+     * @return true if there is nothing to pop
+     */
+    bool isEmpty() const {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of slots
+     * @return Queue capacity
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+  private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Consumer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+
+    alignas(CACHE_LINE) T m_slots[Capacity];
+};
+
+} // namespace hotplugpp
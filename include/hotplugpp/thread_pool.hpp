@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+
+/**
+ * @brief Fixed-size pool of worker threads executing submitted tasks in FIFO order
+ */
+class ThreadPool {
+  public:
+    /**
+     * @brief Start the worker threads
+     * @param threadCount Number of workers, 0 to use the hardware concurrency
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Finish all queued tasks and join the workers
+     */
+    ~ThreadPool();
+
+    // Disable copy
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution
+     *
+     * Tasks may submit further tasks; wait() covers those as well.
+     *
+     * @param task Task to run on a worker thread
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Block until the queue is empty and no task is running
+     */
+    void wait();
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker count
+     */
+    size_t getThreadCount() const;
+
+  private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    size_t m_activeTasks = 0;
+    bool m_stopping = false;
+
+    void workerLoop();
+};
+
+} // namespace hotplugpp
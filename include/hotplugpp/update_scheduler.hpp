@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+
+/**
+ * @brief Resources one update task reads and writes
+ *
+ * Resources are identified by 64-bit IDs, typically fnv1a64() of a name.
+ * Two tasks conflict if one writes a resource the other reads or writes;
+ * conflicting tasks run in declaration order, everything else may run in
+ * parallel.
+ */
+struct UpdateAccess {
+    std::vector<uint64_t> reads;
+    std::vector<uint64_t> writes;
+    /// Conflicts with every other task, for plugins that did not declare their access
+    bool exclusive = false;
+};
+
+/**
+ * @brief Work counters of one scheduler worker
+ */
+struct SchedulerWorkerStats {
+    /// Tasks the worker ran
+    uint64_t executed = 0;
+    /// Tasks it took from another worker's queue
+    uint64_t stolen = 0;
+};
+
+/**
+ * @brief Runs a dependency graph of update tasks on a work-stealing thread pool
+ *
+ * build() turns the declared read/write access of each task into a DAG;
+ * run() then executes every task once per call, starting a task as soon as
+ * all tasks it depends on have finished. Every worker owns a queue: it pushes
+ * the tasks it unblocks onto its own queue and pops them LIFO, which keeps
+ * dependent tasks on a warm cache, and idle workers steal the oldest task
+ * from a random other queue.
+ *
+ * The thread calling run() is worker 0, so a scheduler with one thread runs
+ * everything inline without any synchronization.
+ */
+class UpdateScheduler {
+  public:
+    /// Called once per task and run with the task index
+    using TaskFunc = std::function<void(uint32_t task)>;
+
+    /**
+     * @brief Start the worker threads
+     * @param threadCount Workers including the caller of run(), 0 for the hardware concurrency
+     */
+    explicit UpdateScheduler(size_t threadCount = 0);
+
+    /**
+     * @brief Stop and join the worker threads
+     */
+    ~UpdateScheduler();
+
+    // Disable copy
+    UpdateScheduler(const UpdateScheduler&) = delete;
+    UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+
+    /**
+     * @brief Build the dependency graph
+     *
+     * Task i depends on every earlier task it conflicts with (read after
+     * write, write after read, write after write). Must not be called while
+     * run() is executing.
+     *
+     * @param accesses Access declaration of each task, in declaration order
+     */
+    void build(const std::vector<UpdateAccess>& accesses);
+
+    /**
+     * @brief Run every task once and wait for all of them to finish
+     *
+     * @param func Task body; called concurrently for independent tasks and must not throw
+     */
+    void run(const TaskFunc& func);
+
+    /**
+     * @brief Get the number of tasks in the graph
+     * @return Task count
+     */
+    size_t getTaskCount() const { return m_dependencyCounts.size(); }
+
+    /**
+     * @brief Get the tasks a task waits for
+     * @param task Task index
+     * @return Indices of its direct dependencies, ascending
+     */
+    std::vector<uint32_t> getDependencies(uint32_t task) const;
+
+    /**
+     * @brief Get the length of the longest dependency chain
+     *
+     * No thread count can make a tick faster than running this many tasks
+     * one after another.
+     *
+     * @return Number of tasks on the critical path
+     */
+    size_t getCriticalPathLength() const { return m_criticalPathLength; }
+
+    /**
+     * @brief Get the number of workers, including the caller of run()
+     * @return Worker count
+     */
+    size_t getThreadCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Get the work counters of one worker
+     * @param worker Worker index, 0 is the caller of run()
+     * @return Counters accumulated since construction or resetStats()
+     */
+    SchedulerWorkerStats getWorkerStats(size_t worker) const;
+
+    /**
+     * @brief Reset all worker counters
+     */
+    void resetStats();
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    /// Task queue of one worker; the owner works at the back, thieves at the front
+    struct alignas(CACHE_LINE) Worker {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        std::vector<uint32_t> tasks;
+        size_t head = 0;
+        size_t tail = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint32_t random = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    // Graph in compressed sparse row form
+    std::vector<uint32_t> m_dependencyCounts;
+    std::vector<uint32_t> m_dependentOffsets;
+    std::vector<uint32_t> m_dependents;
+    std::vector<uint32_t> m_roots;
+    size_t m_criticalPathLength = 0;
+
+    // Per-run state
+    std::unique_ptr<std::atomic<uint32_t>[]> m_pending;
+    const TaskFunc* m_func = nullptr;
+    alignas(CACHE_LINE) std::atomic<size_t> m_remaining{0};
+    /// Background workers that have not finished the current run yet
+    alignas(CACHE_LINE) std::atomic<size_t> m_active{0};
+
+    // Wakes the background workers for a new run
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<uint64_t> m_runGeneration{0};
+    std::atomic<bool> m_stopping{false};
+
+    void workerLoop(size_t index);
+    void work(size_t index);
+    void push(Worker& worker, uint32_t task);
+    bool pop(Worker& worker, uint32_t& task);
+    bool steal(size_t thief, uint32_t& task);
+    void execute(size_t index, uint32_t task);
+};
+
+} // namespace hotplugpp
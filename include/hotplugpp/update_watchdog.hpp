@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hotplugpp {
+
+/**
+ * @brief Background thread that reports calls running longer than a hard limit
+ *
+ * Callers mark the start and end of each watched call in a slot of their
+ * own, which costs one clock read and two relaxed stores. The watchdog
+ * thread scans the slots a few times per limit and reports every call that
+ * has been running for longer than the limit, once per call. It cannot
+ * interrupt the call; a plugin stuck in an infinite loop stays stuck, but
+ * the host learns which one it is while it happens.
+ *
+ * Slots are typically the rows of a table being updated. The callback runs
+ * on the watchdog thread while the call it reports is still running.
+ */
+class UpdateWatchdog {
+  public:
+    /// Called with the slot of the stalled call and how long it has been running
+    using StallCallback = std::function<void(uint32_t slot, std::chrono::nanoseconds elapsed)>;
+
+    UpdateWatchdog();
+
+    /**
+     * @brief Stop the watchdog thread
+     */
+    ~UpdateWatchdog();
+
+    // Disable copy
+    UpdateWatchdog(const UpdateWatchdog&) = delete;
+    UpdateWatchdog& operator=(const UpdateWatchdog&) = delete;
+
+    /**
+     * @brief Start watching, replacing a previous limit and callback
+     * @param limit Longest a call may run before it is reported
+     * @param callback Called on the watchdog thread for each stalled call
+     * @return false if the limit is not positive
+     */
+    bool start(std::chrono::nanoseconds limit, StallCallback callback);
+
+    /**
+     * @brief Stop watching and join the thread
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the watchdog thread is running
+     * @return true if started
+     */
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Get the hard limit
+     * @return Limit passed to start()
+     */
+    std::chrono::nanoseconds getLimit() const { return m_limit; }
+
+    /**
+     * @brief Set the number of slots
+     *
+     * Must not be called while a watched call is running. Existing slots
+     * are reset.
+     *
+     * @param count Slot count
+     */
+    void resize(size_t count);
+
+    /**
+     * @brief Get the number of slots
+     * @return Slot count
+     */
+    size_t size() const { return m_slotCount; }
+
+    /**
+     * @brief Mark the start of a watched call
+     * @param slot Slot in [0, size()), used by one call at a time
+     */
+    void begin(uint32_t slot) {
+        m_slots[slot].start.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Mark the end of a watched call
+     * @param slot Slot passed to begin()
+     */
+    void end(uint32_t slot) { m_slots[slot].start.store(0, std::memory_order_release); }
+
+    /**
+     * @brief Wait for a running scan to finish
+     *
+     * A callback may look at whatever the reported slot stands for; calling
+     * this after the watched calls ended makes sure none is still doing so
+     * before that data changes.
+     */
+    void quiesce() { std::lock_guard<std::mutex> lock(m_scanMutex); }
+
+    /**
+     * @brief Get the number of stalled calls reported so far
+     * @return Stall count
+     */
+    uint64_t getStallCount() const { return m_stallCount.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    /// Written by whichever thread runs the call, so each slot gets its own cache line
+    struct alignas(CACHE_LINE) Slot {
+        /// Steady clock ticks at begin(), 0 while idle
+        std::atomic<int64_t> start{0};
+        /// start of the last call reported, so every call is reported once
+        int64_t reported = 0;
+    };
+
+    void run();
+
+    /**
+     * @brief Report every slot that exceeded the limit
+     */
+    void scan();
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_slotCount = 0;
+    std::chrono::nanoseconds m_limit{0};
+    StallCallback m_callback;
+    std::atomic<uint64_t> m_stallCount{0};
+
+    /// Held for a whole scan and by resize()
+    std::mutex m_scanMutex;
+    // Wakes the thread early to stop it
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+} // namespace hotplugpp
@@ -0,0 +1,110 @@
+#include "hotplugpp/arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace hotplugpp {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 32;
+static_assert(HEADER_SIZE % alignof(std::max_align_t) == 0, "chunk data must stay aligned");
+
+char* alignUp(char* ptr, size_t alignment) {
+    uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+    return ptr + ((alignment - value % alignment) % alignment);
+}
+
+void* arenaAllocate(void* context, size_t size, size_t alignment) {
+    return static_cast<Arena*>(context)->allocate(size, alignment);
+}
+
+void arenaDeallocate(void* context, void* ptr, size_t size) {
+    static_cast<Arena*>(context)->deallocate(ptr, size);
+}
+
+} // namespace
+
+Arena::Arena(size_t chunkSize)
+    : m_nextChunkSize(std::max<size_t>(chunkSize, HEADER_SIZE * 2)) {
+    m_allocator.context = this;
+    m_allocator.allocate = &arenaAllocate;
+    m_allocator.deallocate = &arenaDeallocate;
+}
+
+Arena::~Arena() {
+    release();
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+
+    char* start = m_top ? alignUp(m_top, alignment) : nullptr;
+    if (!start || start > m_end || static_cast<size_t>(m_end - start) < size) {
+        if (!addChunk(size + alignment)) {
+            return nullptr;
+        }
+        start = alignUp(m_top, alignment);
+    }
+
+    m_last = start;
+    m_top = start + size;
+    m_bytesUsed += size;
+    return start;
+}
+
+void Arena::deallocate(void* ptr, size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    char* start = static_cast<char*>(ptr);
+    if (start && start == m_last && start + size == m_top) {
+        m_top = start;
+        m_last = nullptr;
+        m_bytesUsed -= size;
+    }
+}
+
+void Arena::release() {
+    Chunk* chunk = m_chunks;
+    while (chunk) {
+        Chunk* next = chunk->next;
+        std::free(chunk);
+        chunk = next;
+    }
+    m_chunks = nullptr;
+    m_top = nullptr;
+    m_end = nullptr;
+    m_last = nullptr;
+    m_bytesUsed = 0;
+    m_bytesReserved = 0;
+    m_chunkCount = 0;
+}
+
+bool Arena::addChunk(size_t minSize) {
+    size_t size = std::max(m_nextChunkSize, minSize + HEADER_SIZE);
+    void* memory = std::malloc(size);
+    if (!memory) {
+        return false;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->next = m_chunks;
+    chunk->size = size;
+    m_chunks = chunk;
+    m_top = static_cast<char*>(memory) + HEADER_SIZE;
+    m_end = static_cast<char*>(memory) + size;
+    m_last = nullptr;
+    m_bytesReserved += size;
+    m_chunkCount++;
+    m_nextChunkSize = std::min(m_nextChunkSize * 2, MAX_CHUNK_SIZE);
+    return true;
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,68 @@
+#include "hotplugpp/file_stamp.hpp"
+
+#include "hotplugpp/hash.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace hotplugpp {
+
+FileStamp getFileStamp(const std::string& path) {
+    FileStamp stamp;
+#ifdef _WIN32
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return stamp;
+    }
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return stamp;
+    }
+    stamp.modifiedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           modified.time_since_epoch())
+                           .count();
+    stamp.size = static_cast<uint64_t>(size);
+#else
+    struct stat statbuf;
+    if (stat(path.c_str(), &statbuf) != 0) {
+        return stamp;
+    }
+#ifdef __APPLE__
+    const struct timespec& modified = statbuf.st_mtimespec;
+#else
+    const struct timespec& modified = statbuf.st_mtim;
+#endif
+    stamp.modifiedNs = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    stamp.size = static_cast<uint64_t>(statbuf.st_size);
+    stamp.inode = static_cast<uint64_t>(statbuf.st_ino);
+    stamp.device = static_cast<uint64_t>(statbuf.st_dev);
+#endif
+    stamp.exists = true;
+    return stamp;
+}
+
+bool hashFileContents(const std::string& path, uint64_t& hash) {
+    // Read rather than mmap: a linker truncating the file mid-hash must not raise SIGBUS
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    std::vector<char> contents(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(contents.data(), size);
+    hash = xxhash64(contents.data(), static_cast<size_t>(file.gcount()));
+    return true;
+}
+
+} // namespace hotplugpp
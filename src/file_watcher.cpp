@@ -0,0 +1,323 @@
+#include "hotplugpp/file_watcher.hpp"
+
+#include <filesystem>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace hotplugpp {
+
+namespace {
+
+int64_t modificationTicks(const std::string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/**
+ * @brief Spell a directory the same way however the caller wrote it
+ *
+ * inotify hands out one watch descriptor per directory inode, so aliases such
+ * as "plugins" and "./plugins" must share one watch entry.
+ */
+std::string normalizeDirectory(const std::filesystem::path& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path normalized = fs::weakly_canonical(directory.empty() ? "." : directory, ec);
+    if (ec) {
+        normalized = fs::absolute(directory.empty() ? "." : directory, ec).lexically_normal();
+    }
+    return ec ? directory.string() : normalized.string();
+}
+
+} // namespace
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+uint32_t FileWatcher::watchFile(const std::string& path) {
+    std::filesystem::path fsPath(path);
+    WatchedFile file;
+    file.path = path;
+    file.directory = normalizeDirectory(fsPath.parent_path());
+    file.fileName = fsPath.filename().string();
+    file.lastModified = modificationTicks(path);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_inotifyFd >= 0 && !addDirectoryWatch(file.directory)) {
+        return INVALID_FILE_ID;
+    }
+
+    uint32_t fileId = m_nextFileId++;
+    m_files.emplace(fileId, std::move(file));
+    return fileId;
+}
+
+void FileWatcher::unwatchFile(uint32_t fileId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_files.find(fileId);
+    if (it == m_files.end()) {
+        return;
+    }
+    std::string directory = it->second.directory;
+    m_files.erase(it);
+    removeDirectoryWatchIfUnused(directory);
+}
+
+bool FileWatcher::start() {
+    if (m_running) {
+        return true;
+    }
+    m_stopRequested = false;
+
+#ifdef __linux__
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inotifyFd >= 0 && m_wakeFd >= 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_files) {
+            addDirectoryWatch(entry.second.directory);
+        }
+        m_running = true;
+        m_thread = std::thread([this]() { runNative(); });
+        return true;
+    }
+
+    // inotify unavailable (e.g. watch limit reached), fall back to polling
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+#endif
+
+    m_running = true;
+    m_thread = std::thread([this]() { runPolling(); });
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (!m_running) {
+        return;
+    }
+
+    m_stopRequested = true;
+#ifdef __linux__
+    if (m_wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+#endif
+    m_thread.join();
+    m_running = false;
+
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    m_directoryWatches.clear();
+    m_watchDirectories.clear();
+#endif
+}
+
+bool FileWatcher::isRunning() const {
+    return m_running;
+}
+
+bool FileWatcher::isUsingNativeEvents() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_inotifyFd >= 0;
+}
+
+void FileWatcher::setPollInterval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pollInterval = interval;
+}
+
+bool FileWatcher::pollEvent(FileEvent& event) {
+    // Lost events trump everything still queued: the consumer rescans anyway
+    if (m_overflowed.load(std::memory_order_relaxed) && m_overflowed.exchange(false)) {
+        event.fileId = INVALID_FILE_ID;
+        event.type = FileEventType::Overflow;
+        return true;
+    }
+    return m_events.tryPop(event);
+}
+
+void FileWatcher::post(uint32_t fileId, FileEventType type) {
+    FileEvent event;
+    event.fileId = fileId;
+    event.type = type;
+    if (!m_events.tryPush(event)) {
+        m_overflowed.store(true, std::memory_order_release);
+    }
+}
+
+void FileWatcher::runNative() {
+#ifdef __linux__
+    // Large enough for many events; inotify never splits a single event
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    std::vector<std::pair<uint32_t, FileEventType>> pending;
+
+    while (!m_stopRequested) {
+        struct pollfd fds[2];
+        fds[0].fd = m_inotifyFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = m_wakeFd;
+        fds[1].events = POLLIN;
+
+        if (poll(fds, 2, -1) <= 0 || (fds[1].revents & POLLIN)) {
+            continue;
+        }
+
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            continue;
+        }
+
+        pending.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (char* ptr = buffer; ptr < buffer + length;) {
+                auto* event = reinterpret_cast<struct inotify_event*>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    m_overflowed.store(true, std::memory_order_release);
+                    continue;
+                }
+                if (event->len == 0) {
+                    continue;
+                }
+
+                FileEventType type;
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    type = FileEventType::Removed;
+                } else if (event->mask & IN_MOVED_TO) {
+                    type = FileEventType::Created;
+                } else {
+                    type = FileEventType::Modified;
+                }
+
+                auto dir = m_watchDirectories.find(event->wd);
+                if (dir == m_watchDirectories.end()) {
+                    continue;
+                }
+                for (const auto& entry : m_files) {
+                    if (entry.second.directory == dir->second &&
+                        entry.second.fileName == event->name) {
+                        pending.emplace_back(entry.first, type);
+                    }
+                }
+            }
+        }
+
+        for (const auto& event : pending) {
+            post(event.first, event.second);
+        }
+    }
+#endif
+}
+
+void FileWatcher::runPolling() {
+    std::vector<std::pair<uint32_t, FileEventType>> pending;
+
+    while (!m_stopRequested) {
+        std::chrono::milliseconds interval;
+        pending.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            interval = m_pollInterval;
+            for (auto& entry : m_files) {
+                int64_t modified = modificationTicks(entry.second.path);
+                if (modified == entry.second.lastModified) {
+                    continue;
+                }
+
+                FileEventType type = FileEventType::Modified;
+                if (modified < 0) {
+                    type = FileEventType::Removed;
+                } else if (entry.second.lastModified < 0) {
+                    type = FileEventType::Created;
+                }
+                entry.second.lastModified = modified;
+                pending.emplace_back(entry.first, type);
+            }
+        }
+
+        for (const auto& event : pending) {
+            post(event.first, event.second);
+        }
+
+        // Sleep in small steps so stop() does not wait for a whole interval
+        auto wakeUp = std::chrono::steady_clock::now() + interval;
+        while (!m_stopRequested && std::chrono::steady_clock::now() < wakeUp) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+bool FileWatcher::addDirectoryWatch(const std::string& directory) {
+#ifdef __linux__
+    if (m_directoryWatches.count(directory)) {
+        return true;
+    }
+
+    // Close-after-write and renames mark complete files; IN_MODIFY would fire mid-write
+    const uint32_t mask =
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR;
+    int wd = inotify_add_watch(m_inotifyFd, directory.c_str(), mask);
+    if (wd < 0) {
+        return false;
+    }
+    m_directoryWatches[directory] = wd;
+    m_watchDirectories[wd] = directory;
+    return true;
+#else
+    (void)directory;
+    return true;
+#endif
+}
+
+void FileWatcher::removeDirectoryWatchIfUnused(const std::string& directory) {
+#ifdef __linux__
+    for (const auto& entry : m_files) {
+        if (entry.second.directory == directory) {
+            return;
+        }
+    }
+
+    auto it = m_directoryWatches.find(directory);
+    if (it == m_directoryWatches.end()) {
+        return;
+    }
+    if (m_inotifyFd >= 0) {
+        inotify_rm_watch(m_inotifyFd, it->second);
+    }
+    m_watchDirectories.erase(it->second);
+    m_directoryWatches.erase(it);
+#else
+    (void)directory;
+#endif
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,77 @@
+#include "hotplugpp/frame_pacer.hpp"
+
+#include <thread>
+
+namespace hotplugpp {
+
+void waitUntil(std::chrono::steady_clock::time_point deadline,
+               std::chrono::nanoseconds spinThreshold) {
+    using Clock = std::chrono::steady_clock;
+
+    auto remaining = deadline - Clock::now();
+    if (remaining > spinThreshold) {
+        std::this_thread::sleep_for(remaining - spinThreshold);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+FramePacer::FramePacer(const FramePacerConfig& config) : m_config(config) {
+    if (m_config.timestep.count() <= 0) {
+        m_config.timestep = FramePacerConfig().timestep;
+    }
+    if (m_config.maxCatchUpSteps == 0) {
+        m_config.maxCatchUpSteps = 1;
+    }
+}
+
+uint32_t FramePacer::beginFrame() {
+    if (m_started) {
+        waitUntil(m_nextDeadline, m_config.spinThreshold);
+    }
+    Clock::time_point now = Clock::now();
+    if (m_started) {
+        m_wakeLatency.record(now - m_nextDeadline);
+    }
+    return advance(now);
+}
+
+uint32_t FramePacer::advance(Clock::time_point now) {
+    m_frameCount++;
+    if (!m_started) {
+        m_started = true;
+        m_lastFrame = now;
+        m_accumulator = std::chrono::nanoseconds(0);
+        m_nextDeadline = now + m_config.timestep;
+        return 1;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastFrame);
+    m_frameTimes.record(elapsed);
+    m_lastFrame = now;
+    m_accumulator += elapsed;
+
+    uint64_t steps = static_cast<uint64_t>(m_accumulator / m_config.timestep);
+    m_accumulator -= m_config.timestep * steps;
+    if (steps > m_config.maxCatchUpSteps) {
+        m_droppedSteps += steps - m_config.maxCatchUpSteps;
+        steps = m_config.maxCatchUpSteps;
+    }
+
+    // The next step is due once the accumulator fills up, which keeps deadlines on the grid
+    m_nextDeadline = now + (m_config.timestep - m_accumulator);
+    return static_cast<uint32_t>(steps);
+}
+
+void FramePacer::reset() {
+    m_started = false;
+    m_accumulator = std::chrono::nanoseconds(0);
+    m_nextDeadline = Clock::time_point();
+    m_frameCount = 0;
+    m_droppedSteps = 0;
+    m_frameTimes.reset();
+    m_wakeLatency.reset();
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,103 @@
+#include "hotplugpp/hash.hpp"
+
+#include <cstring>
+
+namespace hotplugpp {
+
+namespace {
+
+constexpr uint64_t PRIME1 = 11400714785074694791ull;
+constexpr uint64_t PRIME2 = 14029467366897019727ull;
+constexpr uint64_t PRIME3 = 1609587929392839161ull;
+constexpr uint64_t PRIME4 = 9650029242287828579ull;
+constexpr uint64_t PRIME5 = 2870177450012600261ull;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian loads; memcpy keeps unaligned access well-defined
+inline uint64_t read64(const uint8_t* ptr) {
+    uint64_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const uint8_t* ptr) {
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline uint64_t mixLane(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t hash, uint64_t lane) {
+    hash ^= mixLane(0, lane);
+    return hash * PRIME1 + PRIME4;
+}
+
+} // namespace
+
+uint64_t xxhash64(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = ptr + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        // Four independent accumulators let the CPU overlap the multiplies
+        uint64_t lane1 = seed + PRIME1 + PRIME2;
+        uint64_t lane2 = seed + PRIME2;
+        uint64_t lane3 = seed;
+        uint64_t lane4 = seed - PRIME1;
+
+        const uint8_t* const limit = end - 32;
+        do {
+            lane1 = mixLane(lane1, read64(ptr));
+            lane2 = mixLane(lane2, read64(ptr + 8));
+            lane3 = mixLane(lane3, read64(ptr + 16));
+            lane4 = mixLane(lane4, read64(ptr + 24));
+            ptr += 32;
+        } while (ptr <= limit);
+
+        hash = rotateLeft(lane1, 1) + rotateLeft(lane2, 7) + rotateLeft(lane3, 12) +
+               rotateLeft(lane4, 18);
+        hash = mergeRound(hash, lane1);
+        hash = mergeRound(hash, lane2);
+        hash = mergeRound(hash, lane3);
+        hash = mergeRound(hash, lane4);
+    } else {
+        hash = seed + PRIME5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    while (ptr + 8 <= end) {
+        hash ^= mixLane(0, read64(ptr));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+        ptr += 8;
+    }
+    if (ptr + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(ptr)) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        ptr += 4;
+    }
+    while (ptr < end) {
+        hash ^= (*ptr) * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+        ++ptr;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,59 @@
+#include "hotplugpp/latency_histogram.hpp"
+
+#include <algorithm>
+
+namespace hotplugpp {
+
+std::chrono::nanoseconds LatencyHistogram::getPercentile(double fraction) const {
+    const uint64_t count = getCount();
+    if (count == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(count) + 0.5));
+
+    // Buckets are read one by one while writers may be active; the result is approximate
+    uint64_t seen = 0;
+    const uint64_t max = m_max.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(std::min(bucketUpperBound(i), max));
+        }
+    }
+    return std::chrono::nanoseconds(max);
+}
+
+LatencyStats LatencyHistogram::getStats() const {
+    LatencyStats stats;
+    stats.count = getCount();
+    stats.p50 = getPercentile(0.50);
+    stats.p99 = getPercentile(0.99);
+    stats.max = getMax();
+    return stats;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+
+    const size_t offset = index - LINEAR_LIMIT;
+    const uint32_t exponent = static_cast<uint32_t>(offset / SUB_BUCKETS) + SUB_BUCKET_BITS + 1;
+    const uint64_t subBucket = offset % SUB_BUCKETS;
+    const uint64_t width = uint64_t(1) << (exponent - SUB_BUCKET_BITS);
+    const uint64_t lower = (uint64_t(1) << exponent) + subBucket * width;
+    return lower + (width - 1);
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,274 @@
+#include "library_cache.hpp"
+
+#include "hotplugpp/file_stamp.hpp"
+#include "hotplugpp/log.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+
+namespace hotplugpp {
+namespace detail {
+
+namespace {
+
+struct LibraryEntry {
+    std::string key;
+    std::string path;
+    LibraryHandle handle = nullptr;
+    LibraryExports exports;
+    size_t references = 0;
+    bool removeOnRelease = false;
+};
+
+struct LibraryCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<LibraryEntry>> byKey;
+    std::unordered_map<LibraryHandle, LibraryEntry*> byHandle;
+};
+
+LibraryCache& getCache() {
+    // Never destroyed: plugins held by static objects may be released during exit
+    static LibraryCache* cache = new LibraryCache();
+    return *cache;
+}
+
+/**
+ * @brief Fetch the optional function table of a library and check that this host can use it
+ * @param handle Library handle
+ * @param path Library path, for diagnostics
+ * @return Table, or nullptr if the library exports none or an incompatible one
+ */
+const HotPlugPPFunctionTable* resolveFunctionTable(LibraryHandle handle, const std::string& path) {
+    auto getTable =
+        reinterpret_cast<GetFunctionTableFunc>(getFunction(handle, "getPluginFunctionTable"));
+    if (!getTable) {
+        return nullptr;
+    }
+
+    const HotPlugPPFunctionTable* table = getTable();
+    if (!table || table->version != HOTPLUGPP_FUNCTION_TABLE_VERSION ||
+        table->size < sizeof(HotPlugPPFunctionTable) || !table->update) {
+        logMessage(LogLevel::Warning, "Ignoring incompatible function table in: %s (version %u)",
+                   path.c_str(), table ? table->version : 0u);
+        return nullptr;
+    }
+    return table;
+}
+
+/**
+ * @brief Load a library and resolve its exports, without touching the cache
+ * @return Library handle, or nullptr on failure
+ */
+LibraryHandle openLibrary(const std::string& path, LibraryExports& exports, std::string& error,
+                          PhaseTimings* timings, SymbolBinding binding) {
+    LibraryHandle handle;
+    {
+        ScopedPhaseTimer timer(timings, LoadPhase::LoadLibrary);
+        handle = loadLibrary(path, binding);
+    }
+    if (!handle) {
+        error = getLastError();
+        logMessage(LogLevel::Error, "Failed to load library: %s (%s)", path.c_str(), error.c_str());
+        return nullptr;
+    }
+
+    LibraryExports resolved;
+    {
+        ScopedPhaseTimer timer(timings, LoadPhase::ResolveSymbols);
+        resolved.createFunc =
+            reinterpret_cast<CreatePluginFunc>(getFunction(handle, "createPlugin"));
+        resolved.destroyFunc =
+            reinterpret_cast<DestroyPluginFunc>(getFunction(handle, "destroyPlugin"));
+        // Optional; only looked up for valid plugins so a failure above reports its own error
+        if (resolved.createFunc && resolved.destroyFunc) {
+            auto getInterfaceVersion = reinterpret_cast<GetInterfaceVersionFunc>(
+                getFunction(handle, "hotplugppInterfaceVersion"));
+            // Plugins built before the export existed only have the original IPlugin functions
+            resolved.interfaceVersion = getInterfaceVersion ? getInterfaceVersion() : 1;
+            resolved.updateBatchFunc =
+                reinterpret_cast<UpdateBatchFunc>(getFunction(handle, "updatePluginBatch"));
+            resolved.functionTable = resolveFunctionTable(handle, path);
+            resolved.createWithAllocatorFunc = reinterpret_cast<CreatePluginWithAllocatorFunc>(
+                getFunction(handle, "createPluginWithAllocator"));
+            resolved.destroyWithAllocatorFunc = reinterpret_cast<DestroyPluginFunc>(
+                getFunction(handle, "destroyPluginWithAllocator"));
+            resolved.attachMessageBusFunc = reinterpret_cast<AttachMessageBusFunc>(
+                getFunction(handle, "hotplugppAttachMessageBus"));
+            resolved.attachServiceRegistryFunc = reinterpret_cast<AttachServiceRegistryFunc>(
+                getFunction(handle, "hotplugppAttachServiceRegistry"));
+        }
+    }
+
+    if (!resolved.createFunc || !resolved.destroyFunc) {
+        error = getLastError();
+        logMessage(LogLevel::Error, "Failed to find plugin factory functions in: %s (%s)",
+                   path.c_str(), error.c_str());
+        unloadLibrary(handle);
+        return nullptr;
+    }
+
+    if (resolved.interfaceVersion < HOTPLUGPP_INTERFACE_VERSION) {
+        logMessage(LogLevel::Warning,
+                   "Plugin built against interface version %u, newer IPlugin hooks are not "
+                   "called: %s",
+                   resolved.interfaceVersion, path.c_str());
+    }
+
+    exports = resolved;
+    return handle;
+}
+
+/**
+ * @brief Take a reference to an entry; the cache mutex must be held
+ */
+LibraryHandle share(LibraryEntry& entry, LibraryExports& exports, std::string& libraryPath) {
+    entry.references++;
+    exports = entry.exports;
+    libraryPath = entry.path;
+    return entry.handle;
+}
+
+} // namespace
+
+std::string getLibraryKey(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::canonical(path, ec);
+    if (ec) {
+        return path;
+    }
+    const FileStamp stamp = getFileStamp(canonical.string());
+    return canonical.string() + '|' + std::to_string(stamp.device) + ':' +
+           std::to_string(stamp.inode);
+}
+
+LibraryHandle acquireLibrary(const std::string& path, LibraryExports& exports, std::string& error,
+                             PhaseTimings* timings, SymbolBinding binding) {
+    std::string libraryPath;
+    return acquireLibrary(getLibraryKey(path), path, false, exports, libraryPath, error, timings,
+                          binding);
+}
+
+LibraryHandle acquireLibrary(const std::string& key, const std::string& path, bool removeOnRelease,
+                             LibraryExports& exports, std::string& libraryPath,
+                             std::string& error, PhaseTimings* timings, SymbolBinding binding) {
+    LibraryCache& cache = getCache();
+    const auto start = std::chrono::steady_clock::now();
+    LibraryHandle shared = findLibrary(key, exports, libraryPath);
+    if (shared) {
+        // A shared library costs a lookup; still reported so every instance has a load phase
+        if (timings) {
+            timings->record(LoadPhase::LoadLibrary, std::chrono::steady_clock::now() - start);
+        }
+        return shared;
+    }
+
+    // Load outside the lock so different libraries open in parallel
+    LibraryExports opened;
+    LibraryHandle handle = openLibrary(path, opened, error, timings, binding);
+    if (!handle) {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        // Another thread may have opened the same key, or the dynamic loader
+        // handed out an image that is already cached under another key
+        LibraryEntry* existing = nullptr;
+        auto byKey = cache.byKey.find(key);
+        if (byKey != cache.byKey.end()) {
+            existing = byKey->second.get();
+        } else {
+            auto byHandle = cache.byHandle.find(handle);
+            if (byHandle != cache.byHandle.end()) {
+                existing = byHandle->second;
+            }
+        }
+
+        if (!existing) {
+            auto entry = std::make_unique<LibraryEntry>();
+            entry->key = key;
+            entry->path = path;
+            entry->handle = handle;
+            entry->exports = opened;
+            entry->removeOnRelease = removeOnRelease;
+            existing = entry.get();
+            cache.byHandle[handle] = existing;
+            cache.byKey[key] = std::move(entry);
+            return share(*existing, exports, libraryPath);
+        }
+        shared = share(*existing, exports, libraryPath);
+    }
+
+    // Drop the extra reference the dynamic loader counted for this open
+    unloadLibrary(handle);
+    return shared;
+}
+
+LibraryHandle findLibrary(const std::string& key, LibraryExports& exports,
+                          std::string& libraryPath) {
+    LibraryCache& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.byKey.find(key);
+    if (it == cache.byKey.end()) {
+        return nullptr;
+    }
+    return share(*it->second, exports, libraryPath);
+}
+
+void releaseLibrary(LibraryHandle handle) {
+    if (!handle) {
+        return;
+    }
+
+    LibraryCache& cache = getCache();
+    std::unique_ptr<LibraryEntry> released;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.byHandle.find(handle);
+        if (it == cache.byHandle.end()) {
+            logMessage(LogLevel::Warning, "Releasing a library that is not in the cache");
+            return;
+        }
+        if (--it->second->references > 0) {
+            return;
+        }
+        auto entry = cache.byKey.find(it->second->key);
+        released = std::move(entry->second);
+        cache.byKey.erase(entry);
+        cache.byHandle.erase(it);
+    }
+
+    unloadLibrary(released->handle);
+    if (released->removeOnRelease) {
+        std::error_code ec;
+        std::filesystem::remove(released->path, ec);
+    }
+}
+
+size_t getLibraryReferenceCount(LibraryHandle handle) {
+    LibraryCache& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.byHandle.find(handle);
+    return it != cache.byHandle.end() ? it->second->references : 0;
+}
+
+size_t getLibraryReferenceCount(const std::string& path) {
+    const std::string key = getLibraryKey(path);
+    LibraryCache& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.byKey.find(key);
+    return it != cache.byKey.end() ? it->second->references : 0;
+}
+
+size_t getOpenLibraryCount() {
+    LibraryCache& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.byKey.size();
+}
+
+} // namespace detail
+} // namespace hotplugpp
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/message_bus.hpp"
+#include "hotplugpp/phase_timings.hpp"
+#include "hotplugpp/plugin_allocator.hpp"
+#include "hotplugpp/service_registry.hpp"
+#include "hotplugpp/shared_library.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace hotplugpp {
+namespace detail {
+
+/**
+ * @brief Entry points of a plugin library, resolved once when it is first opened
+ */
+struct LibraryExports {
+    CreatePluginFunc createFunc = nullptr;
+    DestroyPluginFunc destroyFunc = nullptr;
+    /// HOTPLUGPP_INTERFACE_VERSION the library was built against, 1 if it exports none
+    uint32_t interfaceVersion = 1;
+    /// Optional updatePluginBatch export
+    UpdateBatchFunc updateBatchFunc = nullptr;
+    /// Optional C function table, nullptr if incompatible with this host
+    const HotPlugPPFunctionTable* functionTable = nullptr;
+    /// Optional createPluginWithAllocator/destroyPluginWithAllocator pair
+    CreatePluginWithAllocatorFunc createWithAllocatorFunc = nullptr;
+    DestroyPluginFunc destroyWithAllocatorFunc = nullptr;
+    /// Optional hotplugppAttachMessageBus export
+    AttachMessageBusFunc attachMessageBusFunc = nullptr;
+    /// Optional hotplugppAttachServiceRegistry export
+    AttachServiceRegistryFunc attachServiceRegistryFunc = nullptr;
+};
+
+/**
+ * @brief Get the key a library file is shared under
+ *
+ * Canonical path plus device and inode, so relative paths and symlinks to
+ * the same file share one handle while a file replaced at the same path does not.
+ *
+ * @param path Library path
+ * @return Cache key
+ */
+std::string getLibraryKey(const std::string& path);
+
+/**
+ * @brief Open a plugin library, or share the one already open in this process
+ *
+ * The first reference pays for loading the library and resolving its
+ * exports; every further one is a map lookup. Each successful call must be
+ * paired with releaseLibrary(). Thread-safe.
+ *
+ * @param path Library path
+ * @param exports Receives the resolved entry points
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of the load and lookup phases, may be null
+ * @param binding Symbol binding if the library has to be opened; a shared library keeps the
+ *        binding it was first opened with
+ * @return Library handle, or nullptr if the library could not be loaded or is no plugin
+ */
+LibraryHandle acquireLibrary(const std::string& path, LibraryExports& exports, std::string& error,
+                             PhaseTimings* timings = nullptr,
+                             SymbolBinding binding = SymbolBinding::Now);
+
+/**
+ * @brief Open a library under a caller-chosen key, or share the one open under it
+ *
+ * Used for shadow copies, which are keyed by the file version they were
+ * copied from. If another thread opened a library under the same key first,
+ * that one is shared and @p libraryPath names its file instead of @p path.
+ *
+ * @param key Cache key
+ * @param path Library path, only opened if nothing is open under @p key
+ * @param removeOnRelease Delete the file at @p path once its last reference is released
+ * @param exports Receives the resolved entry points
+ * @param libraryPath Receives the path of the library that is actually shared
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of the load and lookup phases, may be null
+ * @param binding Symbol binding if the library has to be opened
+ * @return Library handle, or nullptr on failure
+ */
+LibraryHandle acquireLibrary(const std::string& key, const std::string& path, bool removeOnRelease,
+                             LibraryExports& exports, std::string& libraryPath,
+                             std::string& error, PhaseTimings* timings = nullptr,
+                             SymbolBinding binding = SymbolBinding::Now);
+
+/**
+ * @brief Share a library only if one is already open under a key
+ * @param key Cache key
+ * @param exports Receives the resolved entry points
+ * @param libraryPath Receives the path the library was opened from
+ * @return Library handle, or nullptr if nothing is open under @p key
+ */
+LibraryHandle findLibrary(const std::string& key, LibraryExports& exports,
+                          std::string& libraryPath);
+
+/**
+ * @brief Drop one reference; the last one closes the library
+ * @param handle Handle returned by acquireLibrary() or findLibrary()
+ */
+void releaseLibrary(LibraryHandle handle);
+
+/**
+ * @brief Get the number of references to a library, one per live plugin instance
+ * @param handle Library handle
+ * @return Reference count, 0 if the handle is not in the cache
+ */
+size_t getLibraryReferenceCount(LibraryHandle handle);
+
+/**
+ * @brief Get the number of references to the library file at a path
+ * @param path Library path
+ * @return Reference count, 0 if the file is not open
+ */
+size_t getLibraryReferenceCount(const std::string& path);
+
+/**
+ * @brief Get the number of distinct libraries in the cache
+ * @return Number of open libraries
+ */
+size_t getOpenLibraryCount();
+
+} // namespace detail
+} // namespace hotplugpp
@@ -0,0 +1,191 @@
+#include "hotplugpp/log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace hotplugpp {
+
+namespace {
+
+/// Messages are formatted on the stack; longer ones are truncated
+constexpr size_t FORMAT_BUFFER_SIZE = 512;
+
+std::atomic<ILogSink*> s_sink{nullptr};
+std::atomic<LogLevel> s_level{LogLevel::Info};
+
+AsyncLogSink* defaultSink() {
+    // Deliberately leaked so plugins unloaded by static destructors can still log;
+    // the exit handler delivers what is queued and switches to synchronous output
+    static AsyncLogSink* s_default = []() {
+        AsyncLogSink* sink = new AsyncLogSink();
+        std::atexit([]() { defaultSink()->stop(); });
+        return sink;
+    }();
+    return s_default;
+}
+
+} // namespace
+
+const char* toString(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:
+        return "Debug";
+    case LogLevel::Info:
+        return "Info";
+    case LogLevel::Warning:
+        return "Warning";
+    case LogLevel::Error:
+        return "Error";
+    case LogLevel::Off:
+        return "Off";
+    }
+    return "Unknown";
+}
+
+AsyncLogSink::AsyncLogSink() {
+    m_running = true;
+    m_thread = std::thread([this]() { run(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    stop();
+}
+
+void AsyncLogSink::write(LogLevel level, const char* message, size_t length) {
+    if (!m_running.load(std::memory_order_acquire)) {
+        print(level, message, length);
+        m_delivered.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    Record record;
+    record.level = level;
+    record.length = static_cast<uint8_t>(std::min(length, MAX_MESSAGE_LENGTH));
+    std::memcpy(record.text, message, record.length);
+    if (!m_queue.tryPush(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_written.fetch_add(1, std::memory_order_release);
+
+    // stop() may have drained the ring between the check above and the push; the
+    // fences order the push before this load and stop()'s store before its drain
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_running.load(std::memory_order_relaxed)) {
+        drain();
+        return;
+    }
+    m_wake.notify_one();
+}
+
+void AsyncLogSink::flush() {
+    const uint64_t target = m_written.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wake.notify_one();
+    m_drained.wait(lock, [this, target]() {
+        return m_delivered.load(std::memory_order_acquire) >= target ||
+               !m_running.load(std::memory_order_acquire);
+    });
+}
+
+void AsyncLogSink::stop() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_running.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Deliver anything that raced with the shutdown
+    drain();
+    m_drained.notify_all();
+}
+
+void AsyncLogSink::drain() {
+    Record record;
+    while (m_queue.tryPop(record)) {
+        print(record.level, record.text, record.length);
+        m_delivered.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void AsyncLogSink::run() {
+    Record record;
+    for (;;) {
+        bool delivered = false;
+        while (m_queue.tryPop(record)) {
+            print(record.level, record.text, record.length);
+            m_delivered.fetch_add(1, std::memory_order_release);
+            delivered = true;
+        }
+        if (delivered) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_drained.notify_all();
+        if (m_stopRequested) {
+            return;
+        }
+        // Producers notify without the lock, so a wakeup can be missed; the timeout bounds it
+        m_wake.wait_for(lock, std::chrono::milliseconds(50),
+                        [this]() { return m_stopRequested || !m_queue.isEmpty(); });
+    }
+}
+
+void AsyncLogSink::print(LogLevel level, const char* message, size_t length) {
+    std::FILE* stream = level >= LogLevel::Warning ? stderr : stdout;
+    std::fwrite(message, 1, length, stream);
+    std::fputc('\n', stream);
+}
+
+void setLogSink(ILogSink* sink) {
+    s_sink.store(sink, std::memory_order_release);
+}
+
+ILogSink* getLogSink() {
+    ILogSink* sink = s_sink.load(std::memory_order_acquire);
+    return sink ? sink : defaultSink();
+}
+
+void setLogLevel(LogLevel level) {
+    s_level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return s_level.load(std::memory_order_relaxed);
+}
+
+void logMessage(LogLevel level, const char* format, ...) {
+    if (level < s_level.load(std::memory_order_relaxed) || level == LogLevel::Off) {
+        return;
+    }
+
+    char buffer[FORMAT_BUFFER_SIZE];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+
+    getLogSink()->write(level, buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+}
+
+void flushLog() {
+    getLogSink()->flush();
+}
+
+} // namespace hotplugpp
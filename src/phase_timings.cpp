@@ -0,0 +1,33 @@
+#include "hotplugpp/phase_timings.hpp"
+
+namespace hotplugpp {
+
+const char* toString(LoadPhase phase) {
+    switch (phase) {
+    case LoadPhase::CopyLibrary:
+        return "CopyLibrary";
+    case LoadPhase::LoadLibrary:
+        return "LoadLibrary";
+    case LoadPhase::ResolveSymbols:
+        return "ResolveSymbols";
+    case LoadPhase::CreateInstance:
+        return "CreateInstance";
+    case LoadPhase::OnLoad:
+        return "OnLoad";
+    case LoadPhase::TransferState:
+        return "TransferState";
+    case LoadPhase::OnUnload:
+        return "OnUnload";
+    case LoadPhase::DestroyInstance:
+        return "DestroyInstance";
+    case LoadPhase::UnloadLibrary:
+        return "UnloadLibrary";
+    case LoadPhase::Reload:
+        return "Reload";
+    case LoadPhase::Count:
+        break;
+    }
+    return "Unknown";
+}
+
+} // namespace hotplugpp
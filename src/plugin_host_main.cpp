@@ -0,0 +1,156 @@
+/**
+ * @brief Plugin process spawned by RemotePlugin
+ *
+ * Usage: hotplugpp_plugin_host <plugin path>, with the shared RemoteChannel
+ * passed as file descriptor REMOTE_CHANNEL_FD and the read end of the host's
+ * liveness pipe as REMOTE_HOST_PIPE_FD. Loads the plugin with a
+ * PluginLoader, answers requests until the host asks it to shut down, and
+ * exits when the host dies.
+ */
+
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+#include "remote_channel.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace hotplugpp;
+using namespace hotplugpp::detail;
+
+#if defined(__linux__)
+
+namespace {
+
+/// How often an idle plugin process checks that its host is still alive
+constexpr std::chrono::milliseconds HOST_CHECK_INTERVAL(100);
+
+/**
+ * @brief Check whether the host still holds the write end of the liveness pipe
+ *
+ * PR_SET_PDEATHSIG is not used: it fires when the thread that spawned the
+ * process exits, which kills plugins started from short-lived threads.
+ */
+bool isHostAlive() {
+    struct pollfd fd;
+    fd.fd = REMOTE_HOST_PIPE_FD;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    // The host never writes, so readiness means end-of-file
+    return poll(&fd, 1, 0) == 0;
+}
+
+void copyBounded(char* destination, size_t capacity, const char* source) {
+    std::strncpy(destination, source ? source : "", capacity - 1);
+    destination[capacity - 1] = '\0';
+}
+
+void sendHello(RemoteChannel& channel, const IPlugin* plugin) {
+    RemoteMessage hello;
+    hello.type = RemoteMessageType::Hello;
+    if (!plugin) {
+        hello.status = 1;
+        sendMessage(channel.replies, hello);
+        return;
+    }
+
+    RemoteHello info;
+    const Version version = plugin->getVersion();
+    info.versionMajor = version.major;
+    info.versionMinor = version.minor;
+    info.versionPatch = version.patch;
+    copyBounded(info.name, sizeof(info.name), plugin->getName());
+    copyBounded(info.description, sizeof(info.description), plugin->getDescription());
+    std::memcpy(hello.payload, &info, sizeof(info));
+    hello.size = sizeof(info);
+    sendMessage(channel.replies, hello);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <plugin path>\n", argv[0]);
+        return 2;
+    }
+    if (!isHostAlive()) {
+        return 1;
+    }
+
+    void* memory = mmap(nullptr, sizeof(RemoteChannel), PROT_READ | PROT_WRITE, MAP_SHARED,
+                        REMOTE_CHANNEL_FD, 0);
+    close(REMOTE_CHANNEL_FD);
+    if (memory == MAP_FAILED) {
+        std::fprintf(stderr, "hotplugpp_plugin_host: no shared channel\n");
+        return 1;
+    }
+    RemoteChannel& channel = *static_cast<RemoteChannel*>(memory);
+    if (channel.magic != REMOTE_CHANNEL_MAGIC || channel.version != REMOTE_CHANNEL_VERSION ||
+        channel.size != sizeof(RemoteChannel)) {
+        std::fprintf(stderr, "hotplugpp_plugin_host: incompatible shared channel\n");
+        return 1;
+    }
+
+    PluginLoader loader;
+    if (!loader.loadPlugin(argv[1])) {
+        sendHello(channel, nullptr);
+        return 1;
+    }
+    IPlugin* plugin = loader.getPlugin();
+    const HotPlugPPFunctionTable* table = loader.getFunctionTable();
+    sendHello(channel, plugin);
+
+    RemoteMessage request;
+    for (;;) {
+        if (!receiveMessage(channel.requests, request, HOST_CHECK_INTERVAL)) {
+            if (!isHostAlive()) {
+                return 1;
+            }
+            continue;
+        }
+
+        RemoteMessage reply;
+        reply.type = RemoteMessageType::Reply;
+        reply.sequence = request.sequence;
+        switch (request.type) {
+        case RemoteMessageType::Update:
+            plugin->onUpdate(request.deltaTime);
+            break;
+        case RemoteMessageType::Query:
+            if (table && table->query) {
+                const size_t capacity =
+                    std::min<size_t>(request.size, RemoteMessage::MAX_PAYLOAD);
+                reply.size = static_cast<uint32_t>(
+                    table->query(plugin, request.key, reply.payload, capacity));
+            } else {
+                reply.status = 1;
+            }
+            break;
+        case RemoteMessageType::Shutdown:
+            loader.unloadPlugin();
+            sendMessage(channel.replies, reply);
+            return 0;
+        default:
+            reply.status = 1;
+            break;
+        }
+        sendMessage(channel.replies, reply);
+    }
+}
+
+#else
+
+int main(int argc, char** argv) {
+    (void)argc;
+    std::fprintf(stderr, "%s: out-of-process plugins are only supported on Linux\n", argv[0]);
+    return 1;
+}
+
+#endif
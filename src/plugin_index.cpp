@@ -0,0 +1,272 @@
+#include "hotplugpp/plugin_index.hpp"
+
+#include "hotplugpp/log.hpp"
+#include "hotplugpp/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+namespace hotplugpp {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/// First bytes of an index file
+const char INDEX_MAGIC[8] = "HPPINDX";
+/// Layout version of the index file; bumped on incompatible changes
+constexpr uint32_t INDEX_VERSION = 1;
+/// Upper bound for a stored string, so a corrupt length cannot allocate gigabytes
+constexpr uint32_t MAX_STRING_SIZE = 1u << 16;
+/// Files probed by one worker task, so a task outweighs its queueing cost
+constexpr size_t FILES_PER_TASK = 32;
+
+bool isLibraryFile(const fs::path& path) {
+#if defined(_WIN32)
+    return path.extension() == ".dll";
+#elif defined(__APPLE__)
+    return path.extension() == ".dylib" || path.extension() == ".so";
+#else
+    return path.extension() == ".so";
+#endif
+}
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ofstream& file, const std::string& value) {
+    writeValue(file, static_cast<uint32_t>(value.size()));
+    file.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool readString(std::ifstream& file, std::string& value) {
+    uint32_t size = 0;
+    if (!readValue(file, size) || size > MAX_STRING_SIZE) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(file.read(&value[0], static_cast<std::streamsize>(size)));
+}
+
+void writeEntry(std::ofstream& file, const PluginIndexEntry& entry) {
+    writeString(file, entry.path);
+    writeValue(file, entry.stamp.modifiedNs);
+    writeValue(file, entry.stamp.size);
+    writeValue(file, entry.stamp.inode);
+    writeValue(file, entry.stamp.device);
+    writeValue(file, static_cast<uint8_t>(entry.isPlugin));
+    writeString(file, entry.metadata.name);
+    writeValue(file, entry.metadata.version.major);
+    writeValue(file, entry.metadata.version.minor);
+    writeValue(file, entry.metadata.version.patch);
+    writeString(file, entry.metadata.description);
+}
+
+bool readEntry(std::ifstream& file, PluginIndexEntry& entry) {
+    uint8_t isPlugin = 0;
+    if (!readString(file, entry.path) || !readValue(file, entry.stamp.modifiedNs) ||
+        !readValue(file, entry.stamp.size) || !readValue(file, entry.stamp.inode) ||
+        !readValue(file, entry.stamp.device) || !readValue(file, isPlugin) ||
+        !readString(file, entry.metadata.name) || !readValue(file, entry.metadata.version.major) ||
+        !readValue(file, entry.metadata.version.minor) ||
+        !readValue(file, entry.metadata.version.patch) ||
+        !readString(file, entry.metadata.description)) {
+        return false;
+    }
+    entry.stamp.exists = true;
+    entry.isPlugin = isPlugin != 0;
+    return true;
+}
+
+} // namespace
+
+PluginScanStats PluginIndex::scan(const std::vector<std::string>& directories,
+                                  const PluginScanOptions& options) {
+    PluginScanStats stats;
+
+    std::vector<std::string> paths;
+    for (const std::string& directory : directories) {
+        std::error_code ec;
+        for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code typeError;
+            if (it->is_regular_file(typeError) && isLibraryFile(it->path())) {
+                paths.push_back(it->path().string());
+            }
+        }
+        if (ec) {
+            logMessage(LogLevel::Warning, "Failed to list plugin directory: %s (%s)",
+                       directory.c_str(), ec.message().c_str());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    stats.files = paths.size();
+
+    // Previous entries by path; each worker only reads this map
+    std::unordered_map<std::string, const PluginIndexEntry*> previous;
+    previous.reserve(m_entries.size());
+    for (const PluginIndexEntry& entry : m_entries) {
+        previous.emplace(entry.path, &entry);
+    }
+
+    std::vector<PluginIndexEntry> entries(paths.size());
+    std::vector<char> reused(paths.size(), 0);
+    auto probe = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            PluginIndexEntry& entry = entries[i];
+            entry.path = paths[i];
+            entry.stamp = getFileStamp(paths[i]);
+            auto it = previous.find(paths[i]);
+            if (it != previous.end() && it->second->stamp == entry.stamp) {
+                entry = *it->second;
+                reused[i] = 1;
+                continue;
+            }
+            entry.isPlugin = readPluginMetadata(paths[i], entry.metadata);
+        }
+    };
+
+    // No point in spawning more workers than there are tasks
+    const size_t taskCount = (paths.size() + FILES_PER_TASK - 1) / FILES_PER_TASK;
+    size_t threadCount = options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (taskCount <= 1 || threadCount <= 1) {
+        probe(0, paths.size());
+    } else {
+        ThreadPool pool(std::min(threadCount, taskCount));
+        for (size_t begin = 0; begin < paths.size(); begin += FILES_PER_TASK) {
+            const size_t end = std::min(begin + FILES_PER_TASK, paths.size());
+            pool.submit([&probe, begin, end]() { probe(begin, end); });
+        }
+        pool.wait();
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (reused[i]) {
+            stats.reused++;
+        } else {
+            stats.probed++;
+        }
+        previous.erase(paths[i]);
+    }
+    stats.removed = previous.size();
+
+    m_entries = std::move(entries);
+    rebuildNameIndex();
+    return stats;
+}
+
+const PluginIndexEntry* PluginIndex::find(const std::string& name) const {
+    auto it = m_byName.find(name);
+    return it != m_byName.end() ? &m_entries[it->second] : nullptr;
+}
+
+size_t PluginIndex::getPluginCount() const {
+    return static_cast<size_t>(
+        std::count_if(m_entries.begin(), m_entries.end(),
+                      [](const PluginIndexEntry& entry) { return entry.isPlugin; }));
+}
+
+bool PluginIndex::load(const std::string& indexPath) {
+    clear();
+
+    std::ifstream file(indexPath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char magic[sizeof(INDEX_MAGIC)];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        !readValue(file, version) || version != INDEX_VERSION || !readValue(file, count)) {
+        logMessage(LogLevel::Warning, "Ignoring unrecognized plugin index: %s", indexPath.c_str());
+        return false;
+    }
+
+    std::vector<PluginIndexEntry> entries;
+    for (uint32_t i = 0; i < count; ++i) {
+        PluginIndexEntry entry;
+        if (!readEntry(file, entry)) {
+            logMessage(LogLevel::Warning, "Ignoring truncated plugin index: %s", indexPath.c_str());
+            return false;
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    m_entries = std::move(entries);
+    rebuildNameIndex();
+    return true;
+}
+
+bool PluginIndex::save(const std::string& indexPath) const {
+    const std::string tempPath = indexPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            logMessage(LogLevel::Error, "Failed to write plugin index: %s", tempPath.c_str());
+            return false;
+        }
+        file.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        writeValue(file, INDEX_VERSION);
+        writeValue(file, static_cast<uint32_t>(m_entries.size()));
+        for (const PluginIndexEntry& entry : m_entries) {
+            writeEntry(file, entry);
+        }
+        file.flush();
+        if (!file) {
+            logMessage(LogLevel::Error, "Failed to write plugin index: %s", tempPath.c_str());
+            std::error_code ec;
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, indexPath, ec);
+    if (ec) {
+        logMessage(LogLevel::Error, "Failed to replace plugin index: %s (%s)", indexPath.c_str(),
+                   ec.message().c_str());
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void PluginIndex::clear() {
+    m_entries.clear();
+    m_byName.clear();
+}
+
+void PluginIndex::rebuildNameIndex() {
+    m_byName.clear();
+    m_byName.reserve(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const PluginIndexEntry& entry = m_entries[i];
+        if (!entry.isPlugin) {
+            continue;
+        }
+        // Entries are sorted by path, so only a strictly higher version replaces a match
+        auto inserted = m_byName.emplace(entry.metadata.name, i);
+        if (!inserted.second &&
+            entry.metadata.version > m_entries[inserted.first->second].metadata.version) {
+            inserted.first->second = i;
+        }
+    }
+}
+
+} // namespace hotplugpp
@@ -1,17 +1,133 @@
 #include "hotplugpp/plugin_loader.hpp"
 
-#include <iostream>
+#include "hotplugpp/log.hpp"
+#include "library_cache.hpp"
+#include "plugin_module.hpp"
+
+#include <future>
 #include <utility>
 
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <dlfcn.h>
-#endif
+namespace hotplugpp {
+
+namespace {
+
+detail::LoadedModule toModule(const PluginInfo& info) {
+    detail::LoadedModule module;
+    module.handle = info.handle;
+    module.instance = info.instance;
+    module.createFunc = info.createFunc;
+    module.destroyFunc = info.destroyFunc;
+    module.interfaceVersion = info.interfaceVersion;
+    module.arena = info.arena;
+    module.serviceRegistry = info.serviceRegistry;
+    module.shadowPath = info.shadowPath;
+    return module;
+}
 
-#include <sys/stat.h>
+/**
+ * @brief Record which version of the plugin file is about to be loaded
+ * @param info Plugin info whose path is set
+ * @param hashContents Also hash the file contents
+ */
+void stampPluginFile(PluginInfo& info, bool hashContents) {
+    detail::stampFile(info.path, hashContents, info.fileStamp, info.contentHash);
+    info.lastModified = info.fileStamp.getModificationTime();
+}
 
-namespace hotplugpp {
+/**
+ * @brief Copy an opened module into a PluginInfo
+ * @param module Opened or loaded module
+ * @param info Receives the module; marked loaded
+ */
+void storeModule(const detail::LoadedModule& module, PluginInfo& info) {
+    info.handle = module.handle;
+    info.instance = module.instance;
+    info.createFunc = module.createFunc;
+    info.destroyFunc = module.destroyFunc;
+    info.interfaceVersion = module.interfaceVersion;
+    info.functionTable = module.functionTable;
+    info.arena = module.arena;
+    info.serviceRegistry = module.serviceRegistry;
+    info.shadowPath = module.shadowPath;
+    info.isLoaded = true;
+}
+
+/**
+ * @brief Load a plugin that is not loaded yet
+ * @param path Plugin path
+ * @param timings Receives the duration of each phase
+ * @param hashContents Also hash the file contents
+ * @param deferred Only open the library, leaving onLoad() for later
+ * @param host Host objects to attach to the library
+ * @return Info of the plugin; isLoaded is false if it failed to load
+ */
+PluginInfo loadPluginInfo(const std::string& path, PhaseTimings* timings, bool hashContents,
+                          bool deferred, detail::ModuleHost host) {
+    // Taken before loading so a write racing with the load is noticed next time
+    PluginInfo info;
+    info.path = path;
+    stampPluginFile(info, hashContents);
+
+    detail::LoadedModule module;
+    if (deferred) {
+        std::string error;
+        if (!detail::openModule(path, module, error, timings, SymbolBinding::Lazy, &host)) {
+            return info;
+        }
+    } else if (!detail::loadModule(path, module, timings, &host)) {
+        return info;
+    }
+    storeModule(module, info);
+    info.isInitialized = !deferred;
+    return info;
+}
+
+/**
+ * @brief Load a new version of a plugin next to the running one
+ * @param path Plugin path
+ * @param timings Receives the duration of each phase
+ * @param hashContents Also hash the file contents
+ * @param initialize Call onLoad(); false while the running version is still uninitialized
+ * @param binding Symbol binding of the new library
+ * @param host Host objects to attach to the new library
+ * @return Info of the new version; isLoaded is false if it failed to load
+ */
+PluginInfo stageReload(const std::string& path, PhaseTimings* timings, bool hashContents,
+                       bool initialize, SymbolBinding binding, detail::ModuleHost host) {
+    PluginInfo staged;
+    staged.path = path;
+    // Taken before copying so a write racing with the copy is noticed next time
+    stampPluginFile(staged, hashContents);
+
+    detail::LoadedModule module;
+    std::string error;
+    bool loaded = initialize
+                      ? detail::loadShadowModule(path, module, error, timings, binding, &host)
+                      : detail::openShadowModule(path, module, error, timings, binding, &host);
+    if (loaded) {
+        storeModule(module, staged);
+        staged.isInitialized = initialize;
+    }
+    return staged;
+}
+
+/**
+ * @brief Initialize a staged version whose predecessor was first used while it loaded
+ * @param staged Staged version that was loaded without onLoad()
+ * @param timings Receives the duration of each phase
+ * @return The staged version; isLoaded is false if it failed to initialize
+ */
+PluginInfo initStagedReload(PluginInfo staged, PhaseTimings* timings) {
+    detail::LoadedModule module = toModule(staged);
+    std::string error;
+    // Both discard the module on failure
+    staged.isLoaded = detail::initModule(staged.path, module, error, timings) &&
+                      detail::awaitInit(staged.path, module, error, timings);
+    staged.isInitialized = staged.isLoaded;
+    return staged;
+}
+
+} // namespace
 
 PluginLoader::PluginLoader() = default;
 
@@ -21,87 +137,135 @@ PluginLoader::~PluginLoader() {
 
 bool PluginLoader::loadPlugin(const std::string& path) {
     // Unload existing plugin if any
-    if (isLoaded()) {
-        unloadPlugin();
-    }
+    unloadPlugin();
 
-    // Load the shared library
-    LibraryHandle handle = loadLibrary(path);
-    if (!handle) {
-        std::cerr << "Failed to load library: " << path << std::endl;
-        std::cerr << "Error: " << getLastError() << std::endl;
-        return false;
-    }
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    return adoptPlugin(loadPluginInfo(path, &m_phaseTimings, m_contentHashing,
+                                      m_loadPolicy == LoadPolicy::Deferred, host));
+}
 
-    // Get the factory functions
-    CreatePluginFunc createFunc = reinterpret_cast<CreatePluginFunc>(
-        getFunction(handle, "createPlugin"));
-    DestroyPluginFunc destroyFunc = reinterpret_cast<DestroyPluginFunc>(
-        getFunction(handle, "destroyPlugin"));
+void PluginLoader::loadPluginAsync(const std::string& path) {
+    unloadPlugin();
 
-    if (!createFunc || !destroyFunc) {
-        std::cerr << "Failed to find plugin factory functions in: " << path << std::endl;
-        std::cerr << "Error: " << getLastError() << std::endl;
-        unloadLibrary(handle);
-        return false;
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    m_pendingLoad =
+        std::async(std::launch::async, loadPluginInfo, path, &m_phaseTimings, m_contentHashing,
+                   m_loadPolicy == LoadPolicy::Deferred, host);
+}
+
+PluginLoadState PluginLoader::pollLoad() {
+    if (m_pendingLoad.valid()) {
+        if (m_pendingLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return PluginLoadState::Loading;
+        }
+        adoptPlugin(m_pendingLoad.get());
     }
+    if (isLoaded() && m_pluginInfo.isInitializing) {
+        pollInitStatus();
+    }
+    return getLoadState();
+}
 
-    // Create plugin instance
-    IPlugin* plugin = createFunc();
-    if (!plugin) {
-        std::cerr << "Failed to create plugin instance from: " << path << std::endl;
-        unloadLibrary(handle);
-        return false;
+PluginLoadState PluginLoader::getLoadState() const {
+    if (m_pendingLoad.valid()) {
+        return PluginLoadState::Loading;
+    }
+    if (!isLoaded()) {
+        return PluginLoadState::Unloaded;
     }
+    if (!m_pluginInfo.isInitialized || m_pluginInfo.isInitializing) {
+        return PluginLoadState::Initializing;
+    }
+    return PluginLoadState::Ready;
+}
 
-    // Initialize plugin
-    if (!plugin->onLoad()) {
-        std::cerr << "Plugin initialization failed: " << path << std::endl;
-        destroyFunc(plugin);
-        unloadLibrary(handle);
+bool PluginLoader::adoptPlugin(PluginInfo info) {
+    if (!info.isLoaded) {
         return false;
     }
-
-    // Store plugin info
-    m_pluginInfo.path = path;
-    m_pluginInfo.handle = handle;
-    m_pluginInfo.instance = plugin;
-    m_pluginInfo.createFunc = createFunc;
-    m_pluginInfo.destroyFunc = destroyFunc;
-    m_pluginInfo.lastModified = getFileModificationTime(path);
-    m_pluginInfo.isLoaded = true;
-
-    std::cout << "Plugin loaded successfully: " << plugin->getName() << " v"
-              << plugin->getVersion().toString() << std::endl;
-
+    IPlugin* plugin = info.instance;
+    info.isInitializing =
+        info.isInitialized &&
+        detail::getInitStatus(*plugin, info.interfaceVersion) != InitStatus::Ready;
+    m_pluginInfo = std::move(info);
+    publishPlugin(&m_pluginInfo);
+    updateWatchedFile();
+
+    logMessage(LogLevel::Info,
+               !m_pluginInfo.isInitialized   ? "Plugin opened, onLoad deferred: %s v%s"
+               : m_pluginInfo.isInitializing ? "Plugin loaded, still initializing: %s v%s"
+                                             : "Plugin loaded successfully: %s v%s",
+               plugin->getName(), plugin->getVersion().toString().c_str());
     return true;
 }
 
+void PluginLoader::pollInitStatus() {
+    const InitStatus status =
+        detail::getInitStatus(*m_pluginInfo.instance, m_pluginInfo.interfaceVersion);
+    if (status == InitStatus::Initializing) {
+        return;
+    }
+    if (status == InitStatus::Failed) {
+        logMessage(LogLevel::Error, "Asynchronous plugin initialization failed: %s",
+                   m_pluginInfo.path.c_str());
+        unloadPlugin();
+        return;
+    }
+    m_pluginInfo.isInitializing = false;
+    publishPlugin(&m_pluginInfo);
+    logMessage(LogLevel::Info, "Plugin ready: %s", m_pluginInfo.instance->getName());
+}
+
 void PluginLoader::unloadPlugin() {
+    discardPendingLoad();
+    discardStagedReload();
+
     if (!isLoaded()) {
         return;
     }
 
-    // Call plugin cleanup
-    if (m_pluginInfo.instance) {
-        m_pluginInfo.instance->onUnload();
+    // Readers on other threads let go of the instance before it is torn down
+    publishPlugin(nullptr);
 
-        // Destroy plugin instance
-        if (m_pluginInfo.destroyFunc) {
-            m_pluginInfo.destroyFunc(m_pluginInfo.instance);
-        }
-        m_pluginInfo.instance = nullptr;
+    detail::LoadedModule module = toModule(m_pluginInfo);
+    if (m_pluginInfo.isInitialized) {
+        detail::unloadModule(module, &m_phaseTimings);
+    } else {
+        // onLoad() never ran, so neither does onUnload()
+        detail::discardModule(module, &m_phaseTimings);
     }
+    clearPluginInfo();
+}
 
-    // Unload library
-    if (m_pluginInfo.handle) {
-        unloadLibrary(m_pluginInfo.handle);
-        m_pluginInfo.handle = nullptr;
+void PluginLoader::publishPlugin(const PluginInfo* info) {
+    std::unique_ptr<PublishedPlugin> next;
+    if (info && info->isLoaded && info->isInitialized && !info->isInitializing) {
+        next.reset(new PublishedPlugin{info->instance, info->functionTable});
     }
+    m_published.store(next.get(), std::memory_order_seq_cst);
+    // Afterwards no reader holds the previous instance, so it may be torn down
+    m_epochs.synchronize();
+    m_publishedPlugin = std::move(next);
+}
 
+void PluginLoader::clearPluginInfo() {
+    m_pluginInfo.instance = nullptr;
+    m_pluginInfo.handle = nullptr;
     m_pluginInfo.isLoaded = false;
+    m_pluginInfo.isInitialized = false;
+    m_pluginInfo.isInitializing = false;
     m_pluginInfo.createFunc = nullptr;
     m_pluginInfo.destroyFunc = nullptr;
+    m_pluginInfo.functionTable = nullptr;
+    m_pluginInfo.arena = nullptr;
+    m_pluginInfo.serviceRegistry = nullptr;
+    m_pluginInfo.shadowPath.clear();
+    m_stateBuffer.reset();
+    m_pendingStamp = FileStamp();
 }
 
 bool PluginLoader::checkAndReload() {
@@ -109,32 +273,111 @@ bool PluginLoader::checkAndReload() {
         return false;
     }
 
-    auto currentModTime = getFileModificationTime(m_pluginInfo.path);
-
-    // Check if file has been modified
-    if (currentModTime > m_pluginInfo.lastModified) {
-        std::cout << "Plugin file modified, reloading..." << std::endl;
-
-        std::string path = m_pluginInfo.path;
-        unloadPlugin();
-
-        if (loadPlugin(path)) {
-            if (m_reloadCallback) {
-                m_reloadCallback();
-            }
-            return true;
-        } else {
-            std::cerr << "Failed to reload plugin: " << path << std::endl;
+    // A staged reload is swapped in by the first check after it finished
+    if (m_stagedReload.valid()) {
+        if (m_stagedReload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
         }
+        ScopedPhaseTimer timer(&m_phaseTimings, LoadPhase::Reload);
+        return commitReload(m_stagedReload.get());
     }
 
-    return false;
+    // The watcher only says that something happened; the file stamp decides.
+    // A change that is still settling is rechecked even without new events.
+    bool replaced = false;
+    if (m_fileWatcher && !consumeFileEvents(replaced) && !m_pendingStamp.exists) {
+        return false;
+    }
+    if (!hasPluginFileChanged(replaced)) {
+        return false;
+    }
+
+    logMessage(LogLevel::Info, "Plugin file modified, reloading...");
+
+    // A plugin that was never used is not initialized by a reload either
+    const bool initialize = m_pluginInfo.isInitialized;
+    const SymbolBinding binding =
+        m_loadPolicy == LoadPolicy::Deferred ? SymbolBinding::Lazy : SymbolBinding::Now;
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    if (m_reloadMode == ReloadMode::Staged) {
+        // The current instance keeps serving while the new one loads
+        m_stagedReload = std::async(std::launch::async, stageReload, m_pluginInfo.path,
+                                    &m_phaseTimings, m_contentHashing, initialize, binding, host);
+        return false;
+    }
+    ScopedPhaseTimer timer(&m_phaseTimings, LoadPhase::Reload);
+    return commitReload(stageReload(m_pluginInfo.path, &m_phaseTimings, m_contentHashing,
+                                    initialize, binding, host));
 }
 
 IPlugin* PluginLoader::getPlugin() const {
+    if (!m_pluginInfo.isInitialized || m_pluginInfo.isInitializing) {
+        return nullptr;
+    }
     return m_pluginInfo.instance;
 }
 
+IPlugin* PluginLoader::acquirePlugin() {
+    if (m_pendingLoad.valid() || m_pluginInfo.isInitializing) {
+        pollLoad();
+    }
+    // A deferred load completes on first use
+    if (isLoaded() && !m_pluginInfo.isInitialized) {
+        initializePlugin();
+    }
+    return m_pluginInfo.isInitializing ? nullptr : m_pluginInfo.instance;
+}
+
+bool PluginLoader::initializePlugin() {
+    if (!isLoaded()) {
+        return false;
+    }
+    if (m_pluginInfo.isInitialized) {
+        return true;
+    }
+
+    detail::LoadedModule module = toModule(m_pluginInfo);
+    std::string error;
+    if (!detail::initModule(m_pluginInfo.path, module, error, &m_phaseTimings)) {
+        // initModule() discarded the instance and released the library
+        discardStagedReload();
+        clearPluginInfo();
+        return false;
+    }
+    m_pluginInfo.isInitialized = true;
+    m_pluginInfo.isInitializing =
+        detail::getInitStatus(*m_pluginInfo.instance, m_pluginInfo.interfaceVersion) !=
+        InitStatus::Ready;
+    publishPlugin(&m_pluginInfo);
+    logMessage(LogLevel::Info,
+               m_pluginInfo.isInitializing ? "Plugin initialized, still initializing: %s"
+                                           : "Plugin initialized: %s",
+               m_pluginInfo.instance->getName());
+    return true;
+}
+
+bool PluginLoader::isInitialized() const {
+    return isLoaded() && m_pluginInfo.isInitialized;
+}
+
+const HotPlugPPFunctionTable* PluginLoader::getFunctionTable() const {
+    return m_pluginInfo.functionTable;
+}
+
+const Arena* PluginLoader::getArena() const {
+    return m_pluginInfo.arena;
+}
+
+size_t PluginLoader::getLibraryInstanceCount() const {
+    return m_pluginInfo.handle ? detail::getLibraryReferenceCount(m_pluginInfo.handle) : 0;
+}
+
+size_t PluginLoader::getLibraryInstanceCount(const std::string& path) {
+    return detail::getLibraryReferenceCount(path);
+}
+
 bool PluginLoader::isLoaded() const {
     return m_pluginInfo.isLoaded && m_pluginInfo.instance != nullptr;
 }
@@ -147,67 +390,250 @@ void PluginLoader::setReloadCallback(std::function<void()> callback) {
     m_reloadCallback = std::move(callback);
 }
 
-std::chrono::system_clock::time_point
-PluginLoader::getFileModificationTime(const std::string& path) {
-    struct stat statbuf;
-    if (stat(path.c_str(), &statbuf) == 0) {
-        return std::chrono::system_clock::from_time_t(statbuf.st_mtime);
+void PluginLoader::setReloadMode(ReloadMode mode) {
+    m_reloadMode = mode;
+}
+
+void PluginLoader::setMessageBus(MessageBus* bus) {
+    m_messageBus = bus;
+}
+
+MessageBus* PluginLoader::getMessageBus() const {
+    return m_messageBus;
+}
+
+void PluginLoader::setServiceRegistry(ServiceRegistry* registry) {
+    m_serviceRegistry = registry;
+}
+
+ServiceRegistry* PluginLoader::getServiceRegistry() const {
+    return m_serviceRegistry;
+}
+
+void PluginLoader::setLoadPolicy(LoadPolicy policy) {
+    m_loadPolicy = policy;
+}
+
+LoadPolicy PluginLoader::getLoadPolicy() const {
+    return m_loadPolicy;
+}
+
+void PluginLoader::setContentHashing(bool enable) {
+    m_contentHashing = enable;
+    if (!enable) {
+        m_pluginInfo.contentHash = 0;
+        return;
     }
-    return std::chrono::system_clock::time_point();
+
+    // Only adopt the current contents if they are still what was loaded
+    if (isLoaded() && m_pluginInfo.contentHash == 0 &&
+        getFileStamp(m_pluginInfo.path) == m_pluginInfo.fileStamp) {
+        hashFileContents(m_pluginInfo.path, m_pluginInfo.contentHash);
+    }
+}
+
+bool PluginLoader::isContentHashingEnabled() const {
+    return m_contentHashing;
+}
+
+void PluginLoader::setReloadDebounce(std::chrono::milliseconds debounce) {
+    m_reloadDebounce = debounce;
 }
 
-LibraryHandle PluginLoader::loadLibrary(const std::string& path) {
-#ifdef _WIN32
-    return LoadLibraryA(path.c_str());
-#else
-    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
-#endif
+std::chrono::milliseconds PluginLoader::getReloadDebounce() const {
+    return m_reloadDebounce;
 }
 
-void PluginLoader::unloadLibrary(LibraryHandle handle) {
-    if (!handle)
+ReloadMode PluginLoader::getReloadMode() const {
+    return m_reloadMode;
+}
+
+bool PluginLoader::isReloadPending() const {
+    return m_stagedReload.valid();
+}
+
+bool PluginLoader::enableFileWatcher(bool enable) {
+    if (!enable) {
+        m_fileWatcher.reset();
+        m_watchedFileId = FileWatcher::INVALID_FILE_ID;
+        m_watchedPath.clear();
+        return true;
+    }
+
+    if (m_fileWatcher) {
+        return true;
+    }
+
+    m_fileWatcher = std::make_unique<FileWatcher>();
+    if (!m_fileWatcher->start()) {
+        m_fileWatcher.reset();
+        return false;
+    }
+    updateWatchedFile();
+    return true;
+}
+
+bool PluginLoader::isFileWatcherEnabled() const {
+    return m_fileWatcher != nullptr;
+}
+
+void PluginLoader::updateWatchedFile() {
+    if (!m_fileWatcher || !isLoaded() || m_watchedPath == m_pluginInfo.path) {
         return;
+    }
 
-#ifdef _WIN32
-    FreeLibrary(handle);
-#else
-    dlclose(handle);
-#endif
+    if (m_watchedFileId != FileWatcher::INVALID_FILE_ID) {
+        m_fileWatcher->unwatchFile(m_watchedFileId);
+    }
+    m_watchedFileId = m_fileWatcher->watchFile(m_pluginInfo.path);
+    m_watchedPath = m_pluginInfo.path;
 }
 
-void* PluginLoader::getFunction(LibraryHandle handle, const std::string& name) {
-    if (!handle)
-        return nullptr;
+bool PluginLoader::consumeFileEvents(bool& replaced) {
+    bool changed = false;
+    bool overflowed = false;
+
+    FileEvent event;
+    while (m_fileWatcher->pollEvent(event)) {
+        if (event.type == FileEventType::Overflow) {
+            overflowed = true;
+        } else if (event.fileId == m_watchedFileId && event.type != FileEventType::Removed) {
+            changed = true;
+            replaced = replaced || event.type == FileEventType::Created;
+        }
+    }
+
+    // Lost events may have included ours, so let the file stamp decide
+    return changed || overflowed;
+}
+
+bool PluginLoader::hasPluginFileChanged(bool replaced) {
+    FileStamp stamp = getFileStamp(m_pluginInfo.path);
+    // A missing file is mid-replacement or deleted; keep the loaded version
+    if (!stamp.exists || stamp == m_pluginInfo.fileStamp) {
+        m_pendingStamp = FileStamp();
+        return false;
+    }
 
-#ifdef _WIN32
-    return reinterpret_cast<void*>(GetProcAddress(handle, name.c_str()));
-#else
-    return dlsym(handle, name.c_str());
-#endif
+    if (!replaced &&
+        !detail::isWriteSettled(stamp, m_pendingStamp, m_pendingSince, m_reloadDebounce)) {
+        return false;
+    }
+    m_pendingStamp = FileStamp();
+
+    if (m_contentHashing && m_pluginInfo.contentHash != 0) {
+        uint64_t hash = 0;
+        if (hashFileContents(m_pluginInfo.path, hash) && hash == m_pluginInfo.contentHash) {
+            logMessage(LogLevel::Debug, "Plugin file touched but unchanged, not reloading: %s",
+                       m_pluginInfo.path.c_str());
+            m_pluginInfo.fileStamp = stamp;
+            m_pluginInfo.lastModified = stamp.getModificationTime();
+            return false;
+        }
+    }
+    return true;
 }
 
-std::string PluginLoader::getLastError() {
-#ifdef _WIN32
-    DWORD error = GetLastError();
-    if (error == 0)
-        return "No error";
+bool PluginLoader::commitReload(PluginInfo staged) {
+    if (staged.isLoaded && m_pluginInfo.isInitialized && !staged.isInitialized) {
+        // The plugin was first used while its successor was being staged. Its setup runs
+        // on a worker as well; a later check swaps it in once it is ready.
+        m_stagedReload = std::async(std::launch::async, initStagedReload, std::move(staged),
+                                    &m_phaseTimings);
+        return false;
+    }
+
+    if (!staged.isLoaded) {
+        // Keep serving the old version and do not retry this build on every check
+        m_pluginInfo.lastModified = staged.lastModified;
+        m_pluginInfo.fileStamp = staged.fileStamp;
+        m_pluginInfo.contentHash = staged.contentHash;
+        logMessage(LogLevel::Warning, "Failed to reload plugin, keeping previous version: %s",
+                   staged.path.c_str());
+        return false;
+    }
+
+    // Swap: the old instance is torn down only now that its successor is ready
+    detail::StateBuffer state;
+    detail::LoadedModule old = toModule(m_pluginInfo);
+    if (m_pluginInfo.isInitialized) {
+        // saveState() must not race calls from other threads into the old instance
+        const detail::LoadedModule replacement = toModule(staged);
+        if (detail::hasTransferableState(old, replacement)) {
+            publishPlugin(nullptr);
+        }
+        detail::transferState(old, replacement, state, &m_phaseTimings);
+        publishPlugin(&staged);
+        detail::unloadModule(old, &m_phaseTimings);
+    } else {
+        publishPlugin(&staged);
+        detail::discardModule(old, &m_phaseTimings);
+    }
+    m_pluginInfo = std::move(staged);
+    m_stateBuffer = std::move(state);
 
-    LPSTR messageBuffer = nullptr;
-    size_t size = FormatMessageA(
-        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-        NULL, error, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&messageBuffer, 0, NULL);
+    logMessage(LogLevel::Info, "Plugin reloaded: %s v%s", m_pluginInfo.instance->getName(),
+               m_pluginInfo.instance->getVersion().toString().c_str());
 
-    if (size == 0 || messageBuffer == nullptr) {
-        return "Unknown error (code: " + std::to_string(error) + ")";
+    if (m_reloadCallback) {
+        m_reloadCallback();
+    }
+    return true;
+}
+
+void PluginLoader::discardStagedReload() {
+    if (!m_stagedReload.valid()) {
+        return;
     }
 
-    std::string message(messageBuffer, size);
-    LocalFree(messageBuffer);
-    return message;
-#else
-    const char* error = dlerror();
-    return error ? std::string(error) : "No error";
-#endif
+    PluginInfo staged = m_stagedReload.get();
+    if (staged.isLoaded) {
+        detail::LoadedModule module = toModule(staged);
+        if (staged.isInitialized) {
+            detail::unloadModule(module, &m_phaseTimings);
+        } else {
+            detail::discardModule(module, &m_phaseTimings);
+        }
+    }
+}
+
+void PluginLoader::discardPendingLoad() {
+    if (!m_pendingLoad.valid()) {
+        return;
+    }
+
+    PluginInfo info = m_pendingLoad.get();
+    if (info.isLoaded) {
+        detail::LoadedModule module = toModule(info);
+        if (info.isInitialized) {
+            detail::unloadModule(module, &m_phaseTimings);
+        } else {
+            detail::discardModule(module, &m_phaseTimings);
+        }
+    }
+}
+
+LatencyStats PluginLoader::getPhaseStats(LoadPhase phase) const {
+    return m_phaseTimings.getStats(phase);
+}
+
+const PhaseTimings& PluginLoader::getPhaseTimings() const {
+    return m_phaseTimings;
+}
+
+void PluginLoader::setPhaseCallback(PhaseCallback callback) {
+    // The staged or loading worker may be calling the current callback
+    if (m_stagedReload.valid()) {
+        m_stagedReload.wait();
+    }
+    if (m_pendingLoad.valid()) {
+        m_pendingLoad.wait();
+    }
+    m_phaseTimings.setCallback(std::move(callback));
+}
+
+void PluginLoader::resetPhaseTimings() {
+    m_phaseTimings.reset();
 }
 
 } // namespace hotplugpp
@@ -0,0 +1,1513 @@
+#include "hotplugpp/plugin_manager.hpp"
+
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/log.hpp"
+#include "hotplugpp/thread_pool.hpp"
+#include "library_cache.hpp"
+#include "plugin_module.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <utility>
+
+namespace hotplugpp {
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = PluginHandle::INVALID_INDEX;
+
+uint64_t hashName(const char* name) {
+    return fnv1a64(name ? std::string_view(name) : std::string_view());
+}
+
+} // namespace
+
+/// A plugin being loaded on a worker thread; its slot is reserved but not mapped to a row
+struct PluginManager::AsyncLoad {
+    uint32_t slot = INVALID_INDEX;
+    std::string path;
+    /// Only the library is opened; onLoad() is left to initializePending()
+    bool deferred = false;
+    /// Unloaded before it finished; the module is released as soon as the worker is done
+    bool cancelled = false;
+    /// Module without an instance on failure
+    std::future<detail::LoadedModule> result;
+};
+
+/// A reloaded build being loaded or finishing its setup; the old row keeps serving meanwhile
+struct PluginManager::PendingReload {
+    uint32_t slot = INVALID_INDEX;
+    /// false if onLoad() of both versions is still deferred
+    bool initialize = true;
+    /// Superseded or its plugin unloaded; the module is released as soon as the worker is done
+    bool cancelled = false;
+    /// Module without an instance on failure; invalid once taken into module
+    std::future<detail::LoadedModule> result;
+    /// Finished build, possibly still reporting InitStatus::Initializing
+    detail::LoadedModule module;
+};
+
+PluginManager::PluginManager() = default;
+
+PluginManager::~PluginManager() {
+    unloadAll();
+}
+
+PluginHandle PluginManager::loadPlugin(const std::string& path) {
+    detail::LoadedModule module;
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    if (m_loadPolicy == LoadPolicy::Deferred) {
+        std::string error;
+        if (!detail::openModule(path, module, error, nullptr, SymbolBinding::Lazy, &host)) {
+            return PluginHandle();
+        }
+        return addPlugin(path, module, false);
+    }
+
+    if (!detail::loadModule(path, module, nullptr, &host)) {
+        return PluginHandle();
+    }
+    return addPlugin(path, module);
+}
+
+PluginHandle PluginManager::loadPluginAsync(const std::string& path) {
+    auto load = std::make_unique<AsyncLoad>();
+    load->slot = allocateSlot();
+    load->path = path;
+    load->deferred = m_loadPolicy == LoadPolicy::Deferred;
+
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    const bool deferred = load->deferred;
+    load->result = std::async(std::launch::async, [path, deferred, host]() {
+        detail::LoadedModule module;
+        std::string error;
+        if (deferred) {
+            detail::openModule(path, module, error, nullptr, SymbolBinding::Lazy, &host);
+        } else {
+            detail::loadModule(path, module, nullptr, &host);
+        }
+        return module;
+    });
+
+    PluginHandle handle;
+    handle.index = load->slot;
+    handle.generation = m_slotGenerations[load->slot];
+    m_asyncLoads.push_back(std::move(load));
+    return handle;
+}
+
+size_t PluginManager::pollLoads() {
+    size_t ready = 0;
+
+    // Adopt in request order so load sequences follow it
+    for (size_t i = 0; i < m_asyncLoads.size();) {
+        if (m_asyncLoads[i]->result.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+            ++i;
+            continue;
+        }
+        std::unique_ptr<AsyncLoad> load = std::move(m_asyncLoads[i]);
+        m_asyncLoads.erase(m_asyncLoads.begin() + i);
+        if (adoptAsyncLoad(*load)) {
+            ++ready;
+        }
+    }
+
+    pollReloads();
+
+    if (m_initializingCount == 0) {
+        return ready;
+    }
+    // Walk backwards: removing a failed row moves an already visited row into its place
+    for (uint32_t dense = static_cast<uint32_t>(m_instances.size()); dense-- > 0;) {
+        if (!m_initializing[dense]) {
+            continue;
+        }
+        const InitStatus status =
+            detail::getInitStatus(*m_instances[dense], m_interfaceVersions[dense]);
+        if (status == InitStatus::Initializing) {
+            continue;
+        }
+        if (status == InitStatus::Failed) {
+            logMessage(LogLevel::Error, "Asynchronous plugin initialization failed: %s",
+                       m_paths[dense].c_str());
+            removeAt(dense);
+            continue;
+        }
+        m_initializing[dense] = 0;
+        m_initializingCount--;
+        m_updateGraphDirty = true;
+        m_updateBatchesDirty = true;
+        logMessage(LogLevel::Info, "Plugin ready: %s", m_instances[dense]->getName());
+        ++ready;
+    }
+    return ready;
+}
+
+PluginLoadState PluginManager::getLoadState(PluginHandle handle) const {
+    if (handle.index >= m_slotGenerations.size() ||
+        m_slotGenerations[handle.index] != handle.generation) {
+        return PluginLoadState::Unloaded;
+    }
+    // Only loadPluginAsync() keeps a live slot without a row
+    uint32_t dense = m_slotToDense[handle.index];
+    if (dense == INVALID_INDEX) {
+        return PluginLoadState::Loading;
+    }
+    if (m_initPending[dense] || m_initializing[dense]) {
+        return PluginLoadState::Initializing;
+    }
+    return PluginLoadState::Ready;
+}
+
+std::vector<PluginLoadResult>
+PluginManager::loadPlugins(const std::vector<PluginLoadRequest>& requests,
+                           const BatchLoadOptions& options) {
+    const size_t count = requests.size();
+    std::vector<PluginLoadResult> results(count);
+    std::vector<detail::LoadedModule> modules(count);
+    std::vector<std::vector<size_t>> dependents(count);
+    std::vector<size_t> dependencyCounts(count, 0);
+    std::vector<char> opened(count, 0);
+
+    std::unordered_map<std::string, size_t> indexByPath;
+    for (size_t i = 0; i < count; ++i) {
+        results[i].path = requests[i].path;
+        indexByPath.emplace(requests[i].path, i);
+    }
+
+    // Build the dependency graph
+    for (size_t i = 0; i < count; ++i) {
+        for (const auto& dependency : requests[i].dependencies) {
+            auto it = indexByPath.find(dependency);
+            if (it == indexByPath.end()) {
+                results[i].error = "Unknown dependency: " + dependency;
+                continue;
+            }
+            dependents[it->second].push_back(i);
+            dependencyCounts[i]++;
+        }
+    }
+
+    // Topological order (Kahn); whatever is left over sits on a cycle
+    std::vector<size_t> order;
+    order.reserve(count);
+    {
+        std::vector<size_t> remaining = dependencyCounts;
+        for (size_t i = 0; i < count; ++i) {
+            if (remaining[i] == 0) {
+                order.push_back(i);
+            }
+        }
+        for (size_t next = 0; next < order.size(); ++next) {
+            for (size_t dependent : dependents[order[next]]) {
+                if (--remaining[dependent] == 0) {
+                    order.push_back(dependent);
+                }
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (remaining[i] != 0 && results[i].error.empty()) {
+                results[i].error = "Dependency cycle involving: " + requests[i].path;
+            }
+        }
+    }
+
+    // No point in spawning more workers than there are plugins
+    size_t threadCount = options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    ThreadPool pool(std::max<size_t>(std::min(threadCount, count), 1));
+
+    // Phase 1: dlopen, symbol lookup and createPlugin, all independent of each other
+    const bool deferred = m_loadPolicy == LoadPolicy::Deferred;
+    const SymbolBinding binding = deferred ? SymbolBinding::Lazy : SymbolBinding::Now;
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    for (size_t i = 0; i < count; ++i) {
+        if (!results[i].error.empty()) {
+            continue;
+        }
+        pool.submit([&, i]() {
+            if (detail::openModule(requests[i].path, modules[i], results[i].error, nullptr,
+                                   binding, &host)) {
+                opened[i] = 1;
+            }
+        });
+    }
+    pool.wait();
+
+    if (deferred) {
+        // Register in dependency order; initializePending() follows the load order
+        for (size_t i : order) {
+            if (!opened[i]) {
+                continue;
+            }
+            results[i].handle = addPlugin(requests[i].path, modules[i], false);
+            results[i].success = true;
+        }
+        // Modules on a cycle or with an unknown dependency never made it into the order
+        for (size_t i = 0; i < count; ++i) {
+            if (opened[i] && !results[i].success) {
+                detail::discardModule(modules[i]);
+            }
+        }
+        return results;
+    }
+
+    // Phase 2: onLoad in dependency order
+    std::vector<char> initialized(count, 0);
+    auto initOne = [&](size_t i) {
+        if (!opened[i]) {
+            return;
+        }
+        if (!results[i].error.empty()) {
+            // A dependency failed, so onLoad must not run
+            detail::discardModule(modules[i]);
+            return;
+        }
+        initialized[i] = detail::initModule(requests[i].path, modules[i], results[i].error);
+    };
+    auto failDependents = [&](size_t i) {
+        if (initialized[i]) {
+            return;
+        }
+        for (size_t dependent : dependents[i]) {
+            if (results[dependent].error.empty()) {
+                results[dependent].error = "Dependency failed to load: " + requests[i].path;
+            }
+        }
+    };
+
+    if (options.parallelInit) {
+        // Each finished plugin releases its dependents once all their dependencies are done
+        std::vector<std::atomic<size_t>> pending(count);
+        std::mutex resultMutex;
+        for (size_t i = 0; i < count; ++i) {
+            pending[i].store(dependencyCounts[i], std::memory_order_relaxed);
+        }
+
+        std::function<void(size_t)> run = [&](size_t i) {
+            initOne(i);
+            {
+                std::lock_guard<std::mutex> lock(resultMutex);
+                failDependents(i);
+            }
+            for (size_t dependent : dependents[i]) {
+                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pool.submit([&run, dependent]() { run(dependent); });
+                }
+            }
+        };
+        for (size_t i = 0; i < count; ++i) {
+            if (dependencyCounts[i] == 0) {
+                pool.submit([&run, i]() { run(i); });
+            }
+        }
+        pool.wait();
+
+        // Modules on a cycle were opened but never released by a dependency
+        for (size_t i = 0; i < count; ++i) {
+            if (opened[i] && !initialized[i] && modules[i].instance) {
+                detail::discardModule(modules[i]);
+            }
+        }
+    } else {
+        for (size_t i : order) {
+            initOne(i);
+            failDependents(i);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (opened[i] && !initialized[i] && modules[i].instance) {
+                detail::discardModule(modules[i]);
+            }
+        }
+    }
+
+    // Phase 3: register the survivors on the calling thread
+    for (size_t i = 0; i < count; ++i) {
+        if (!initialized[i]) {
+            continue;
+        }
+        results[i].handle = addPlugin(requests[i].path, modules[i]);
+        results[i].success = true;
+    }
+
+    return results;
+}
+
+std::vector<PluginLoadResult> PluginManager::loadPlugins(const std::vector<std::string>& paths,
+                                                         const BatchLoadOptions& options) {
+    std::vector<PluginLoadRequest> requests(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        requests[i].path = paths[i];
+    }
+    return loadPlugins(requests, options);
+}
+
+bool PluginManager::unloadPlugin(PluginHandle handle) {
+    uint32_t dense = denseIndex(handle);
+    if (dense != INVALID_INDEX) {
+        removeAt(dense);
+        return true;
+    }
+
+    AsyncLoad* load = findAsyncLoad(handle);
+    if (!load) {
+        return false;
+    }
+    // The worker cannot be interrupted; the handle goes stale now and the slot is
+    // released once the load finishes
+    m_slotGenerations[load->slot]++;
+    load->cancelled = true;
+    return true;
+}
+
+void PluginManager::unloadAll() {
+    for (auto& load : m_asyncLoads) {
+        if (!load->cancelled) {
+            m_slotGenerations[load->slot]++;
+            load->cancelled = true;
+        }
+        adoptAsyncLoad(*load);
+    }
+    m_asyncLoads.clear();
+
+    // Remove from the back so no rows have to be moved
+    while (!m_instances.empty()) {
+        removeAt(static_cast<uint32_t>(m_instances.size() - 1));
+    }
+
+    // Every reload was cancelled with its row; wait for the workers still running
+    for (auto& pending : m_pendingReloads) {
+        releaseReload(*pending);
+    }
+    m_pendingReloads.clear();
+}
+
+size_t PluginManager::checkAndReload() {
+    if (!m_fileWatcher) {
+        return reloadByFileStamp();
+    }
+
+    bool overflowed = false;
+    m_changedSlots.clear();
+    m_replacedSlots.clear();
+    // Changes that are still settling are rechecked even without new events
+    m_changedSlots.swap(m_settlingSlots);
+
+    FileEvent event;
+    while (m_fileWatcher->pollEvent(event)) {
+        if (event.type == FileEventType::Overflow) {
+            overflowed = true;
+            continue;
+        }
+        if (event.type == FileEventType::Removed) {
+            continue;
+        }
+        auto it = m_watchIdToSlot.find(event.fileId);
+        if (it != m_watchIdToSlot.end()) {
+            m_changedSlots.push_back(it->second);
+            if (event.type == FileEventType::Created) {
+                m_replacedSlots.push_back(it->second);
+            }
+        }
+    }
+
+    // Events were lost, so every file has to be checked once
+    if (overflowed) {
+        return reloadByFileStamp();
+    }
+
+    // Several events for one file (e.g. attribute change + close) mean one reload
+    std::sort(m_changedSlots.begin(), m_changedSlots.end());
+    m_changedSlots.erase(std::unique(m_changedSlots.begin(), m_changedSlots.end()),
+                         m_changedSlots.end());
+    std::sort(m_replacedSlots.begin(), m_replacedSlots.end());
+
+    size_t started = 0;
+    for (uint32_t slot : m_changedSlots) {
+        uint32_t dense = m_slotToDense[slot];
+        if (dense == INVALID_INDEX) {
+            continue;
+        }
+        bool replaced = std::binary_search(m_replacedSlots.begin(), m_replacedSlots.end(), slot);
+        if (!hasFileChanged(dense, replaced)) {
+            if (m_pendingStamps[dense].exists) {
+                m_settlingSlots.push_back(slot);
+            }
+            continue;
+        }
+        reloadAt(dense);
+        ++started;
+    }
+    return started;
+}
+
+void PluginManager::updateAll(float deltaTime) {
+    if (!m_asyncLoads.empty() || !m_pendingReloads.empty() || m_initializingCount > 0) {
+        pollLoads();
+    }
+    if (m_pendingInitCount > 0) {
+        initializePending();
+    }
+
+    UpdateWatchdog* watchdog = m_watchdog.get();
+    if (watchdog && watchdog->size() < m_instances.size()) {
+        watchdog->resize(m_instances.size());
+    }
+
+    if (!m_updateScheduler) {
+        if (m_updateBatchesDirty) {
+            rebuildUpdateBatches();
+        }
+        if (m_updateTiming || watchdog) {
+            updateBatchesTimed(deltaTime);
+        } else {
+            for (const UpdateBatch& batch : m_updateBatches) {
+                callBatch(batch, deltaTime);
+            }
+        }
+    } else {
+        if (m_updateGraphDirty) {
+            rebuildUpdateGraph();
+        }
+        m_updateScheduler->run([this, deltaTime, watchdog](uint32_t task) {
+            uint32_t dense = m_updateOrder[task];
+            if (watchdog) {
+                watchdog->begin(dense);
+            }
+            auto start = std::chrono::steady_clock::now();
+            if (const HotPlugPPFunctionTable* table = m_functionTables[dense]) {
+                table->update(m_instances[dense], deltaTime);
+            } else {
+                m_instances[dense]->onUpdate(deltaTime);
+            }
+            auto duration = std::chrono::steady_clock::now() - start;
+            if (watchdog) {
+                watchdog->end(dense);
+            }
+            recordUpdate(dense, duration);
+        });
+    }
+
+    if (watchdog) {
+        // Rows may change once this returns; let a report in progress finish reading them
+        watchdog->quiesce();
+    }
+    if (m_pendingOverruns.load(std::memory_order_relaxed) > 0) {
+        reportOverruns();
+    }
+}
+
+void PluginManager::setMessageBus(MessageBus* bus) {
+    m_messageBus = bus;
+}
+
+MessageBus* PluginManager::getMessageBus() const {
+    return m_messageBus;
+}
+
+void PluginManager::setServiceRegistry(ServiceRegistry* registry) {
+    m_serviceRegistry = registry;
+}
+
+ServiceRegistry* PluginManager::getServiceRegistry() const {
+    return m_serviceRegistry;
+}
+
+void PluginManager::setLoadPolicy(LoadPolicy policy) {
+    m_loadPolicy = policy;
+}
+
+LoadPolicy PluginManager::getLoadPolicy() const {
+    return m_loadPolicy;
+}
+
+size_t PluginManager::initializePending(std::chrono::microseconds budget) {
+    if (m_pendingInitCount == 0) {
+        return 0;
+    }
+
+    // Rows move when a failed plugin is removed, so go by handle
+    std::vector<PluginHandle> pending;
+    pending.reserve(m_pendingInitCount);
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        if (m_initPending[dense]) {
+            pending.push_back(getHandleAt(dense));
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](PluginHandle a, PluginHandle b) {
+        return m_loadSequence[denseIndex(a)] < m_loadSequence[denseIndex(b)];
+    });
+
+    // The budget is checked after each plugin, so every call makes progress
+    const auto start = std::chrono::steady_clock::now();
+    size_t initialized = 0;
+    for (PluginHandle handle : pending) {
+        uint32_t dense = denseIndex(handle);
+        if (dense != INVALID_INDEX && m_initPending[dense] && initializeAt(dense)) {
+            ++initialized;
+        }
+        if (budget.count() > 0 && std::chrono::steady_clock::now() - start >= budget) {
+            break;
+        }
+    }
+    return initialized;
+}
+
+size_t PluginManager::getPendingInitCount() const {
+    return m_pendingInitCount;
+}
+
+bool PluginManager::isInitialized(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense != INVALID_INDEX && !m_initPending[dense];
+}
+
+void PluginManager::enableParallelUpdate(bool enable, size_t threadCount) {
+    m_updateScheduler.reset();
+    if (enable) {
+        m_updateScheduler = std::make_unique<UpdateScheduler>(threadCount);
+        m_updateGraphDirty = true;
+    }
+}
+
+bool PluginManager::isParallelUpdateEnabled() const {
+    return m_updateScheduler != nullptr;
+}
+
+bool PluginManager::setUpdateAccess(PluginHandle handle, const std::vector<std::string>& reads,
+                                    const std::vector<std::string>& writes) {
+    uint32_t dense = denseIndex(handle);
+    if (dense == INVALID_INDEX) {
+        return false;
+    }
+
+    UpdateAccess& access = m_updateAccess[dense];
+    access.exclusive = false;
+    access.reads.clear();
+    access.writes.clear();
+    for (const auto& resource : reads) {
+        access.reads.push_back(fnv1a64(resource));
+    }
+    for (const auto& resource : writes) {
+        access.writes.push_back(fnv1a64(resource));
+    }
+    m_updateGraphDirty = true;
+    return true;
+}
+
+void PluginManager::enableUpdateTiming(bool enable) {
+    m_updateTiming = enable;
+}
+
+bool PluginManager::isUpdateTimingEnabled() const {
+    return m_updateTiming || m_updateScheduler || m_watchdog;
+}
+
+UpdateStats PluginManager::getUpdateStats(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? UpdateStats() : m_updateStats[dense].stats;
+}
+
+const LatencyHistogram* PluginManager::getUpdateHistogram(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? nullptr : m_updateStats[dense].histogram.get();
+}
+
+bool PluginManager::setUpdateBudget(PluginHandle handle, std::chrono::nanoseconds budget) {
+    uint32_t dense = denseIndex(handle);
+    if (dense == INVALID_INDEX) {
+        return false;
+    }
+    m_updateStats[dense].budget = std::max(budget, std::chrono::nanoseconds::zero());
+    m_updateStats[dense].budgetOverridden = true;
+    return true;
+}
+
+std::chrono::nanoseconds PluginManager::getUpdateBudget(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? std::chrono::nanoseconds::zero()
+                                  : m_updateStats[dense].budget;
+}
+
+void PluginManager::setBudgetCallback(std::function<void(const UpdateOverrun&)> callback) {
+    m_budgetCallback = std::move(callback);
+}
+
+bool PluginManager::startWatchdog(std::chrono::nanoseconds limit,
+                                  std::function<void(const UpdateOverrun&)> callback) {
+    if (limit.count() <= 0) {
+        return false;
+    }
+    if (!m_watchdog) {
+        m_watchdog = std::make_unique<UpdateWatchdog>();
+    }
+
+    // Runs while the stalled update is in progress, so rows cannot change underneath it
+    auto report = [this, limit, callback = std::move(callback)](
+                      uint32_t dense, std::chrono::nanoseconds elapsed) {
+        UpdateOverrun overrun;
+        overrun.handle = getHandleAt(dense);
+        overrun.name = m_names[dense];
+        overrun.duration = elapsed;
+        overrun.limit = limit;
+        logMessage(LogLevel::Warning, "Plugin update has been running for %lld ms: %s",
+                   static_cast<long long>(
+                       std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()),
+                   overrun.name ? overrun.name : m_paths[dense].c_str());
+        if (callback) {
+            callback(overrun);
+        }
+    };
+    return m_watchdog->start(limit, std::move(report));
+}
+
+void PluginManager::stopWatchdog() {
+    m_watchdog.reset();
+}
+
+bool PluginManager::isWatchdogRunning() const {
+    return m_watchdog != nullptr;
+}
+
+bool PluginManager::isBatchUpdated(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    if (dense == INVALID_INDEX) {
+        return false;
+    }
+    const HotPlugPPFunctionTable* table = m_functionTables[dense];
+    return table ? table->updateBatch != nullptr : m_updateBatchFuncs[dense] != nullptr;
+}
+
+const HotPlugPPFunctionTable* PluginManager::getFunctionTable(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? nullptr : m_functionTables[dense];
+}
+
+const Arena* PluginManager::getArena(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? nullptr : m_arenas[dense];
+}
+
+size_t PluginManager::getLibraryInstanceCount(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? 0 : detail::getLibraryReferenceCount(m_libraries[dense]);
+}
+
+const UpdateScheduler* PluginManager::getUpdateScheduler() const {
+    return m_updateScheduler.get();
+}
+
+IPlugin* PluginManager::getPlugin(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    if (dense == INVALID_INDEX || m_initPending[dense] || m_initializing[dense]) {
+        return nullptr;
+    }
+    return m_instances[dense];
+}
+
+IPlugin* PluginManager::acquirePlugin(PluginHandle handle) {
+    uint32_t dense = denseIndex(handle);
+    if (dense == INVALID_INDEX) {
+        return nullptr;
+    }
+    // A deferred load completes on first use
+    if (m_initPending[dense] && !initializeAt(dense)) {
+        return nullptr;
+    }
+    // Not handed out before its background setup is done, like updateAll()
+    return m_initializing[dense] ? nullptr : m_instances[dense];
+}
+
+PluginHandle PluginManager::findPlugin(std::string_view name) const {
+    PluginHandle handle;
+
+    auto it = m_nameIndex.find(fnv1a64(name));
+    if (it == m_nameIndex.end()) {
+        return handle;
+    }
+
+    uint32_t dense = m_slotToDense[it->second];
+    if (name != m_instances[dense]->getName()) {
+        // Hash collision between different names
+        return handle;
+    }
+
+    handle.index = it->second;
+    handle.generation = m_slotGenerations[it->second];
+    return handle;
+}
+
+bool PluginManager::isValid(PluginHandle handle) const {
+    return denseIndex(handle) != INVALID_INDEX;
+}
+
+std::string PluginManager::getPluginPath(PluginHandle handle) const {
+    uint32_t dense = denseIndex(handle);
+    return dense == INVALID_INDEX ? std::string() : m_paths[dense];
+}
+
+size_t PluginManager::getPluginCount() const {
+    return m_instances.size();
+}
+
+PluginHandle PluginManager::getHandleAt(size_t position) const {
+    PluginHandle handle;
+    if (position < m_denseToSlot.size()) {
+        handle.index = m_denseToSlot[position];
+        handle.generation = m_slotGenerations[handle.index];
+    }
+    return handle;
+}
+
+void PluginManager::setReloadCallback(std::function<void(PluginHandle)> callback) {
+    m_reloadCallback = std::move(callback);
+}
+
+bool PluginManager::enableFileWatcher(bool enable) {
+    if (!enable) {
+        m_fileWatcher.reset();
+        m_watchIdToSlot.clear();
+        std::fill(m_watchIds.begin(), m_watchIds.end(), FileWatcher::INVALID_FILE_ID);
+        return true;
+    }
+
+    if (m_fileWatcher) {
+        return true;
+    }
+
+    m_fileWatcher = std::make_unique<FileWatcher>();
+    if (!m_fileWatcher->start()) {
+        m_fileWatcher.reset();
+        return false;
+    }
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        watchRow(dense);
+    }
+    return true;
+}
+
+bool PluginManager::isFileWatcherEnabled() const {
+    return m_fileWatcher != nullptr;
+}
+
+void PluginManager::setContentHashing(bool enable) {
+    m_contentHashing = enable;
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        m_contentHashes[dense] = 0;
+        // Only adopt the current contents if they are still what was loaded
+        if (enable && getFileStamp(m_paths[dense]) == m_fileStamps[dense]) {
+            hashFileContents(m_paths[dense], m_contentHashes[dense]);
+        }
+    }
+}
+
+bool PluginManager::isContentHashingEnabled() const {
+    return m_contentHashing;
+}
+
+void PluginManager::setReloadDebounce(std::chrono::milliseconds debounce) {
+    m_reloadDebounce = debounce;
+}
+
+std::chrono::milliseconds PluginManager::getReloadDebounce() const {
+    return m_reloadDebounce;
+}
+
+uint32_t PluginManager::denseIndex(PluginHandle handle) const {
+    if (handle.index >= m_slotGenerations.size() ||
+        m_slotGenerations[handle.index] != handle.generation) {
+        return INVALID_INDEX;
+    }
+    return m_slotToDense[handle.index];
+}
+
+uint32_t PluginManager::allocateSlot() {
+    // Reuse a free slot if possible so the slot array stays compact
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slotGenerations.size());
+        m_slotGenerations.push_back(0);
+        m_slotToDense.push_back(INVALID_INDEX);
+    }
+    return slot;
+}
+
+PluginHandle PluginManager::addPlugin(const std::string& path, const detail::LoadedModule& module,
+                                      bool initialized, uint32_t slot) {
+    if (slot == INVALID_INDEX) {
+        slot = allocateSlot();
+    }
+
+    uint32_t dense = static_cast<uint32_t>(m_instances.size());
+    m_slotToDense[slot] = dense;
+    m_denseToSlot.push_back(slot);
+    m_instances.push_back(module.instance);
+    m_libraries.push_back(module.handle);
+    m_createFuncs.push_back(module.createFunc);
+    m_destroyFuncs.push_back(module.destroyFunc);
+    m_interfaceVersions.push_back(module.interfaceVersion);
+    m_updateBatchFuncs.push_back(module.updateBatchFunc);
+    m_functionTables.push_back(module.functionTable);
+    m_arenas.push_back(module.arena);
+    m_serviceRegistries.push_back(module.serviceRegistry);
+    m_fileStamps.emplace_back();
+    m_contentHashes.push_back(0);
+    detail::stampFile(path, m_contentHashing, m_fileStamps.back(), m_contentHashes.back());
+    m_pendingStamps.emplace_back();
+    m_pendingSince.emplace_back();
+    m_nameHashes.push_back(hashName(module.instance->getName()));
+    m_names.push_back(module.instance->getName());
+    m_paths.push_back(path);
+    m_shadowPaths.push_back(std::string());
+    m_stateBuffers.emplace_back();
+    m_watchIds.push_back(FileWatcher::INVALID_FILE_ID);
+    m_updateAccess.emplace_back();
+    m_updateAccess.back().exclusive = true;
+    m_updateStats.emplace_back();
+    refreshUpdateBudget(dense);
+    m_loadSequence.push_back(m_nextLoadSequence++);
+    m_initPending.push_back(initialized ? 0 : 1);
+    m_pendingInitCount += initialized ? 0 : 1;
+    // Failed is acted on by the next pollLoads() as well
+    const bool initializing =
+        initialized &&
+        detail::getInitStatus(*module.instance, module.interfaceVersion) != InitStatus::Ready;
+    m_initializing.push_back(initializing ? 1 : 0);
+    m_initializingCount += initializing ? 1 : 0;
+    m_updateGraphDirty = true;
+    m_updateBatchesDirty = true;
+    addNameIndex(dense);
+    watchRow(dense);
+
+    logMessage(LogLevel::Info,
+               !initialized   ? "Plugin opened, onLoad deferred: %s v%s"
+               : initializing ? "Plugin loaded, still initializing: %s v%s"
+                              : "Plugin loaded successfully: %s v%s",
+               module.instance->getName(), module.instance->getVersion().toString().c_str());
+
+    PluginHandle handle;
+    handle.index = slot;
+    handle.generation = m_slotGenerations[slot];
+    return handle;
+}
+
+void PluginManager::addNameIndex(uint32_t dense) {
+    // The first plugin registered under a name wins
+    m_nameIndex.emplace(m_nameHashes[dense], m_denseToSlot[dense]);
+}
+
+void PluginManager::removeNameIndex(uint32_t dense) {
+    auto it = m_nameIndex.find(m_nameHashes[dense]);
+    if (it == m_nameIndex.end() || it->second != m_denseToSlot[dense]) {
+        return;
+    }
+    m_nameIndex.erase(it);
+
+    // Hand the name over to another instance with the same name, if any
+    for (uint32_t other = 0; other < m_nameHashes.size(); ++other) {
+        if (other != dense && m_nameHashes[other] == m_nameHashes[dense]) {
+            m_nameIndex.emplace(m_nameHashes[other], m_denseToSlot[other]);
+            break;
+        }
+    }
+}
+
+void PluginManager::removeAt(uint32_t dense) {
+    removeNameIndex(dense);
+    unwatchRow(dense);
+    cancelReload(m_denseToSlot[dense]);
+
+    detail::LoadedModule module = moduleAt(dense);
+    if (m_initPending[dense]) {
+        // onLoad() never ran, so neither does onUnload()
+        detail::discardModule(module);
+        m_pendingInitCount--;
+    } else {
+        detail::unloadModule(module);
+    }
+    if (m_initializing[dense]) {
+        m_initializingCount--;
+    }
+
+    // Retire the slot: bumping the generation invalidates outstanding handles
+    uint32_t slot = m_denseToSlot[dense];
+    m_slotGenerations[slot]++;
+    m_slotToDense[slot] = INVALID_INDEX;
+    m_freeSlots.push_back(slot);
+
+    // Swap-remove the dense row to keep the columns packed
+    uint32_t last = static_cast<uint32_t>(m_instances.size() - 1);
+    if (dense != last) {
+        m_denseToSlot[dense] = m_denseToSlot[last];
+        m_instances[dense] = m_instances[last];
+        m_libraries[dense] = m_libraries[last];
+        m_createFuncs[dense] = m_createFuncs[last];
+        m_destroyFuncs[dense] = m_destroyFuncs[last];
+        m_interfaceVersions[dense] = m_interfaceVersions[last];
+        m_updateBatchFuncs[dense] = m_updateBatchFuncs[last];
+        m_functionTables[dense] = m_functionTables[last];
+        m_arenas[dense] = m_arenas[last];
+        m_serviceRegistries[dense] = m_serviceRegistries[last];
+        m_fileStamps[dense] = m_fileStamps[last];
+        m_contentHashes[dense] = m_contentHashes[last];
+        m_pendingStamps[dense] = m_pendingStamps[last];
+        m_pendingSince[dense] = m_pendingSince[last];
+        m_nameHashes[dense] = m_nameHashes[last];
+        m_names[dense] = m_names[last];
+        m_paths[dense] = std::move(m_paths[last]);
+        m_shadowPaths[dense] = std::move(m_shadowPaths[last]);
+        m_stateBuffers[dense] = std::move(m_stateBuffers[last]);
+        m_watchIds[dense] = m_watchIds[last];
+        m_updateAccess[dense] = std::move(m_updateAccess[last]);
+        m_updateStats[dense] = std::move(m_updateStats[last]);
+        m_loadSequence[dense] = m_loadSequence[last];
+        m_initPending[dense] = m_initPending[last];
+        m_initializing[dense] = m_initializing[last];
+        m_slotToDense[m_denseToSlot[dense]] = dense;
+    }
+
+    m_denseToSlot.pop_back();
+    m_instances.pop_back();
+    m_libraries.pop_back();
+    m_createFuncs.pop_back();
+    m_destroyFuncs.pop_back();
+    m_interfaceVersions.pop_back();
+    m_updateBatchFuncs.pop_back();
+    m_functionTables.pop_back();
+    m_arenas.pop_back();
+    m_serviceRegistries.pop_back();
+    m_fileStamps.pop_back();
+    m_contentHashes.pop_back();
+    m_pendingStamps.pop_back();
+    m_pendingSince.pop_back();
+    m_nameHashes.pop_back();
+    m_names.pop_back();
+    m_paths.pop_back();
+    m_shadowPaths.pop_back();
+    m_stateBuffers.pop_back();
+    m_watchIds.pop_back();
+    m_updateAccess.pop_back();
+    m_updateStats.pop_back();
+    m_loadSequence.pop_back();
+    m_initPending.pop_back();
+    m_initializing.pop_back();
+    m_updateGraphDirty = true;
+    m_updateBatchesDirty = true;
+}
+
+bool PluginManager::initializeAt(uint32_t dense) {
+    if (!m_instances[dense]->onLoad()) {
+        logMessage(LogLevel::Error, "Deferred plugin initialization failed: %s",
+                   m_paths[dense].c_str());
+        // Still marked pending, so the row is discarded without onUnload()
+        removeAt(dense);
+        return false;
+    }
+    m_initPending[dense] = 0;
+    m_pendingInitCount--;
+    if (detail::getInitStatus(*m_instances[dense], m_interfaceVersions[dense]) !=
+        InitStatus::Ready) {
+        m_initializing[dense] = 1;
+        m_initializingCount++;
+        m_updateGraphDirty = true;
+        m_updateBatchesDirty = true;
+    }
+    return true;
+}
+
+void PluginManager::reloadAt(uint32_t dense) {
+    logMessage(LogLevel::Info, "Plugin file modified, reloading: %s", m_paths[dense].c_str());
+
+    // Bring up the new version next to the old one on a worker, so a broken build changes
+    // nothing and a slow onLoad() does not stall the caller. A plugin that was never used
+    // is not initialized by a reload either.
+    const std::string& path = m_paths[dense];
+    const bool initialize = !m_initPending[dense];
+    const SymbolBinding binding =
+        m_loadPolicy == LoadPolicy::Deferred ? SymbolBinding::Lazy : SymbolBinding::Now;
+    FileStamp stamp;
+    uint64_t contentHash = 0;
+    detail::stampFile(path, m_contentHashing, stamp, contentHash);
+    // Do not retry this build on every check
+    m_fileStamps[dense] = stamp;
+    m_contentHashes[dense] = contentHash;
+
+    // A newer build supersedes one that is still loading or finishing its setup
+    cancelReload(m_denseToSlot[dense]);
+
+    detail::ModuleHost host;
+    host.messageBus = m_messageBus;
+    host.serviceRegistry = m_serviceRegistry;
+    auto pending = std::make_unique<PendingReload>();
+    pending->slot = m_denseToSlot[dense];
+    pending->initialize = initialize;
+    pending->result = std::async(std::launch::async, [path, initialize, binding, host]() {
+        detail::LoadedModule module;
+        std::string error;
+        if (detail::openShadowModule(path, module, error, nullptr, binding, &host) &&
+            initialize) {
+            // Discards the module on failure
+            detail::initModule(path, module, error);
+        }
+        return module;
+    });
+    m_pendingReloads.push_back(std::move(pending));
+}
+
+void PluginManager::replaceAt(uint32_t dense, const detail::LoadedModule& module,
+                              bool initialized) {
+    detail::StateBuffer state;
+    removeNameIndex(dense);
+    detail::LoadedModule old = moduleAt(dense);
+    if (initialized) {
+        detail::transferState(old, module, state);
+        detail::unloadModule(old);
+    } else {
+        detail::discardModule(old);
+    }
+    m_stateBuffers[dense] = std::move(state);
+
+    m_instances[dense] = module.instance;
+    m_libraries[dense] = module.handle;
+    m_createFuncs[dense] = module.createFunc;
+    m_destroyFuncs[dense] = module.destroyFunc;
+    m_interfaceVersions[dense] = module.interfaceVersion;
+    m_updateBatchFuncs[dense] = module.updateBatchFunc;
+    m_functionTables[dense] = module.functionTable;
+    m_arenas[dense] = module.arena;
+    m_serviceRegistries[dense] = module.serviceRegistry;
+    m_shadowPaths[dense] = module.shadowPath;
+    m_nameHashes[dense] = hashName(module.instance->getName());
+    m_names[dense] = module.instance->getName();
+    refreshUpdateBudget(dense);
+    if (m_initializing[dense]) {
+        // The new build finished its setup before it replaced the old one
+        m_initializing[dense] = 0;
+        m_initializingCount--;
+        m_updateGraphDirty = true;
+    }
+    m_updateBatchesDirty = true;
+    addNameIndex(dense);
+}
+
+void PluginManager::pollReloads() {
+    // Walk a private list: entries still running go back, everything else is settled here
+    std::vector<std::unique_ptr<PendingReload>> pendingReloads;
+    pendingReloads.swap(m_pendingReloads);
+    std::vector<PluginHandle> reloaded;
+    for (std::unique_ptr<PendingReload>& pending : pendingReloads) {
+        if (pending->result.valid()) {
+            if (pending->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                m_pendingReloads.push_back(std::move(pending));
+                continue;
+            }
+            pending->module = pending->result.get();
+        }
+        if (pending->cancelled) {
+            releaseReload(*pending);
+            continue;
+        }
+
+        const uint32_t dense = m_slotToDense[pending->slot];
+        const std::string& path = m_paths[dense];
+        detail::LoadedModule& module = pending->module;
+        if (!module.instance) {
+            logMessage(LogLevel::Warning, "Failed to reload plugin, keeping previous version: %s",
+                       path.c_str());
+            continue;
+        }
+        if (!pending->initialize && !m_initPending[dense]) {
+            // The running version was first used while this one loaded; catch up on a worker
+            pending->initialize = true;
+            pending->result = std::async(std::launch::async, [path, module]() mutable {
+                std::string error;
+                detail::initModule(path, module, error);
+                return module;
+            });
+            m_pendingReloads.push_back(std::move(pending));
+            continue;
+        }
+        if (pending->initialize) {
+            const InitStatus status =
+                detail::getInitStatus(*module.instance, module.interfaceVersion);
+            if (status == InitStatus::Initializing) {
+                m_pendingReloads.push_back(std::move(pending));
+                continue;
+            }
+            if (status == InitStatus::Failed) {
+                logMessage(LogLevel::Warning,
+                           "Reloaded plugin failed to initialize, keeping previous version: %s",
+                           path.c_str());
+                detail::unloadModule(module);
+                continue;
+            }
+        }
+
+        // Swapped between frames, so no update sees a half-replaced row
+        replaceAt(dense, module, pending->initialize);
+        logMessage(LogLevel::Info, "Reloaded plugin: %s", path.c_str());
+        PluginHandle handle;
+        handle.index = pending->slot;
+        handle.generation = m_slotGenerations[pending->slot];
+        reloaded.push_back(handle);
+    }
+
+    // Called once every entry is settled: a callback may reload or unload any plugin
+    if (m_reloadCallback) {
+        for (PluginHandle handle : reloaded) {
+            if (isValid(handle)) {
+                m_reloadCallback(handle);
+            }
+        }
+    }
+}
+
+void PluginManager::cancelReload(uint32_t slot) {
+    for (size_t i = 0; i < m_pendingReloads.size(); ++i) {
+        PendingReload& pending = *m_pendingReloads[i];
+        if (pending.slot != slot || pending.cancelled) {
+            continue;
+        }
+        if (pending.result.valid()) {
+            // The worker cannot be interrupted; pollReloads() drops the build once it is done
+            pending.cancelled = true;
+            return;
+        }
+        releaseReload(pending);
+        m_pendingReloads.erase(m_pendingReloads.begin() + i);
+        return;
+    }
+}
+
+void PluginManager::releaseReload(PendingReload& pending) {
+    if (pending.result.valid()) {
+        pending.module = pending.result.get();
+    }
+    if (!pending.module.instance) {
+        return;
+    }
+    if (pending.initialize) {
+        detail::unloadModule(pending.module);
+    } else {
+        detail::discardModule(pending.module);
+    }
+}
+
+bool PluginManager::isReloadPending(PluginHandle handle) const {
+    if (denseIndex(handle) == INVALID_INDEX) {
+        return false;
+    }
+    for (const auto& pending : m_pendingReloads) {
+        if (pending->slot == handle.index && !pending->cancelled) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PluginManager::AsyncLoad* PluginManager::findAsyncLoad(PluginHandle handle) {
+    if (handle.index >= m_slotGenerations.size() ||
+        m_slotGenerations[handle.index] != handle.generation) {
+        return nullptr;
+    }
+    for (auto& load : m_asyncLoads) {
+        if (load->slot == handle.index && !load->cancelled) {
+            return load.get();
+        }
+    }
+    return nullptr;
+}
+
+bool PluginManager::adoptAsyncLoad(AsyncLoad& load) {
+    detail::LoadedModule module = load.result.get();
+    if (load.cancelled || !module.instance) {
+        if (module.instance) {
+            if (load.deferred) {
+                detail::discardModule(module);
+            } else {
+                detail::unloadModule(module);
+            }
+        }
+        // A cancelled load already retired its handle
+        if (!load.cancelled) {
+            m_slotGenerations[load.slot]++;
+        }
+        m_freeSlots.push_back(load.slot);
+        return false;
+    }
+
+    uint32_t dense = denseIndex(addPlugin(load.path, module, !load.deferred, load.slot));
+    return !m_initPending[dense] && !m_initializing[dense];
+}
+
+detail::LoadedModule PluginManager::moduleAt(uint32_t dense) const {
+    detail::LoadedModule module;
+    module.handle = m_libraries[dense];
+    module.instance = m_instances[dense];
+    module.createFunc = m_createFuncs[dense];
+    module.destroyFunc = m_destroyFuncs[dense];
+    module.interfaceVersion = m_interfaceVersions[dense];
+    module.updateBatchFunc = m_updateBatchFuncs[dense];
+    module.functionTable = m_functionTables[dense];
+    module.arena = m_arenas[dense];
+    module.serviceRegistry = m_serviceRegistries[dense];
+    module.shadowPath = m_shadowPaths[dense];
+    return module;
+}
+
+size_t PluginManager::reloadByFileStamp() {
+    size_t started = 0;
+    m_settlingSlots.clear();
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        if (!hasFileChanged(dense, false)) {
+            if (m_pendingStamps[dense].exists) {
+                m_settlingSlots.push_back(m_denseToSlot[dense]);
+            }
+            continue;
+        }
+        reloadAt(dense);
+        ++started;
+    }
+    return started;
+}
+
+bool PluginManager::hasFileChanged(uint32_t dense, bool replaced) {
+    const std::string& path = m_paths[dense];
+    FileStamp stamp = getFileStamp(path);
+    // A missing file is mid-replacement or deleted; keep the loaded version
+    if (!stamp.exists || stamp == m_fileStamps[dense]) {
+        m_pendingStamps[dense] = FileStamp();
+        return false;
+    }
+
+    if (!replaced && !detail::isWriteSettled(stamp, m_pendingStamps[dense], m_pendingSince[dense],
+                                             m_reloadDebounce)) {
+        return false;
+    }
+    m_pendingStamps[dense] = FileStamp();
+
+    if (m_contentHashing && m_contentHashes[dense] != 0) {
+        uint64_t hash = 0;
+        if (hashFileContents(path, hash) && hash == m_contentHashes[dense]) {
+            logMessage(LogLevel::Debug, "Plugin file touched but unchanged, not reloading: %s",
+                       path.c_str());
+            m_fileStamps[dense] = stamp;
+            return false;
+        }
+    }
+    return true;
+}
+
+void PluginManager::rebuildUpdateGraph() {
+    m_updateOrder.clear();
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        if (!m_initializing[dense]) {
+            m_updateOrder.push_back(dense);
+        }
+    }
+    std::sort(m_updateOrder.begin(), m_updateOrder.end(), [this](uint32_t a, uint32_t b) {
+        return m_loadSequence[a] < m_loadSequence[b];
+    });
+
+    std::vector<UpdateAccess> accesses;
+    accesses.reserve(m_updateOrder.size());
+    for (uint32_t dense : m_updateOrder) {
+        accesses.push_back(m_updateAccess[dense]);
+    }
+    m_updateScheduler->build(accesses);
+    m_updateGraphDirty = false;
+}
+
+void PluginManager::rebuildUpdateBatches() {
+    // Assign every row to a batch, then lay the instances of each batch out contiguously.
+    // Rows are grouped by their batch entry point; the function table takes precedence.
+    // Plugins that are still initializing are left out until they are ready.
+    std::unordered_map<uintptr_t, uint32_t> batchIndex;
+    std::vector<uint32_t> rowBatch(m_instances.size(), INVALID_INDEX);
+    m_updateBatches.clear();
+    uint32_t updated = 0;
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        if (m_initializing[dense]) {
+            continue;
+        }
+        ++updated;
+        UpdateBatch batch;
+        batch.table = m_functionTables[dense];
+        batch.func = batch.table ? nullptr : m_updateBatchFuncs[dense];
+        batch.count = 1;
+
+        uintptr_t key = 0;
+        if (batch.table && batch.table->updateBatch) {
+            key = reinterpret_cast<uintptr_t>(batch.table->updateBatch);
+        } else if (batch.func) {
+            key = reinterpret_cast<uintptr_t>(batch.func);
+        }
+        uint32_t index = static_cast<uint32_t>(m_updateBatches.size());
+        if (key != 0) {
+            auto inserted = batchIndex.emplace(key, index);
+            if (!inserted.second) {
+                rowBatch[dense] = inserted.first->second;
+                m_updateBatches[rowBatch[dense]].count++;
+                continue;
+            }
+        }
+        m_updateBatches.push_back(batch);
+        rowBatch[dense] = index;
+    }
+
+    uint32_t first = 0;
+    for (UpdateBatch& batch : m_updateBatches) {
+        batch.first = first;
+        first += batch.count;
+        batch.count = 0;
+    }
+    m_batchInstances.resize(updated);
+    m_batchHandles.resize(updated);
+    m_batchRows.resize(updated);
+    for (uint32_t dense = 0; dense < m_instances.size(); ++dense) {
+        if (rowBatch[dense] == INVALID_INDEX) {
+            continue;
+        }
+        UpdateBatch& batch = m_updateBatches[rowBatch[dense]];
+        uint32_t position = batch.first + batch.count++;
+        m_batchInstances[position] = m_instances[dense];
+        m_batchHandles[position] = m_instances[dense];
+        m_batchRows[position] = dense;
+    }
+    m_updateBatchesDirty = false;
+}
+
+void PluginManager::callBatch(const UpdateBatch& batch, float deltaTime) {
+    if (batch.table) {
+        if (batch.table->updateBatch) {
+            batch.table->updateBatch(m_batchHandles.data() + batch.first, batch.count, deltaTime);
+        } else {
+            batch.table->update(m_batchHandles[batch.first], deltaTime);
+        }
+    } else if (batch.func) {
+        batch.func(m_batchInstances.data() + batch.first, batch.count, deltaTime);
+    } else {
+        m_batchInstances[batch.first]->onUpdate(deltaTime);
+    }
+}
+
+void PluginManager::updateBatchesTimed(float deltaTime) {
+    UpdateWatchdog* watchdog = m_watchdog.get();
+    for (const UpdateBatch& batch : m_updateBatches) {
+        const uint32_t* rows = m_batchRows.data() + batch.first;
+        if (watchdog) {
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                watchdog->begin(rows[i]);
+            }
+        }
+        auto start = std::chrono::steady_clock::now();
+        callBatch(batch, deltaTime);
+        std::chrono::nanoseconds duration = std::chrono::steady_clock::now() - start;
+        if (watchdog) {
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                watchdog->end(rows[i]);
+            }
+        }
+
+        // A batch entry point is timed as a whole
+        const std::chrono::nanoseconds share = duration / batch.count;
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            recordUpdate(rows[i], share);
+        }
+    }
+}
+
+void PluginManager::recordUpdate(uint32_t dense, std::chrono::nanoseconds duration) {
+    UpdateStatsRow& row = m_updateStats[dense];
+    UpdateStats& stats = row.stats;
+    stats.updateCount++;
+    stats.lastDuration = duration;
+    stats.maxDuration = std::max(stats.maxDuration, duration);
+    stats.totalDuration += duration;
+
+    if (!row.histogram) {
+        row.histogram = std::make_unique<LatencyHistogram>();
+    }
+    row.histogram->record(duration);
+
+    if (row.budget.count() > 0 && duration > row.budget) {
+        stats.overBudgetCount++;
+        row.overrun = duration;
+        m_pendingOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PluginManager::reportOverruns() {
+    // Collect them first; the callback may load or unload plugins
+    m_overruns.clear();
+    for (uint32_t dense = 0; dense < m_updateStats.size(); ++dense) {
+        UpdateStatsRow& row = m_updateStats[dense];
+        if (row.overrun.count() == 0) {
+            continue;
+        }
+        UpdateOverrun overrun;
+        overrun.handle = getHandleAt(dense);
+        overrun.duration = row.overrun;
+        overrun.limit = row.budget;
+        m_overruns.push_back(overrun);
+        row.overrun = std::chrono::nanoseconds::zero();
+    }
+    m_pendingOverruns.store(0, std::memory_order_relaxed);
+
+    if (!m_budgetCallback) {
+        return;
+    }
+    for (UpdateOverrun& overrun : m_overruns) {
+        uint32_t dense = denseIndex(overrun.handle);
+        if (dense == INVALID_INDEX) {
+            // Unloaded by an earlier call of the callback
+            continue;
+        }
+        overrun.name = m_names[dense];
+        m_budgetCallback(overrun);
+    }
+}
+
+void PluginManager::refreshUpdateBudget(uint32_t dense) {
+    UpdateStatsRow& row = m_updateStats[dense];
+    if (!row.budgetOverridden) {
+        row.budget = detail::getUpdateBudget(*m_instances[dense], m_interfaceVersions[dense]);
+    }
+}
+
+void PluginManager::watchRow(uint32_t dense) {
+    if (!m_fileWatcher) {
+        return;
+    }
+    uint32_t fileId = m_fileWatcher->watchFile(m_paths[dense]);
+    m_watchIds[dense] = fileId;
+    if (fileId != FileWatcher::INVALID_FILE_ID) {
+        m_watchIdToSlot[fileId] = m_denseToSlot[dense];
+    }
+}
+
+void PluginManager::unwatchRow(uint32_t dense) {
+    uint32_t fileId = m_watchIds[dense];
+    if (!m_fileWatcher || fileId == FileWatcher::INVALID_FILE_ID) {
+        return;
+    }
+    m_fileWatcher->unwatchFile(fileId);
+    m_watchIdToSlot.erase(fileId);
+    m_watchIds[dense] = FileWatcher::INVALID_FILE_ID;
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,151 @@
+#include "hotplugpp/plugin_metadata.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__ELF__)
+#include <elf.h>
+#endif
+
+namespace hotplugpp {
+
+namespace {
+
+#if defined(__ELF__)
+
+bool readAt(std::ifstream& file, uint64_t offset, void* buffer, size_t size) {
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Locate a section by name
+ * @param file Open ELF file
+ * @param fileSize Size of the file, every offset is checked against it
+ * @param name Section name
+ * @param offset Receives the file offset of the section
+ * @param size Receives the size of the section
+ * @return true if the section exists and lies within the file
+ */
+template <typename Ehdr, typename Shdr>
+bool findSection(std::ifstream& file, uint64_t fileSize, const char* name, uint64_t& offset,
+                 uint64_t& size) {
+    Ehdr header;
+    if (!readAt(file, 0, &header, sizeof(header)) || header.e_shentsize != sizeof(Shdr) ||
+        header.e_shnum == 0 || header.e_shstrndx >= header.e_shnum) {
+        return false;
+    }
+    const uint64_t tableSize = static_cast<uint64_t>(header.e_shnum) * sizeof(Shdr);
+    if (header.e_shoff > fileSize || tableSize > fileSize - header.e_shoff) {
+        return false;
+    }
+
+    std::vector<Shdr> sections(header.e_shnum);
+    if (!readAt(file, header.e_shoff, sections.data(), tableSize)) {
+        return false;
+    }
+
+    const Shdr& names = sections[header.e_shstrndx];
+    if (names.sh_offset > fileSize || names.sh_size > fileSize - names.sh_offset) {
+        return false;
+    }
+    std::vector<char> strings(names.sh_size);
+    if (!readAt(file, names.sh_offset, strings.data(), strings.size())) {
+        return false;
+    }
+
+    const size_t nameLength = std::strlen(name);
+    for (const Shdr& section : sections) {
+        if (section.sh_type == SHT_NOBITS || section.sh_name >= strings.size() ||
+            strings.size() - section.sh_name <= nameLength ||
+            std::memcmp(&strings[section.sh_name], name, nameLength + 1) != 0) {
+            continue;
+        }
+        if (section.sh_offset > fileSize || section.sh_size > fileSize - section.sh_offset) {
+            return false;
+        }
+        offset = section.sh_offset;
+        size = section.sh_size;
+        return true;
+    }
+    return false;
+}
+
+bool hostMatches(const unsigned char* ident) {
+    const uint16_t probe = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    const unsigned char hostData = firstByte == 1 ? ELFDATA2LSB : ELFDATA2MSB;
+    return std::memcmp(ident, ELFMAG, SELFMAG) == 0 && ident[EI_DATA] == hostData;
+}
+
+std::string boundedString(const char* chars, size_t capacity) {
+    size_t length = 0;
+    while (length < capacity && chars[length] != '\0') {
+        ++length;
+    }
+    return std::string(chars, length);
+}
+
+#endif
+
+} // namespace
+
+bool readPluginMetadata(const std::string& path, PluginMetadata& metadata) {
+#if defined(__ELF__)
+    // Plain reads rather than mmap: a linker truncating the file must not raise SIGBUS
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    const std::streamoff end = file.tellg();
+    if (end < EI_NIDENT) {
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(end);
+
+    unsigned char ident[EI_NIDENT];
+    if (!readAt(file, 0, ident, sizeof(ident)) || !hostMatches(ident)) {
+        return false;
+    }
+
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    bool found = false;
+    if (ident[EI_CLASS] == ELFCLASS64) {
+        found = findSection<Elf64_Ehdr, Elf64_Shdr>(file, fileSize, HOTPLUGPP_METADATA_SECTION,
+                                                    offset, size);
+    } else if (ident[EI_CLASS] == ELFCLASS32) {
+        found = findSection<Elf32_Ehdr, Elf32_Shdr>(file, fileSize, HOTPLUGPP_METADATA_SECTION,
+                                                    offset, size);
+    }
+    if (!found || size < sizeof(HotPlugPPMetadata)) {
+        return false;
+    }
+
+    HotPlugPPMetadata record;
+    if (!readAt(file, offset, &record, sizeof(record))) {
+        return false;
+    }
+    const bool valid = std::memcmp(record.magic, HOTPLUGPP_METADATA_MAGIC,
+                                   sizeof(HOTPLUGPP_METADATA_MAGIC)) == 0 &&
+                       record.formatVersion == HOTPLUGPP_METADATA_VERSION &&
+                       record.size == sizeof(HotPlugPPMetadata);
+    if (!valid) {
+        return false;
+    }
+
+    metadata.name = boundedString(record.name, sizeof(record.name));
+    metadata.version = Version(record.versionMajor, record.versionMinor, record.versionPatch);
+    metadata.description = boundedString(record.description, sizeof(record.description));
+    return true;
+#else
+    (void)path;
+    (void)metadata;
+    return false;
+#endif
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,348 @@
+#include "plugin_module.hpp"
+
+#include "hotplugpp/log.hpp"
+#include "library_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define HOTPLUGPP_GETPID _getpid
+#else
+#include <unistd.h>
+#define HOTPLUGPP_GETPID getpid
+#endif
+
+namespace hotplugpp {
+namespace detail {
+
+namespace {
+
+/// How often awaitInit() asks a plugin whether its setup has finished
+constexpr std::chrono::milliseconds INIT_POLL_INTERVAL(1);
+
+/**
+ * @brief Create an instance from a library taken from the cache
+ *
+ * Releases the library reference on failure.
+ */
+bool createInstance(const std::string& path, LibraryHandle handle, const LibraryExports& exports,
+                    LoadedModule& module, std::string& error, PhaseTimings* timings,
+                    const ModuleHost* host) {
+    // Before the constructor runs, so the instance can use them from the start; a reloaded
+    // build gets them again this way. Null is passed too, since a library may outlive its
+    // previous host objects when the loader keeps it mapped
+    MessageBus* messageBus = host ? host->messageBus : nullptr;
+    if (exports.attachMessageBusFunc) {
+        exports.attachMessageBusFunc(messageBus);
+    }
+    ServiceRegistry* serviceRegistry = host ? host->serviceRegistry : nullptr;
+    if (exports.attachServiceRegistryFunc) {
+        exports.attachServiceRegistryFunc(serviceRegistry);
+    }
+
+    // Create plugin instance, inside its own arena if the plugin supports one
+    IPlugin* plugin;
+    Arena* arena = nullptr;
+    DestroyPluginFunc destroyFunc = exports.destroyFunc;
+    {
+        ScopedPhaseTimer timer(timings, LoadPhase::CreateInstance);
+        if (exports.createWithAllocatorFunc && exports.destroyWithAllocatorFunc) {
+            arena = new Arena();
+            plugin = exports.createWithAllocatorFunc(arena->getAllocator());
+            destroyFunc = exports.destroyWithAllocatorFunc;
+        } else {
+            plugin = exports.createFunc();
+        }
+    }
+    if (!plugin) {
+        error = "createPlugin returned null";
+        logMessage(LogLevel::Error, "Failed to create plugin instance from: %s", path.c_str());
+        delete arena;
+        releaseLibrary(handle);
+        return false;
+    }
+
+    module.handle = handle;
+    module.instance = plugin;
+    module.createFunc = exports.createFunc;
+    module.destroyFunc = destroyFunc;
+    module.interfaceVersion = exports.interfaceVersion;
+    module.updateBatchFunc = exports.updateBatchFunc;
+    module.functionTable = exports.functionTable;
+    module.arena = arena;
+    module.serviceRegistry = serviceRegistry;
+    return true;
+}
+
+/**
+ * @brief Withdraw what the instance provided, so nobody calls into it any more
+ */
+void revokeServices(LoadedModule& module) {
+    if (module.serviceRegistry && module.instance) {
+        module.serviceRegistry->revoke(module.instance);
+    }
+    module.serviceRegistry = nullptr;
+}
+
+} // namespace
+
+InitStatus getInitStatus(IPlugin& plugin, uint32_t interfaceVersion) {
+    return interfaceVersion >= INTERFACE_INIT_STATUS ? plugin.getInitStatus()
+                                                     : InitStatus::Ready;
+}
+
+std::chrono::microseconds getUpdateBudget(const IPlugin& plugin, uint32_t interfaceVersion) {
+    return interfaceVersion >= INTERFACE_UPDATE_BUDGET ? plugin.getUpdateBudget()
+                                                       : std::chrono::microseconds::zero();
+}
+
+bool openModule(const std::string& path, LoadedModule& module, std::string& error,
+                PhaseTimings* timings, SymbolBinding binding, const ModuleHost* host) {
+    // Load the shared library, or share the copy other instances already opened
+    LibraryExports exports;
+    LibraryHandle handle = acquireLibrary(path, exports, error, timings, binding);
+    if (!handle) {
+        return false;
+    }
+    return createInstance(path, handle, exports, module, error, timings, host);
+}
+
+bool openShadowModule(const std::string& path, LoadedModule& module, std::string& error,
+                      PhaseTimings* timings, SymbolBinding binding, const ModuleHost* host) {
+    namespace fs = std::filesystem;
+    static std::atomic<uint64_t> s_shadowCounter{0};
+
+    // Copies are shared by file version, so reloading N instances of a plugin copies and opens
+    // the new build once and keeps them in one update batch
+    const FileStamp stamp = getFileStamp(path);
+    const std::string key = "shadow|" + getLibraryKey(path) + '|' +
+                            std::to_string(stamp.modifiedNs) + ':' + std::to_string(stamp.size);
+
+    LibraryExports exports;
+    std::string libraryPath;
+    const auto lookupStart = std::chrono::steady_clock::now();
+    LibraryHandle handle = findLibrary(key, exports, libraryPath);
+    if (handle && timings) {
+        timings->record(LoadPhase::LoadLibrary, std::chrono::steady_clock::now() - lookupStart);
+    }
+
+    if (!handle) {
+        std::error_code ec;
+        fs::path source(path);
+        fs::path dir = fs::temp_directory_path(ec) / "hotplugpp-shadow";
+        fs::create_directories(dir, ec);
+
+        // <stem>.<pid>.<counter><ext> keeps copies of concurrent hosts and reloads apart
+        fs::path shadow =
+            dir / (source.stem().string() + "." + std::to_string(HOTPLUGPP_GETPID()) + "." +
+                   std::to_string(s_shadowCounter.fetch_add(1)) + source.extension().string());
+        bool copied;
+        {
+            ScopedPhaseTimer timer(timings, LoadPhase::CopyLibrary);
+            copied = fs::copy_file(source, shadow, fs::copy_options::overwrite_existing, ec);
+        }
+        if (!copied) {
+            error = "Failed to create shadow copy: " + ec.message();
+            logMessage(LogLevel::Error, "Failed to create shadow copy of: %s (%s)", path.c_str(),
+                       error.c_str());
+            return false;
+        }
+
+#ifdef _WIN32
+        // Windows keeps the file locked while it is loaded; the cache deletes it on last release
+        const bool removeOnRelease = true;
+#else
+        const bool removeOnRelease = false;
+#endif
+        handle = acquireLibrary(key, shadow.string(), removeOnRelease, exports, libraryPath,
+                                error, timings, binding);
+        if (!handle) {
+            fs::remove(shadow, ec);
+            return false;
+        }
+
+#ifndef _WIN32
+        // The mapping keeps the image alive, the directory entry is no longer needed
+        fs::remove(shadow, ec);
+#else
+        // Another thread opened the same version first and its copy is shared instead
+        if (libraryPath != shadow.string()) {
+            fs::remove(shadow, ec);
+        }
+#endif
+    }
+
+    LoadedModule opened;
+    if (!createInstance(path, handle, exports, opened, error, timings, host)) {
+        return false;
+    }
+#ifdef _WIN32
+    opened.shadowPath = libraryPath;
+#endif
+
+    module = opened;
+    return true;
+}
+
+bool initModule(const std::string& path, LoadedModule& module, std::string& error,
+                PhaseTimings* timings) {
+    bool loaded;
+    {
+        ScopedPhaseTimer timer(timings, LoadPhase::OnLoad);
+        loaded = module.instance->onLoad();
+    }
+    if (!loaded) {
+        error = "onLoad returned false";
+        logMessage(LogLevel::Error, "Plugin initialization failed: %s", path.c_str());
+        discardModule(module, timings);
+        return false;
+    }
+    return true;
+}
+
+bool awaitInit(const std::string& path, LoadedModule& module, std::string& error,
+               PhaseTimings* timings, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    InitStatus status;
+    while ((status = getInitStatus(*module.instance, module.interfaceVersion)) ==
+           InitStatus::Initializing) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            error = "Asynchronous initialization timed out";
+            logMessage(LogLevel::Error, "Plugin initialization timed out after %lld ms: %s",
+                       static_cast<long long>(timeout.count()), path.c_str());
+            unloadModule(module, timings);
+            return false;
+        }
+        std::this_thread::sleep_for(INIT_POLL_INTERVAL);
+    }
+    if (status == InitStatus::Failed) {
+        error = "Asynchronous initialization failed";
+        logMessage(LogLevel::Error, "Plugin initialization failed: %s", path.c_str());
+        unloadModule(module, timings);
+        return false;
+    }
+    return true;
+}
+
+bool loadModule(const std::string& path, LoadedModule& module, PhaseTimings* timings,
+                const ModuleHost* host) {
+    std::string error;
+    LoadedModule opened;
+    if (!openModule(path, opened, error, timings, SymbolBinding::Now, host) ||
+        !initModule(path, opened, error, timings)) {
+        return false;
+    }
+    module = opened;
+    return true;
+}
+
+bool loadShadowModule(const std::string& path, LoadedModule& module, std::string& error,
+                      PhaseTimings* timings, SymbolBinding binding, const ModuleHost* host) {
+    LoadedModule opened;
+    if (!openShadowModule(path, opened, error, timings, binding, host) ||
+        !initModule(path, opened, error, timings) || !awaitInit(path, opened, error, timings)) {
+        return false;
+    }
+    module = opened;
+    return true;
+}
+
+void unloadModule(LoadedModule& module, PhaseTimings* timings) {
+    revokeServices(module);
+
+    // Call plugin cleanup
+    if (module.instance) {
+        ScopedPhaseTimer timer(timings, LoadPhase::OnUnload);
+        module.instance->onUnload();
+    }
+    discardModule(module, timings);
+}
+
+void discardModule(LoadedModule& module, PhaseTimings* timings) {
+    revokeServices(module);
+
+    // Destroy plugin instance
+    if (module.instance && module.destroyFunc) {
+        ScopedPhaseTimer timer(timings, LoadPhase::DestroyInstance);
+        module.destroyFunc(module.instance);
+    }
+    // Frees everything the instance allocated, leaks included, in one step
+    delete module.arena;
+
+    // Unload library once no other instance uses it
+    if (module.handle) {
+        ScopedPhaseTimer timer(timings, LoadPhase::UnloadLibrary);
+        releaseLibrary(module.handle);
+    }
+
+    module = LoadedModule();
+}
+
+bool hasTransferableState(const LoadedModule& from, const LoadedModule& to) {
+    return from.interfaceVersion >= INTERFACE_STATE_HANDOFF &&
+           to.interfaceVersion >= INTERFACE_STATE_HANDOFF &&
+           from.instance->getStateVersion() != 0 && to.instance->getStateVersion() != 0;
+}
+
+bool transferState(const LoadedModule& fromModule, const LoadedModule& toModule,
+                   StateBuffer& state, PhaseTimings* timings) {
+    if (!hasTransferableState(fromModule, toModule)) {
+        return false;
+    }
+    IPlugin& from = *fromModule.instance;
+    IPlugin& to = *toModule.instance;
+    const uint32_t version = from.getStateVersion();
+
+    ScopedPhaseTimer timer(timings, LoadPhase::TransferState);
+
+    // One allocation sized by the plugin; nothing is serialized on the host side
+    const size_t size = from.getStateSize();
+    const size_t blocks = (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    StateBuffer saved(new std::max_align_t[blocks > 0 ? blocks : 1]);
+    if (!from.saveState(saved.get(), size)) {
+        logMessage(LogLevel::Warning, "Failed to save plugin state: %s", from.getName());
+        return false;
+    }
+    if (!to.loadState(saved.get(), size, version)) {
+        logMessage(LogLevel::Warning, "Plugin did not accept state version %u, starting fresh: %s",
+                   version, to.getName());
+        return false;
+    }
+
+    state = std::move(saved);
+    return true;
+}
+
+void stampFile(const std::string& path, bool hashContents, FileStamp& stamp,
+               uint64_t& contentHash) {
+    stamp = getFileStamp(path);
+    contentHash = 0;
+    if (hashContents) {
+        hashFileContents(path, contentHash);
+    }
+}
+
+bool isWriteSettled(const FileStamp& stamp, FileStamp& pendingStamp,
+                    std::chrono::steady_clock::time_point& pendingSince,
+                    std::chrono::milliseconds debounce) {
+    if (debounce.count() <= 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (stamp != pendingStamp) {
+        // First sight of this version, or the writer is still at it
+        pendingStamp = stamp;
+        pendingSince = now;
+        return false;
+    }
+    return now - pendingSince >= debounce;
+}
+
+} // namespace detail
+} // namespace hotplugpp
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "hotplugpp/arena.hpp"
+#include "hotplugpp/file_stamp.hpp"
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/message_bus.hpp"
+#include "hotplugpp/phase_timings.hpp"
+#include "hotplugpp/service_registry.hpp"
+#include "hotplugpp/shared_library.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace hotplugpp {
+namespace detail {
+
+/**
+ * @brief Library handle, factory functions and instance of one loaded plugin
+ *
+ * Shared by PluginLoader and PluginManager so both go through the same
+ * load/unload pipeline.
+ */
+struct LoadedModule {
+    /// Reference into the process-wide library cache, shared by instances of the same file
+    LibraryHandle handle = nullptr;
+    IPlugin* instance = nullptr;
+    CreatePluginFunc createFunc = nullptr;
+    DestroyPluginFunc destroyFunc = nullptr;
+    /// HOTPLUGPP_INTERFACE_VERSION of the library; hooks it lacks are not called
+    uint32_t interfaceVersion = 1;
+    /// Optional updatePluginBatch export, nullptr if the library has none
+    UpdateBatchFunc updateBatchFunc = nullptr;
+    /// Optional C function table, nullptr if the library has none or it is incompatible
+    const HotPlugPPFunctionTable* functionTable = nullptr;
+    /// Memory of the instance if the plugin supports host allocation; owned, freed on discard
+    Arena* arena = nullptr;
+    /// Private copy of the library the module was opened from while it still exists; removed
+    /// once no instance uses it
+    std::string shadowPath;
+    /// Registry the instance may have provided services to; they are revoked on unload
+    ServiceRegistry* serviceRegistry = nullptr;
+};
+
+/// First HOTPLUGPP_INTERFACE_VERSION declaring each optional IPlugin hook
+constexpr uint32_t INTERFACE_STATE_HANDOFF = 2;
+constexpr uint32_t INTERFACE_INIT_STATUS = 3;
+constexpr uint32_t INTERFACE_UPDATE_BUDGET = 4;
+
+/**
+ * @brief Call IPlugin::getInitStatus() if the plugin declares it
+ * @param plugin Plugin instance
+ * @param interfaceVersion Interface version of its library
+ * @return Initialization progress, InitStatus::Ready for older plugins
+ */
+InitStatus getInitStatus(IPlugin& plugin, uint32_t interfaceVersion);
+
+/**
+ * @brief Call IPlugin::getUpdateBudget() if the plugin declares it
+ * @param plugin Plugin instance
+ * @param interfaceVersion Interface version of its library
+ * @return Declared budget, zero for older plugins
+ */
+std::chrono::microseconds getUpdateBudget(const IPlugin& plugin, uint32_t interfaceVersion);
+
+/**
+ * @brief Host objects handed to a library before each instance is created
+ */
+struct ModuleHost {
+    /// Passed to hotplugppAttachMessageBus if the library exports it
+    MessageBus* messageBus = nullptr;
+    /// Passed to hotplugppAttachServiceRegistry if the library exports it
+    ServiceRegistry* serviceRegistry = nullptr;
+};
+
+/**
+ * @brief Open a plugin library, resolve its factories and create an instance
+ *
+ * onLoad() is not called; use initModule() for that. A library that is
+ * already open in this process is shared, so further instances only cost
+ * a createPlugin() call. Safe to call from several threads at once.
+ *
+ * @param path Path to the plugin library
+ * @param module Receives the opened module on success, untouched on failure
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of each phase, may be null
+ * @param binding Symbol binding if the library is not open yet
+ * @param host Host objects to attach, may be null
+ * @return true if the instance was created
+ */
+bool openModule(const std::string& path, LoadedModule& module, std::string& error,
+                PhaseTimings* timings = nullptr, SymbolBinding binding = SymbolBinding::Now,
+                const ModuleHost* host = nullptr);
+
+/**
+ * @brief Open a private copy of a plugin library
+ *
+ * The dynamic loader hands out the already mapped image when the same path
+ * is opened twice, so a new build can only coexist with the old one when it
+ * is loaded from a different path. The copy is deleted again as soon as the
+ * platform allows it.
+ *
+ * @param path Path to the plugin library
+ * @param module Receives the opened module on success, untouched on failure
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of each phase, may be null
+ * @param binding Symbol binding if the copy is not open yet
+ * @param host Host objects to attach, may be null
+ * @return true if the instance was created
+ */
+bool openShadowModule(const std::string& path, LoadedModule& module, std::string& error,
+                      PhaseTimings* timings = nullptr, SymbolBinding binding = SymbolBinding::Now,
+                      const ModuleHost* host = nullptr);
+
+/**
+ * @brief Call onLoad() on an opened module
+ *
+ * On failure the module is discarded.
+ *
+ * @param path Path the module was opened from, used for diagnostics
+ * @param module Module returned by openModule()
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of each phase, may be null
+ * @return true if onLoad() succeeded
+ */
+bool initModule(const std::string& path, LoadedModule& module, std::string& error,
+                PhaseTimings* timings = nullptr);
+
+/// How long awaitInit() waits for a plugin to leave InitStatus::Initializing
+constexpr std::chrono::milliseconds DEFAULT_INIT_TIMEOUT(10000);
+
+/**
+ * @brief Wait for an initialized module to finish its asynchronous setup
+ *
+ * Polls IPlugin::getInitStatus() until the plugin stops reporting
+ * InitStatus::Initializing. On failure or timeout the module is unloaded.
+ * Blocks the calling thread, so only call it on a worker or where the
+ * caller asked to block.
+ *
+ * @param path Path the module was opened from, used for diagnostics
+ * @param module Module whose onLoad() succeeded
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of each phase, may be null
+ * @param timeout Longest time to wait for the plugin to become ready
+ * @return true if the plugin is ready
+ */
+bool awaitInit(const std::string& path, LoadedModule& module, std::string& error,
+               PhaseTimings* timings = nullptr,
+               std::chrono::milliseconds timeout = DEFAULT_INIT_TIMEOUT);
+
+/**
+ * @brief Open a plugin library, resolve its factories and initialize an instance
+ * @param path Path to the plugin library
+ * @param module Receives the loaded module on success, untouched on failure
+ * @param timings Receives the duration of each phase, may be null
+ * @param host Host objects to attach, may be null
+ * @return true if the plugin is loaded and onLoad() succeeded
+ */
+bool loadModule(const std::string& path, LoadedModule& module, PhaseTimings* timings = nullptr,
+                const ModuleHost* host = nullptr);
+
+/**
+ * @brief Load and initialize a private copy of a plugin library
+ *
+ * Used for reloads, where the previous version is still loaded. Waits for
+ * asynchronous setup to finish, see awaitInit(), so the new version is
+ * ready when it replaces the old one; call it on a worker thread unless
+ * the caller asked to block.
+ *
+ * @param path Path to the plugin library
+ * @param module Receives the loaded module on success, untouched on failure
+ * @param error Receives a description of the failure
+ * @param timings Receives the duration of each phase, may be null
+ * @param binding Symbol binding if the copy is not open yet
+ * @param host Host objects to attach, may be null
+ * @return true if the plugin is loaded, onLoad() succeeded and the plugin is ready
+ */
+bool loadShadowModule(const std::string& path, LoadedModule& module, std::string& error,
+                      PhaseTimings* timings = nullptr, SymbolBinding binding = SymbolBinding::Now,
+                      const ModuleHost* host = nullptr);
+
+/**
+ * @brief Revoke the services, call onUnload(), destroy the instance and release the library
+ * @param module Module to unload, reset to its default state afterwards
+ * @param timings Receives the duration of each phase, may be null
+ */
+void unloadModule(LoadedModule& module, PhaseTimings* timings = nullptr);
+
+/**
+ * @brief Revoke the services, destroy the instance and release the library without calling
+ * onUnload()
+ *
+ * Used for modules whose onLoad() never ran or failed.
+ *
+ * @param module Module to discard, reset to its default state afterwards
+ * @param timings Receives the duration of each phase, may be null
+ */
+void discardModule(LoadedModule& module, PhaseTimings* timings = nullptr);
+
+/// Host-owned storage for state handed over across a reload
+using StateBuffer = std::unique_ptr<std::max_align_t[]>;
+
+/**
+ * @brief Hand the state of a running instance over to its replacement
+ *
+ * Must be called before @p from is unloaded. The new instance may keep
+ * pointers into the saved state, so the caller has to keep @p state alive
+ * for as long as @p to is loaded, and must not release the buffer the old
+ * instance received until that one is unloaded.
+ *
+ * Nothing is handed over unless both libraries declare the state hooks.
+ *
+ * @param from Module being replaced
+ * @param to Initialized replacement
+ * @param state Receives the saved state on success
+ * @param timings Receives the duration of the handoff, may be null
+ * @return true if @p to adopted the state
+ */
+bool transferState(const LoadedModule& from, const LoadedModule& to, StateBuffer& state,
+                   PhaseTimings* timings = nullptr);
+
+/**
+ * @brief Check whether both modules keep state that transferState() would hand over
+ * @param from Module being replaced
+ * @param to Replacement
+ * @return true if both declare the state hooks and report a state version
+ */
+bool hasTransferableState(const LoadedModule& from, const LoadedModule& to);
+
+/**
+ * @brief Record which version of a plugin file is about to be loaded
+ * @param path Plugin path
+ * @param hashContents Also hash the file contents
+ * @param stamp Receives the file stamp
+ * @param contentHash Receives the content hash, 0 if not hashed
+ */
+void stampFile(const std::string& path, bool hashContents, FileStamp& stamp,
+               uint64_t& contentHash);
+
+/**
+ * @brief Decide whether a changed plugin file has been written completely
+ *
+ * Linkers write libraries in several bursts. A file is treated as complete
+ * once its stamp has stayed the same for the debounce interval; every new
+ * stamp restarts the interval.
+ *
+ * @param stamp Current stamp of the file
+ * @param pendingStamp Stamp seen on the previous check; reset it to FileStamp() after a reload
+ * @param pendingSince When pendingStamp was first seen
+ * @param debounce Required quiet period, 0 to accept every change immediately
+ * @return true if the file may be loaded now
+ */
+bool isWriteSettled(const FileStamp& stamp, FileStamp& pendingStamp,
+                    std::chrono::steady_clock::time_point& pendingSince,
+                    std::chrono::milliseconds debounce);
+
+} // namespace detail
+} // namespace hotplugpp
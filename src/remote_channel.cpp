@@ -0,0 +1,95 @@
+#include "remote_channel.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace hotplugpp {
+namespace detail {
+
+namespace {
+
+/// Polls before sleeping; a reply from a busy core usually arrives within this window
+constexpr int SPIN_COUNT = 2000;
+
+uint32_t* futexWord(std::atomic<uint32_t>& word) {
+    return reinterpret_cast<uint32_t*>(&word);
+}
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+    struct timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    // Not FUTEX_PRIVATE_FLAG: the word is shared with another process
+    syscall(SYS_futex, futexWord(word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(100000)));
+#endif
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(SYS_futex, futexWord(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace
+
+bool sendMessage(RemoteRing& ring, const RemoteMessage& message) {
+    if (!ring.queue.tryPush(message)) {
+        return false;
+    }
+    ring.signal.fetch_add(1, std::memory_order_seq_cst);
+    if (ring.waiting.load(std::memory_order_seq_cst) != 0) {
+        futexWake(ring.signal);
+    }
+    return true;
+}
+
+bool receiveMessage(RemoteRing& ring, RemoteMessage& message, std::chrono::nanoseconds timeout) {
+    // Spinning only pays off if the producer runs on another core meanwhile
+    static const int spinCount = std::thread::hardware_concurrency() > 1 ? SPIN_COUNT : 0;
+    for (int i = 0; i < spinCount; ++i) {
+        if (ring.queue.tryPop(message)) {
+            return true;
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        // Read the word before the final check: a push after it changes the word,
+        // so the wait below returns immediately instead of missing the message
+        const uint32_t observed = ring.signal.load(std::memory_order_seq_cst);
+        ring.waiting.store(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring.queue.tryPop(message)) {
+            ring.waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            ring.waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        futexWait(ring.signal, observed, remaining);
+        ring.waiting.store(0, std::memory_order_relaxed);
+        if (ring.queue.tryPop(message)) {
+            return true;
+        }
+    }
+}
+
+} // namespace detail
+} // namespace hotplugpp
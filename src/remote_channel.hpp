@@ -0,0 +1,124 @@
+#pragma once
+
+#include "hotplugpp/spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace hotplugpp {
+namespace detail {
+
+/// First field of a RemoteChannel, checked by the plugin process
+constexpr uint32_t REMOTE_CHANNEL_MAGIC = 0x48505052; // "HPPR"
+/// Layout version of RemoteChannel; host and plugin process must match
+constexpr uint32_t REMOTE_CHANNEL_VERSION = 1;
+/// File descriptor the shared memory is passed to the plugin process under
+constexpr int REMOTE_CHANNEL_FD = 3;
+/// Read end of a pipe the host never writes to; it reports end-of-file once the host is gone
+constexpr int REMOTE_HOST_PIPE_FD = 4;
+
+/**
+ * @brief Kind of a RemoteMessage
+ */
+enum class RemoteMessageType : uint32_t {
+    /// Plugin process to host: plugin loaded (status 0) or failed; payload is RemoteHello
+    Hello,
+    /// Host to plugin process: call onUpdate(deltaTime)
+    Update,
+    /// Host to plugin process: query the function table for key; the reply carries the bytes
+    Query,
+    /// Host to plugin process: unload the plugin and exit
+    Shutdown,
+    /// Plugin process to host: request with the same sequence finished
+    Reply,
+};
+
+/**
+ * @brief Fixed-size message exchanged through a RemoteRing
+ */
+struct RemoteMessage {
+    static constexpr size_t MAX_PAYLOAD = 480;
+
+    RemoteMessageType type = RemoteMessageType::Reply;
+    /// Set by the host on requests and echoed in the reply
+    uint32_t sequence = 0;
+    /// 0 on success
+    uint32_t status = 0;
+    /// Bytes used in payload
+    uint32_t size = 0;
+    float deltaTime = 0.0f;
+    uint32_t reserved = 0;
+    uint64_t key = 0;
+    unsigned char payload[MAX_PAYLOAD];
+};
+
+static_assert(sizeof(RemoteMessage) == 512, "RemoteMessage should fill eight cache lines");
+
+/**
+ * @brief Payload of a Hello message
+ */
+struct RemoteHello {
+    uint32_t versionMajor = 0;
+    uint32_t versionMinor = 0;
+    uint32_t versionPatch = 0;
+    char name[64] = {};
+    char description[256] = {};
+};
+
+static_assert(sizeof(RemoteHello) <= RemoteMessage::MAX_PAYLOAD, "RemoteHello must fit");
+
+/**
+ * @brief One direction of a RemoteChannel
+ *
+ * The queue is the regular SpscQueue placed in shared memory; its indices are
+ * address-free lock-free atomics, so producer and consumer may live in
+ * different processes. signal is a futex word bumped after every push, so a
+ * consumer that found the queue empty can sleep in the kernel until the
+ * producer wakes it.
+ */
+struct RemoteRing {
+    SpscQueue<RemoteMessage, 16> queue;
+    alignas(64) std::atomic<uint32_t> signal{0};
+    /// Non-zero while the consumer is (about to be) asleep, so the producer only
+    /// makes the wake system call when needed
+    std::atomic<uint32_t> waiting{0};
+};
+
+static_assert(std::atomic<size_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Shared-memory rings need address-free atomics");
+
+/**
+ * @brief Shared memory between a host and one plugin process
+ */
+struct RemoteChannel {
+    uint32_t magic = REMOTE_CHANNEL_MAGIC;
+    uint32_t version = REMOTE_CHANNEL_VERSION;
+    uint32_t size = sizeof(RemoteChannel);
+    /// Host to plugin process
+    RemoteRing requests;
+    /// Plugin process to host
+    RemoteRing replies;
+};
+
+/**
+ * @brief Push a message and wake the consumer if it sleeps
+ * @param ring Ring this process produces into
+ * @param message Message to push
+ * @return false if the ring is full
+ */
+bool sendMessage(RemoteRing& ring, const RemoteMessage& message);
+
+/**
+ * @brief Pop a message, spinning briefly and then sleeping on the futex
+ * @param ring Ring this process consumes from
+ * @param message Receives the message
+ * @param timeout Longest time to wait
+ * @return false if nothing arrived in time
+ */
+bool receiveMessage(RemoteRing& ring, RemoteMessage& message, std::chrono::nanoseconds timeout);
+
+} // namespace detail
+} // namespace hotplugpp
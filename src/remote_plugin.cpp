@@ -0,0 +1,311 @@
+#include "hotplugpp/remote_plugin.hpp"
+
+#include "hotplugpp/log.hpp"
+#include "remote_channel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace hotplugpp {
+
+namespace {
+
+/// How often a waiting call checks whether the plugin process is still alive
+constexpr std::chrono::milliseconds LIVENESS_INTERVAL(10);
+
+std::string boundedString(const char* chars, size_t capacity) {
+    size_t length = 0;
+    while (length < capacity && chars[length] != '\0') {
+        ++length;
+    }
+    return std::string(chars, length);
+}
+
+#if defined(__linux__)
+
+std::string getDefaultHostExecutable() {
+    std::error_code ec;
+    std::filesystem::path self = std::filesystem::read_symlink("/proc/self/exe", ec);
+    if (ec) {
+        return "hotplugpp_plugin_host";
+    }
+    return (self.parent_path() / "hotplugpp_plugin_host").string();
+}
+
+/**
+ * @brief Move a descriptor above the fixed ones handed to the plugin process
+ *
+ * The spawn actions dup2() onto REMOTE_CHANNEL_FD and REMOTE_HOST_PIPE_FD in
+ * turn, so no source may already sit on one of them.
+ *
+ * @return Close-on-exec descriptor, or -1 on failure; @p fd is consumed either way
+ */
+int moveAboveChildDescriptors(int fd) {
+    if (fd < 0 || fd > detail::REMOTE_HOST_PIPE_FD) {
+        return fd;
+    }
+    const int moved = fcntl(fd, F_DUPFD_CLOEXEC, detail::REMOTE_HOST_PIPE_FD + 1);
+    close(fd);
+    return moved;
+}
+
+#endif
+
+} // namespace
+
+RemotePlugin::RemotePlugin() = default;
+
+RemotePlugin::~RemotePlugin() {
+    stop();
+}
+
+bool RemotePlugin::start(const std::string& pluginPath, const RemotePluginOptions& options) {
+    stop();
+#if defined(__linux__)
+    m_timeout = options.timeout;
+    const std::string executable =
+        options.hostExecutable.empty() ? getDefaultHostExecutable() : options.hostExecutable;
+
+    int fd = moveAboveChildDescriptors(memfd_create("hotplugpp_remote", MFD_CLOEXEC));
+    if (fd < 0) {
+        logMessage(LogLevel::Error, "Failed to create shared memory: %s", std::strerror(errno));
+        return false;
+    }
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(detail::RemoteChannel)) == 0) {
+        memory = mmap(nullptr, sizeof(detail::RemoteChannel), PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    }
+    if (memory == MAP_FAILED) {
+        logMessage(LogLevel::Error, "Failed to map shared memory: %s", std::strerror(errno));
+        close(fd);
+        return false;
+    }
+    m_channel = new (memory) detail::RemoteChannel();
+
+    // The child watches the read end for end-of-file, which the kernel delivers once every
+    // copy of the write end is closed, i.e. when this process exits from whichever thread
+    int pipeFds[2] = {-1, -1};
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) {
+        logMessage(LogLevel::Error, "Failed to create liveness pipe: %s", std::strerror(errno));
+        close(fd);
+        releaseProcess();
+        return false;
+    }
+    const int hostPipe = moveAboveChildDescriptors(pipeFds[0]);
+    m_hostPipe = pipeFds[1];
+
+    // The child finds both under fixed descriptors; dup2 clears FD_CLOEXEC on them
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fd, detail::REMOTE_CHANNEL_FD);
+    posix_spawn_file_actions_adddup2(&actions, hostPipe, detail::REMOTE_HOST_PIPE_FD);
+    char* argv[] = {const_cast<char*>(executable.c_str()), const_cast<char*>(pluginPath.c_str()),
+                    nullptr};
+    pid_t pid = 0;
+    const int result = hostPipe < 0 ? EBADF
+                                    : posix_spawn(&pid, executable.c_str(), &actions, nullptr,
+                                                  argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fd);
+    if (hostPipe >= 0) {
+        close(hostPipe);
+    }
+
+    if (result != 0) {
+        logMessage(LogLevel::Error, "Failed to start plugin process: %s (%s)", executable.c_str(),
+                   std::strerror(result));
+        releaseProcess();
+        return false;
+    }
+    m_pid = pid;
+
+    // The plugin process announces itself with sequence 0 once the plugin is loaded
+    detail::RemoteMessage hello;
+    if (!awaitReply(0, hello)) {
+        logMessage(LogLevel::Error, "Plugin process did not come up: %s", pluginPath.c_str());
+        return false;
+    }
+    if (hello.type != detail::RemoteMessageType::Hello || hello.status != 0 ||
+        hello.size < sizeof(detail::RemoteHello)) {
+        logMessage(LogLevel::Error, "Plugin process failed to load: %s", pluginPath.c_str());
+        killProcess();
+        return false;
+    }
+
+    detail::RemoteHello info;
+    std::memcpy(&info, hello.payload, sizeof(info));
+    m_name = boundedString(info.name, sizeof(info.name));
+    m_version = Version(info.versionMajor, info.versionMinor, info.versionPatch);
+    m_description = boundedString(info.description, sizeof(info.description));
+    logMessage(LogLevel::Info, "Plugin process %d started: %s v%s", m_pid, m_name.c_str(),
+               m_version.toString().c_str());
+    return true;
+#else
+    (void)pluginPath;
+    (void)options;
+    logMessage(LogLevel::Error, "Out-of-process plugins are only supported on Linux");
+    return false;
+#endif
+}
+
+void RemotePlugin::stop() {
+    if (!isRunning()) {
+        return;
+    }
+#if defined(__linux__)
+    detail::RemoteMessage message;
+    message.type = detail::RemoteMessageType::Shutdown;
+    if (!call(message)) {
+        // Every failing call reaps or kills the process and releases it; make sure of it
+        if (isRunning()) {
+            killProcess();
+        }
+        return;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + m_timeout;
+    int status = 0;
+    while (waitpid(m_pid, &status, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            logMessage(LogLevel::Warning, "Plugin process %d did not exit, killing it", m_pid);
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, &status, 0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+    releaseProcess();
+}
+
+bool RemotePlugin::update(float deltaTime) {
+    detail::RemoteMessage message;
+    message.type = detail::RemoteMessageType::Update;
+    message.deltaTime = deltaTime;
+    return call(message) && message.status == 0;
+}
+
+size_t RemotePlugin::query(uint64_t key, void* buffer, size_t size) {
+    detail::RemoteMessage message;
+    message.type = detail::RemoteMessageType::Query;
+    message.key = key;
+    message.size = static_cast<uint32_t>(std::min(size, detail::RemoteMessage::MAX_PAYLOAD));
+    if (!call(message) || message.status != 0 || message.size > size) {
+        return 0;
+    }
+    std::memcpy(buffer, message.payload, message.size);
+    return message.size;
+}
+
+bool RemotePlugin::call(detail::RemoteMessage& message) {
+    if (!isRunning()) {
+        return false;
+    }
+    const uint32_t sequence = ++m_sequence;
+    message.sequence = sequence;
+    // One call is in flight at a time, so the ring only fills if the process stopped reading
+    if (!detail::sendMessage(m_channel->requests, message)) {
+        logMessage(LogLevel::Error, "Plugin process %d stopped reading requests, killing it",
+                   m_pid);
+        killProcess();
+        return false;
+    }
+    return awaitReply(sequence, message);
+}
+
+bool RemotePlugin::awaitReply(uint32_t sequence, detail::RemoteMessage& reply) {
+#if defined(__linux__)
+    const auto deadline = std::chrono::steady_clock::now() + m_timeout;
+    for (;;) {
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        const auto slice = std::min<std::chrono::nanoseconds>(remaining, LIVENESS_INTERVAL);
+        if (detail::receiveMessage(m_channel->replies, reply, slice)) {
+            if (reply.sequence == sequence) {
+                return true;
+            }
+            continue;
+        }
+        if (reapIfExited()) {
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            logMessage(LogLevel::Error,
+                       "Plugin process %d did not answer within %lld ms, killing it", m_pid,
+                       static_cast<long long>(m_timeout.count()));
+            killProcess();
+            return false;
+        }
+    }
+#else
+    (void)sequence;
+    (void)reply;
+    return false;
+#endif
+}
+
+bool RemotePlugin::reapIfExited() {
+#if defined(__linux__)
+    int status = 0;
+    if (waitpid(m_pid, &status, WNOHANG) != m_pid) {
+        return false;
+    }
+    if (WIFSIGNALED(status)) {
+        logMessage(LogLevel::Error, "Plugin process %d (%s) was killed by signal %d (%s)", m_pid,
+                   m_name.c_str(), WTERMSIG(status), strsignal(WTERMSIG(status)));
+    } else {
+        logMessage(LogLevel::Error, "Plugin process %d (%s) exited with status %d", m_pid,
+                   m_name.c_str(), WEXITSTATUS(status));
+    }
+    releaseProcess();
+    return true;
+#else
+    return true;
+#endif
+}
+
+void RemotePlugin::killProcess() {
+#if defined(__linux__)
+    if (m_pid > 0) {
+        kill(m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+    }
+#endif
+    releaseProcess();
+}
+
+void RemotePlugin::releaseProcess() {
+#if defined(__linux__)
+    if (m_channel) {
+        m_channel->~RemoteChannel();
+        munmap(m_channel, sizeof(detail::RemoteChannel));
+    }
+    if (m_hostPipe >= 0) {
+        close(m_hostPipe);
+    }
+#endif
+    m_hostPipe = -1;
+    m_channel = nullptr;
+    m_pid = 0;
+    m_sequence = 0;
+    m_name.clear();
+    m_version = Version();
+    m_description.clear();
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,61 @@
+#include "hotplugpp/shared_library.hpp"
+
+namespace hotplugpp {
+
+LibraryHandle loadLibrary(const std::string& path, SymbolBinding binding) {
+#ifdef _WIN32
+    (void)binding;
+    return LoadLibraryA(path.c_str());
+#else
+    const int mode = binding == SymbolBinding::Lazy ? RTLD_LAZY : RTLD_NOW;
+    return dlopen(path.c_str(), mode | RTLD_LOCAL);
+#endif
+}
+
+void unloadLibrary(LibraryHandle handle) {
+    if (!handle)
+        return;
+
+#ifdef _WIN32
+    FreeLibrary(handle);
+#else
+    dlclose(handle);
+#endif
+}
+
+void* getFunction(LibraryHandle handle, const std::string& name) {
+    if (!handle)
+        return nullptr;
+
+#ifdef _WIN32
+    return reinterpret_cast<void*>(GetProcAddress(handle, name.c_str()));
+#else
+    return dlsym(handle, name.c_str());
+#endif
+}
+
+std::string getLastError() {
+#ifdef _WIN32
+    DWORD error = GetLastError();
+    if (error == 0)
+        return "No error";
+
+    LPSTR messageBuffer = nullptr;
+    size_t size = FormatMessageA(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+        NULL, error, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&messageBuffer, 0, NULL);
+
+    if (size == 0 || messageBuffer == nullptr) {
+        return "Unknown error (code: " + std::to_string(error) + ")";
+    }
+
+    std::string message(messageBuffer, size);
+    LocalFree(messageBuffer);
+    return message;
+#else
+    const char* error = dlerror();
+    return error ? std::string(error) : "No error";
+#endif
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,75 @@
+#include "hotplugpp/thread_pool.hpp"
+
+#include <utility>
+
+namespace hotplugpp {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return m_workers.size();
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+            // Only reached when stopping
+            return;
+        }
+
+        std::function<void()> task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        m_activeTasks++;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        m_activeTasks--;
+        if (m_tasks.empty() && m_activeTasks == 0) {
+            m_idle.notify_all();
+        }
+    }
+}
+
+} // namespace hotplugpp
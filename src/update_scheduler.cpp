@@ -0,0 +1,321 @@
+#include "hotplugpp/update_scheduler.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace hotplugpp {
+
+namespace {
+
+constexpr uint32_t NO_TASK = 0xFFFFFFFFu;
+
+/// Resource written by exclusive tasks and implicitly read by all others
+constexpr uint64_t EXCLUSIVE_RESOURCE = ~0ull;
+
+/// Yields before an idle worker goes to sleep; ticks usually follow each other closely
+constexpr int IDLE_SPIN_LIMIT = 256;
+
+class SpinLockGuard {
+  public:
+    explicit SpinLockGuard(std::atomic_flag& flag) : m_flag(flag) {
+        while (m_flag.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    ~SpinLockGuard() { m_flag.clear(std::memory_order_release); }
+
+    // Disable copy
+    SpinLockGuard(const SpinLockGuard&) = delete;
+    SpinLockGuard& operator=(const SpinLockGuard&) = delete;
+
+  private:
+    std::atomic_flag& m_flag;
+};
+
+struct ResourceState {
+    uint32_t lastWriter = NO_TASK;
+    /// Tasks that read the resource since it was last written
+    std::vector<uint32_t> readers;
+};
+
+} // namespace
+
+UpdateScheduler::UpdateScheduler(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->random = static_cast<uint32_t>(i * 2654435761u + 1);
+    }
+
+    // Worker 0 is whoever calls run()
+    m_threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        m_threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+UpdateScheduler::~UpdateScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void UpdateScheduler::build(const std::vector<UpdateAccess>& accesses) {
+    const size_t count = accesses.size();
+    std::vector<std::vector<uint32_t>> dependencies(count);
+    std::unordered_map<uint64_t, ResourceState> resources;
+
+    auto read = [&](uint32_t task, uint64_t resource) {
+        ResourceState& state = resources[resource];
+        if (state.lastWriter != NO_TASK) {
+            dependencies[task].push_back(state.lastWriter);
+        }
+        state.readers.push_back(task);
+    };
+    auto write = [&](uint32_t task, uint64_t resource) {
+        ResourceState& state = resources[resource];
+        if (state.lastWriter != NO_TASK) {
+            dependencies[task].push_back(state.lastWriter);
+        }
+        for (uint32_t reader : state.readers) {
+            if (reader != task) {
+                dependencies[task].push_back(reader);
+            }
+        }
+        state.readers.clear();
+        state.lastWriter = task;
+    };
+
+    for (uint32_t task = 0; task < count; ++task) {
+        const UpdateAccess& access = accesses[task];
+        if (access.exclusive) {
+            write(task, EXCLUSIVE_RESOURCE);
+            continue;
+        }
+        read(task, EXCLUSIVE_RESOURCE);
+        for (uint64_t resource : access.reads) {
+            read(task, resource);
+        }
+        for (uint64_t resource : access.writes) {
+            write(task, resource);
+        }
+    }
+
+    // Flatten into CSR: dependency counts plus the dependents of every task
+    m_dependencyCounts.assign(count, 0);
+    m_dependentOffsets.assign(count + 1, 0);
+    m_roots.clear();
+    std::vector<size_t> depths(count, 1);
+    m_criticalPathLength = 0;
+    for (uint32_t task = 0; task < count; ++task) {
+        auto& list = dependencies[task];
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+
+        m_dependencyCounts[task] = static_cast<uint32_t>(list.size());
+        for (uint32_t dependency : list) {
+            m_dependentOffsets[dependency + 1]++;
+            // Dependencies always come earlier, so their depth is final
+            depths[task] = std::max(depths[task], depths[dependency] + 1);
+        }
+        if (list.empty()) {
+            m_roots.push_back(task);
+        }
+        m_criticalPathLength = std::max(m_criticalPathLength, depths[task]);
+    }
+    for (size_t task = 0; task < count; ++task) {
+        m_dependentOffsets[task + 1] += m_dependentOffsets[task];
+    }
+    m_dependents.assign(m_dependentOffsets[count], 0);
+    std::vector<uint32_t> fill(m_dependentOffsets.begin(), m_dependentOffsets.end() - 1);
+    for (uint32_t task = 0; task < count; ++task) {
+        for (uint32_t dependency : dependencies[task]) {
+            m_dependents[fill[dependency]++] = task;
+        }
+    }
+
+    m_pending.reset(new std::atomic<uint32_t>[count]);
+    for (auto& worker : m_workers) {
+        worker->tasks.assign(count, 0);
+    }
+}
+
+void UpdateScheduler::run(const TaskFunc& func) {
+    const size_t count = m_dependencyCounts.size();
+    if (count == 0) {
+        return;
+    }
+
+    for (size_t task = 0; task < count; ++task) {
+        m_pending[task].store(m_dependencyCounts[task], std::memory_order_relaxed);
+    }
+    for (auto& worker : m_workers) {
+        worker->head = 0;
+        worker->tail = 0;
+    }
+    // Spread the roots so every worker starts with work of its own
+    for (size_t i = 0; i < m_roots.size(); ++i) {
+        Worker& worker = *m_workers[i % m_workers.size()];
+        worker.tasks[worker.tail++] = m_roots[i];
+    }
+    m_func = &func;
+    m_remaining.store(count, std::memory_order_release);
+
+    if (!m_threads.empty()) {
+        m_active.store(m_threads.size(), std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_runGeneration.fetch_add(1, std::memory_order_release);
+        }
+        m_wake.notify_all();
+    }
+
+    work(0);
+
+    // The queues are reset by the next run, so every worker has to be out of them
+    while (m_active.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    m_func = nullptr;
+}
+
+std::vector<uint32_t> UpdateScheduler::getDependencies(uint32_t task) const {
+    std::vector<uint32_t> dependencies;
+    for (uint32_t other = 0; other < task; ++other) {
+        auto begin = m_dependents.begin() + m_dependentOffsets[other];
+        auto end = m_dependents.begin() + m_dependentOffsets[other + 1];
+        if (std::find(begin, end, task) != end) {
+            dependencies.push_back(other);
+        }
+    }
+    return dependencies;
+}
+
+SchedulerWorkerStats UpdateScheduler::getWorkerStats(size_t worker) const {
+    SchedulerWorkerStats stats;
+    if (worker < m_workers.size()) {
+        stats.executed = m_workers[worker]->executed;
+        stats.stolen = m_workers[worker]->stolen;
+    }
+    return stats;
+}
+
+void UpdateScheduler::resetStats() {
+    for (auto& worker : m_workers) {
+        worker->executed = 0;
+        worker->stolen = 0;
+    }
+}
+
+void UpdateScheduler::workerLoop(size_t index) {
+    uint64_t seen = 0;
+    for (;;) {
+        for (int spin = 0; spin < IDLE_SPIN_LIMIT; ++spin) {
+            if (m_runGeneration.load(std::memory_order_acquire) != seen ||
+                m_stopping.load(std::memory_order_relaxed)) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen]() {
+                return m_stopping.load(std::memory_order_relaxed) ||
+                       m_runGeneration.load(std::memory_order_relaxed) != seen;
+            });
+            if (m_stopping.load(std::memory_order_relaxed)) {
+                return;
+            }
+            seen = m_runGeneration.load(std::memory_order_relaxed);
+        }
+
+        work(index);
+        m_active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void UpdateScheduler::work(size_t index) {
+    Worker& self = *m_workers[index];
+    uint32_t task;
+    while (m_remaining.load(std::memory_order_acquire) != 0) {
+        if (pop(self, task) || steal(index, task)) {
+            execute(index, task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void UpdateScheduler::push(Worker& worker, uint32_t task) {
+    SpinLockGuard guard(worker.lock);
+    worker.tasks[worker.tail++] = task;
+}
+
+bool UpdateScheduler::pop(Worker& worker, uint32_t& task) {
+    SpinLockGuard guard(worker.lock);
+    if (worker.tail == worker.head) {
+        return false;
+    }
+    task = worker.tasks[--worker.tail];
+    return true;
+}
+
+bool UpdateScheduler::steal(size_t thief, uint32_t& task) {
+    const size_t count = m_workers.size();
+    if (count < 2) {
+        return false;
+    }
+
+    // xorshift picks where to start so thieves do not all hit the same victim
+    Worker& self = *m_workers[thief];
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 17;
+    self.random ^= self.random << 5;
+    size_t start = self.random % count;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t victimIndex = (start + i) % count;
+        if (victimIndex == thief) {
+            continue;
+        }
+        Worker& victim = *m_workers[victimIndex];
+        SpinLockGuard guard(victim.lock);
+        if (victim.tail != victim.head) {
+            task = victim.tasks[victim.head++];
+            self.stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UpdateScheduler::execute(size_t index, uint32_t task) {
+    Worker& self = *m_workers[index];
+    (*m_func)(task);
+    self.executed++;
+
+    for (uint32_t i = m_dependentOffsets[task]; i < m_dependentOffsets[task + 1]; ++i) {
+        uint32_t dependent = m_dependents[i];
+        if (m_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            push(self, dependent);
+        }
+    }
+    // Only after the dependents are queued, so workers do not quit while work is left
+    m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace hotplugpp
@@ -0,0 +1,92 @@
+#include "hotplugpp/update_watchdog.hpp"
+
+#include <algorithm>
+
+namespace hotplugpp {
+
+namespace {
+
+/// Scans per limit; a stall is reported at most a quarter of the limit late
+constexpr int SCANS_PER_LIMIT = 4;
+
+constexpr std::chrono::nanoseconds MIN_SCAN_INTERVAL = std::chrono::milliseconds(1);
+constexpr std::chrono::nanoseconds MAX_SCAN_INTERVAL = std::chrono::milliseconds(100);
+
+} // namespace
+
+UpdateWatchdog::UpdateWatchdog() = default;
+
+UpdateWatchdog::~UpdateWatchdog() {
+    stop();
+}
+
+bool UpdateWatchdog::start(std::chrono::nanoseconds limit, StallCallback callback) {
+    if (limit.count() <= 0) {
+        return false;
+    }
+
+    stop();
+    m_limit = limit;
+    m_callback = std::move(callback);
+    m_stopping = false;
+    m_thread = std::thread([this]() { run(); });
+    return true;
+}
+
+void UpdateWatchdog::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void UpdateWatchdog::resize(size_t count) {
+    std::lock_guard<std::mutex> lock(m_scanMutex);
+    m_slots = count > 0 ? std::make_unique<Slot[]>(count) : nullptr;
+    m_slotCount = count;
+}
+
+void UpdateWatchdog::run() {
+    const std::chrono::nanoseconds interval =
+        std::clamp(m_limit / SCANS_PER_LIMIT, MIN_SCAN_INTERVAL, MAX_SCAN_INTERVAL);
+
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (!m_wake.wait_for(lock, interval, [this]() { return m_stopping; })) {
+        lock.unlock();
+        scan();
+        lock.lock();
+    }
+}
+
+void UpdateWatchdog::scan() {
+    std::lock_guard<std::mutex> lock(m_scanMutex);
+    const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    for (size_t i = 0; i < m_slotCount; ++i) {
+        Slot& slot = m_slots[i];
+        const int64_t start = slot.start.load(std::memory_order_acquire);
+        if (start == 0 || start == slot.reported) {
+            continue;
+        }
+
+        const std::chrono::nanoseconds elapsed =
+            std::chrono::steady_clock::duration(now - start);
+        if (elapsed < m_limit) {
+            continue;
+        }
+
+        slot.reported = start;
+        m_stallCount.fetch_add(1, std::memory_order_relaxed);
+        if (m_callback) {
+            m_callback(static_cast<uint32_t>(i), elapsed);
+        }
+    }
+}
+
+} // namespace hotplugpp
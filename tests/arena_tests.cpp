@@ -0,0 +1,110 @@
+#include "hotplugpp/arena.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+// ============================================================================
+// Allocation Tests
+// ============================================================================
+
+TEST(ArenaTest, ReservesNothingUntilFirstAllocation) {
+    Arena arena;
+    EXPECT_EQ(arena.getBytesReserved(), 0u);
+    EXPECT_EQ(arena.getChunkCount(), 0u);
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDisjoint) {
+    Arena arena(256);
+    std::vector<char*> blocks;
+    for (size_t alignment : {1, 2, 8, 16, 64, 256}) {
+        char* block = static_cast<char*>(arena.allocate(24, alignment));
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u) << alignment;
+        for (char* other : blocks) {
+            EXPECT_TRUE(block + 24 <= other || other + 24 <= block);
+        }
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(arena.getBytesUsed(), 24u * blocks.size());
+}
+
+TEST(ArenaTest, RejectsInvalidAlignment) {
+    Arena arena;
+    EXPECT_EQ(arena.allocate(8, 0), nullptr);
+    EXPECT_EQ(arena.allocate(8, 24), nullptr);
+}
+
+TEST(ArenaTest, GrowsByChunks) {
+    Arena arena(1024);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_NE(arena.allocate(100), nullptr);
+    }
+    EXPECT_GT(arena.getChunkCount(), 1u);
+    EXPECT_GE(arena.getBytesReserved(), arena.getBytesUsed());
+
+    // Larger than any chunk so far
+    ASSERT_NE(arena.allocate(1 << 20), nullptr);
+    EXPECT_GE(arena.getBytesReserved(), static_cast<size_t>(1 << 20));
+}
+
+TEST(ArenaTest, DeallocateRollsBackOnlyTheLastAllocation) {
+    Arena arena;
+    void* first = arena.allocate(64);
+    void* second = arena.allocate(64);
+
+    arena.deallocate(first, 64);
+    EXPECT_EQ(arena.getBytesUsed(), 128u);
+
+    arena.deallocate(second, 64);
+    EXPECT_EQ(arena.getBytesUsed(), 64u);
+    EXPECT_EQ(arena.allocate(64), second);
+}
+
+TEST(ArenaTest, ReleaseFreesEverything) {
+    Arena arena(1024);
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(100);
+    }
+    arena.release();
+    EXPECT_EQ(arena.getBytesUsed(), 0u);
+    EXPECT_EQ(arena.getBytesReserved(), 0u);
+    EXPECT_EQ(arena.getChunkCount(), 0u);
+    EXPECT_NE(arena.allocate(16), nullptr);
+}
+
+// ============================================================================
+// Allocator Interface Tests
+// ============================================================================
+
+TEST(ArenaTest, CInterfaceForwardsToArena) {
+    Arena arena;
+    const HotPlugPPAllocator* allocator = arena.getAllocator();
+    void* block = allocator->allocate(allocator->context, 40, 8);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(arena.getBytesUsed(), 40u);
+    allocator->deallocate(allocator->context, block, 40);
+    EXPECT_EQ(arena.getBytesUsed(), 0u);
+}
+
+TEST(ArenaTest, PluginAllocatorBacksStandardContainers) {
+    Arena arena;
+    std::vector<uint64_t, PluginAllocator<uint64_t>> values(
+        PluginAllocator<uint64_t>(arena.getAllocator()));
+    for (uint64_t i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[999], 999u);
+    EXPECT_GE(arena.getBytesUsed(), 1000 * sizeof(uint64_t));
+
+    // Without an allocator the global heap is used
+    std::vector<int, PluginAllocator<int>> heap;
+    heap.push_back(1);
+    EXPECT_EQ(heap.get_allocator().get(), nullptr);
+}
+
+} // namespace tests
+} // namespace hotplugpp
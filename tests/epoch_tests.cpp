@@ -0,0 +1,115 @@
+#include "hotplugpp/epoch.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+TEST(EpochDomainTest, SynchronizeWithoutReadersReturns) {
+    EpochDomain domain;
+    domain.synchronize();
+    domain.synchronize();
+    EXPECT_EQ(domain.getEpoch(), 2u);
+}
+
+TEST(EpochDomainTest, SynchronizeWaitsForReader) {
+    EpochDomain domain;
+    std::atomic<bool> synchronized{false};
+
+    auto* guard = new EpochGuard(domain);
+    std::thread writer([&]() {
+        domain.synchronize();
+        synchronized = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(synchronized.load());
+
+    delete guard;
+    writer.join();
+    EXPECT_TRUE(synchronized.load());
+}
+
+TEST(EpochDomainTest, LaterReadersAreNotWaitedFor) {
+    EpochDomain domain;
+    EpochGuard early(domain);
+    std::atomic<bool> synchronized{false};
+
+    std::thread writer([&]() {
+        domain.synchronize();
+        synchronized = true;
+    });
+    // Wait until the writer has flipped the epoch, then enter behind it
+    while (domain.getEpoch() == 0) {
+        std::this_thread::yield();
+    }
+    std::thread reader([&]() {
+        EpochGuard late(domain);
+        while (!synchronized.load()) {
+            std::this_thread::yield();
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(synchronized.load());
+    {
+        EpochGuard moved(std::move(early));
+    }
+    writer.join();
+    reader.join();
+    EXPECT_TRUE(synchronized.load());
+}
+
+TEST(EpochDomainTest, ReadersNeverSeeReclaimedObjects) {
+    struct Object {
+        std::atomic<uint64_t> alive{0xA11CE};
+    };
+
+    EpochDomain domain;
+    std::atomic<Object*> current{new Object()};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> failures{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                EpochGuard guard(domain);
+                Object* object = current.load();
+                if (object->alive.load() != 0xA11CE) {
+                    ++failures;
+                }
+                ++reads;
+            }
+        });
+    }
+
+    while (reads.load() == 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 200; ++i) {
+        Object* old = current.exchange(new Object());
+        domain.synchronize();
+        // Poison before freeing so a reader still holding it would notice
+        old->alive = 0;
+        delete old;
+        std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    delete current.load();
+
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,147 @@
+#include "hotplugpp/file_stamp.hpp"
+#include "hotplugpp/hash.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// xxhash64 Tests
+// ============================================================================
+
+TEST(XxHash64Test, MatchesReferenceVectors) {
+    EXPECT_EQ(xxhash64("", 0), 0xEF46DB3751D8E999ull);
+    EXPECT_EQ(xxhash64("a", 1), 0xD24EC4F1A98C6E5Bull);
+    EXPECT_EQ(xxhash64("abc", 3), 0x44BC2CF5AD770999ull);
+}
+
+TEST(XxHash64Test, SeedChangesHash) {
+    EXPECT_NE(xxhash64("abc", 3, 0), xxhash64("abc", 3, 1));
+}
+
+TEST(XxHash64Test, LongInputDependsOnEveryByte) {
+    // Longer than one 32-byte stripe plus a tail, to cover every code path
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    const uint64_t original = xxhash64(data.data(), data.size());
+    EXPECT_EQ(xxhash64(data.data(), data.size()), original);
+
+    for (size_t position : {size_t(0), size_t(31), size_t(500), data.size() - 1}) {
+        data[position] ^= 1;
+        EXPECT_NE(xxhash64(data.data(), data.size()), original) << "byte " << position;
+        data[position] ^= 1;
+    }
+}
+
+// ============================================================================
+// FileStamp Tests
+// ============================================================================
+
+class FileStampTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_dir = fs::temp_directory_path() /
+                ("hotplugpp_stamp_" +
+                 std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::create_directories(m_dir);
+        m_file = m_dir / "plugin.so";
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    static void writeFile(const fs::path& path, const std::string& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    fs::path m_dir;
+    fs::path m_file;
+};
+
+TEST_F(FileStampTest, MissingFile) {
+    FileStamp stamp = getFileStamp(m_file.string());
+    EXPECT_FALSE(stamp.exists);
+
+    uint64_t hash = 0;
+    EXPECT_FALSE(hashFileContents(m_file.string(), hash));
+}
+
+TEST_F(FileStampTest, UnchangedFileHasEqualStamp) {
+    writeFile(m_file, "version 1");
+    FileStamp first = getFileStamp(m_file.string());
+    FileStamp second = getFileStamp(m_file.string());
+
+    EXPECT_TRUE(first.exists);
+    EXPECT_EQ(first.size, 9u);
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(FileStampTest, SizeChangeWithinSameSecondIsDetected) {
+    writeFile(m_file, "version 1");
+    FileStamp before = getFileStamp(m_file.string());
+    auto modified = fs::last_write_time(m_file);
+
+    // Same modification time, different size: a coarse mtime check would miss this
+    writeFile(m_file, "version 10");
+    fs::last_write_time(m_file, modified);
+
+    EXPECT_NE(getFileStamp(m_file.string()), before);
+}
+
+TEST_F(FileStampTest, SubsecondModificationIsDetected) {
+    writeFile(m_file, "version 1");
+    auto modified = fs::last_write_time(m_file);
+    FileStamp before = getFileStamp(m_file.string());
+
+    fs::last_write_time(m_file, modified + std::chrono::milliseconds(1));
+    FileStamp after = getFileStamp(m_file.string());
+
+    EXPECT_NE(after, before);
+    EXPECT_GT(after.modifiedNs, before.modifiedNs);
+}
+
+TEST_F(FileStampTest, RenameOntoPathIsDetected) {
+    writeFile(m_file, "version 1");
+    FileStamp before = getFileStamp(m_file.string());
+
+    // Same contents and timestamp, but a new file: only the inode tells them apart
+    fs::path staged = m_dir / "plugin.so.tmp";
+    writeFile(staged, "version 1");
+    fs::last_write_time(staged, fs::last_write_time(m_file));
+    fs::rename(staged, m_file);
+
+    FileStamp after = getFileStamp(m_file.string());
+#ifndef _WIN32
+    EXPECT_NE(after, before);
+#endif
+    EXPECT_EQ(after.size, before.size);
+}
+
+TEST_F(FileStampTest, ContentHashIgnoresTimestamps) {
+    writeFile(m_file, "version 1");
+    uint64_t before = 0;
+    ASSERT_TRUE(hashFileContents(m_file.string(), before));
+    EXPECT_EQ(before, xxhash64("version 1", 9));
+
+    fs::last_write_time(m_file, fs::last_write_time(m_file) + std::chrono::seconds(10));
+    uint64_t touched = 0;
+    ASSERT_TRUE(hashFileContents(m_file.string(), touched));
+    EXPECT_EQ(touched, before);
+
+    writeFile(m_file, "version 2");
+    uint64_t rebuilt = 0;
+    ASSERT_TRUE(hashFileContents(m_file.string(), rebuilt));
+    EXPECT_NE(rebuilt, before);
+}
+
+} // namespace tests
+} // namespace hotplugpp
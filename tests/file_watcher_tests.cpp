@@ -0,0 +1,296 @@
+#include "hotplugpp/file_watcher.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace fs = std::filesystem;
+
+class FileWatcherTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_testPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "test_plugin" + SHARED_LIB_SUFFIX;
+        m_dir = fs::temp_directory_path() /
+                ("hotplugpp_watcher_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::create_directories(m_dir);
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    static void writeFile(const fs::path& path, const std::string& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    /// Poll the watcher until an event arrives or the timeout expires
+    static bool waitForEvent(FileWatcher& watcher, FileEvent& event,
+                             std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (watcher.pollEvent(event)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    std::string m_testPluginPath;
+    fs::path m_dir;
+};
+
+TEST_F(FileWatcherTest, StartAndStop) {
+    FileWatcher watcher;
+    EXPECT_FALSE(watcher.isRunning());
+    EXPECT_TRUE(watcher.start());
+    EXPECT_TRUE(watcher.isRunning());
+    watcher.stop();
+    EXPECT_FALSE(watcher.isRunning());
+}
+
+TEST_F(FileWatcherTest, NoEventsWithoutChanges) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    ASSERT_NE(watcher.watchFile(file.string()), FileWatcher::INVALID_FILE_ID);
+    ASSERT_TRUE(watcher.start());
+
+    FileEvent event;
+    EXPECT_FALSE(waitForEvent(watcher, event, std::chrono::milliseconds(200)));
+}
+
+TEST_F(FileWatcherTest, ReportsWrite) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    uint32_t fileId = watcher.watchFile(file.string());
+    ASSERT_TRUE(watcher.start());
+
+    writeFile(file, "v2");
+
+    FileEvent event;
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, fileId);
+    EXPECT_EQ(event.type, FileEventType::Modified);
+}
+
+TEST_F(FileWatcherTest, ReportsAtomicRename) {
+    fs::path file = m_dir / "plugin.so";
+    fs::path staging = m_dir / "plugin.so.tmp";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    uint32_t fileId = watcher.watchFile(file.string());
+    ASSERT_TRUE(watcher.start());
+
+    writeFile(staging, "v2");
+    fs::rename(staging, file);
+
+    FileEvent event;
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, fileId);
+    if (watcher.isUsingNativeEvents()) {
+        EXPECT_EQ(event.type, FileEventType::Created);
+    }
+}
+
+TEST_F(FileWatcherTest, ReportsRemoval) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    uint32_t fileId = watcher.watchFile(file.string());
+    ASSERT_TRUE(watcher.start());
+
+    fs::remove(file);
+
+    FileEvent event;
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, fileId);
+    EXPECT_EQ(event.type, FileEventType::Removed);
+}
+
+TEST_F(FileWatcherTest, IgnoresOtherFilesInDirectory) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    watcher.watchFile(file.string());
+    ASSERT_TRUE(watcher.start());
+
+    writeFile(m_dir / "unrelated.txt", "noise");
+
+    FileEvent event;
+    EXPECT_FALSE(waitForEvent(watcher, event, std::chrono::milliseconds(200)));
+}
+
+TEST_F(FileWatcherTest, UnwatchStopsEvents) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    uint32_t fileId = watcher.watchFile(file.string());
+    ASSERT_TRUE(watcher.start());
+    watcher.unwatchFile(fileId);
+
+    writeFile(file, "v2");
+
+    FileEvent event;
+    EXPECT_FALSE(waitForEvent(watcher, event, std::chrono::milliseconds(200)));
+}
+
+TEST_F(FileWatcherTest, WatchAfterStart) {
+    fs::path file = m_dir / "plugin.so";
+    writeFile(file, "v1");
+
+    FileWatcher watcher;
+    ASSERT_TRUE(watcher.start());
+    uint32_t fileId = watcher.watchFile(file.string());
+    ASSERT_NE(fileId, FileWatcher::INVALID_FILE_ID);
+
+    writeFile(file, "v2");
+
+    FileEvent event;
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, fileId);
+}
+
+TEST_F(FileWatcherTest, AliasedDirectorySpellingsShareOneWatch) {
+    fs::path first = m_dir / "a.so";
+    fs::path second = m_dir / "." / "sub" / ".." / "b.so";
+    fs::create_directories(m_dir / "sub");
+    writeFile(first, "v1");
+    writeFile(second, "v1");
+
+    FileWatcher watcher;
+    ASSERT_TRUE(watcher.start());
+    uint32_t firstId = watcher.watchFile(first.string());
+    uint32_t secondId = watcher.watchFile(second.string());
+    ASSERT_NE(firstId, FileWatcher::INVALID_FILE_ID);
+    ASSERT_NE(secondId, FileWatcher::INVALID_FILE_ID);
+
+    writeFile(first, "v2");
+    FileEvent event;
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, firstId);
+
+    // Unwatching one file keeps the directory watched for the other
+    watcher.unwatchFile(secondId);
+    writeFile(first, "v3");
+    ASSERT_TRUE(waitForEvent(watcher, event));
+    EXPECT_EQ(event.fileId, firstId);
+}
+
+// ============================================================================
+// PluginLoader Integration
+// ============================================================================
+
+TEST_F(FileWatcherTest, LoaderReloadsOnWatcherEvent) {
+    fs::path plugin = m_dir / "watched_plugin.so";
+    fs::copy_file(m_testPluginPath, plugin);
+
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(plugin.string()));
+    ASSERT_TRUE(loader.enableFileWatcher());
+    EXPECT_TRUE(loader.isFileWatcherEnabled());
+
+    // Nothing changed yet
+    EXPECT_FALSE(loader.checkAndReload());
+
+    fs::path staging = m_dir / "watched_plugin.so.tmp";
+    fs::copy_file(m_testPluginPath, staging);
+    fs::rename(staging, plugin);
+
+    bool reloaded = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!reloaded && std::chrono::steady_clock::now() < deadline) {
+        reloaded = loader.checkAndReload();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(reloaded);
+    EXPECT_TRUE(loader.isLoaded());
+
+    loader.unloadPlugin();
+}
+
+TEST_F(FileWatcherTest, LoaderRenameSkipsDebounce) {
+    fs::path plugin = m_dir / "renamed_plugin.so";
+    fs::copy_file(m_testPluginPath, plugin);
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    loader.setReloadDebounce(std::chrono::seconds(60));
+    ASSERT_TRUE(loader.loadPlugin(plugin.string()));
+    ASSERT_TRUE(loader.enableFileWatcher());
+
+    // A rename delivers a complete file, so there is nothing to wait for
+    fs::path staging = m_dir / "renamed_plugin.so.tmp";
+    fs::copy_file(m_testPluginPath, staging);
+    fs::rename(staging, plugin);
+
+    bool reloaded = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!reloaded && std::chrono::steady_clock::now() < deadline) {
+        reloaded = loader.checkAndReload();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(reloaded);
+
+    loader.unloadPlugin();
+}
+
+TEST_F(FileWatcherTest, LoaderSettlesWithoutFurtherEvents) {
+    fs::path plugin = m_dir / "settling_plugin.so";
+    fs::copy_file(m_testPluginPath, plugin);
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    loader.setReloadDebounce(std::chrono::milliseconds(50));
+    ASSERT_TRUE(loader.loadPlugin(plugin.string()));
+    ASSERT_TRUE(loader.enableFileWatcher());
+
+    // Reloads run from a private copy, so afterwards the file can be rewritten in place
+    fs::path staging = m_dir / "settling_plugin.so.tmp";
+    fs::copy_file(m_testPluginPath, staging);
+    fs::rename(staging, plugin);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!loader.checkAndReload() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Only one event arrives for the rewrite; the loader has to come back to it on its own
+    auto changedAt = std::chrono::steady_clock::now();
+    fs::copy_file(m_testPluginPath, plugin, fs::copy_options::overwrite_existing);
+
+    bool reloaded = false;
+    deadline = changedAt + std::chrono::seconds(5);
+    while (!reloaded && std::chrono::steady_clock::now() < deadline) {
+        reloaded = loader.checkAndReload();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(reloaded);
+    EXPECT_GE(std::chrono::steady_clock::now() - changedAt, std::chrono::milliseconds(50));
+
+    loader.unloadPlugin();
+}
+
+TEST_F(FileWatcherTest, LoaderCanDisableWatcher) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    ASSERT_TRUE(loader.enableFileWatcher());
+    EXPECT_TRUE(loader.enableFileWatcher(false));
+    EXPECT_FALSE(loader.isFileWatcherEnabled());
+    EXPECT_FALSE(loader.checkAndReload());
+}
+
+} // namespace tests
+} // namespace hotplugpp
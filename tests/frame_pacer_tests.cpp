@@ -0,0 +1,130 @@
+#include "hotplugpp/frame_pacer.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace {
+
+using Clock = FramePacer::Clock;
+using std::chrono::milliseconds;
+
+FramePacerConfig tenMillisecondSteps(uint32_t maxCatchUpSteps = 5) {
+    FramePacerConfig config;
+    config.timestep = milliseconds(10);
+    config.maxCatchUpSteps = maxCatchUpSteps;
+    return config;
+}
+
+} // namespace
+
+// ============================================================================
+// Accumulation Tests
+// ============================================================================
+
+TEST(FramePacerTest, FirstFrameRunsOneStep) {
+    FramePacer pacer(tenMillisecondSteps());
+    const Clock::time_point start = Clock::now();
+
+    EXPECT_EQ(pacer.advance(start), 1u);
+    EXPECT_EQ(pacer.getNextDeadline(), start + milliseconds(10));
+    EXPECT_EQ(pacer.getFrameCount(), 1u);
+    EXPECT_FLOAT_EQ(pacer.getTimestepSeconds(), 0.01f);
+}
+
+TEST(FramePacerTest, AccumulatesPartialSteps) {
+    FramePacer pacer(tenMillisecondSteps());
+    const Clock::time_point start = Clock::now();
+    pacer.advance(start);
+
+    EXPECT_EQ(pacer.advance(start + milliseconds(6)), 0u);
+    EXPECT_FLOAT_EQ(pacer.getInterpolationAlpha(), 0.6f);
+    EXPECT_EQ(pacer.advance(start + milliseconds(12)), 1u);
+    EXPECT_FLOAT_EQ(pacer.getInterpolationAlpha(), 0.2f);
+    EXPECT_EQ(pacer.advance(start + milliseconds(35)), 2u);
+    EXPECT_FLOAT_EQ(pacer.getInterpolationAlpha(), 0.5f);
+}
+
+TEST(FramePacerTest, DeadlinesStayOnTheGrid) {
+    FramePacer pacer(tenMillisecondSteps());
+    const Clock::time_point start = Clock::now();
+    pacer.advance(start);
+
+    // A late frame does not push the following deadlines back
+    pacer.advance(start + milliseconds(13));
+    EXPECT_EQ(pacer.getNextDeadline(), start + milliseconds(20));
+    pacer.advance(start + milliseconds(21));
+    EXPECT_EQ(pacer.getNextDeadline(), start + milliseconds(30));
+}
+
+TEST(FramePacerTest, CatchUpIsBounded) {
+    FramePacer pacer(tenMillisecondSteps(3));
+    const Clock::time_point start = Clock::now();
+    pacer.advance(start);
+
+    // A 104 ms stall owes 10 steps; 3 run and 7 are dropped
+    EXPECT_EQ(pacer.advance(start + milliseconds(104)), 3u);
+    EXPECT_EQ(pacer.getDroppedSteps(), 7u);
+    EXPECT_EQ(pacer.getNextDeadline(), start + milliseconds(110));
+    EXPECT_EQ(pacer.advance(start + milliseconds(110)), 1u);
+}
+
+TEST(FramePacerTest, RecordsFrameTimes) {
+    FramePacer pacer(tenMillisecondSteps());
+    const Clock::time_point start = Clock::now();
+    pacer.advance(start);
+    pacer.advance(start + milliseconds(10));
+    pacer.advance(start + milliseconds(30));
+
+    EXPECT_EQ(pacer.getFrameTimes().getCount(), 2u);
+    EXPECT_EQ(pacer.getFrameTimes().getMax(), milliseconds(20));
+
+    pacer.reset();
+    EXPECT_EQ(pacer.getFrameCount(), 0u);
+    EXPECT_EQ(pacer.getFrameTimes().getCount(), 0u);
+    EXPECT_EQ(pacer.advance(start + milliseconds(500)), 1u);
+    EXPECT_EQ(pacer.getDroppedSteps(), 0u);
+}
+
+// ============================================================================
+// Waiting Tests
+// ============================================================================
+
+TEST(FramePacerTest, WaitUntilDoesNotReturnEarly) {
+    for (auto spin : {milliseconds(0), milliseconds(1), milliseconds(50)}) {
+        const Clock::time_point deadline = Clock::now() + milliseconds(3);
+        waitUntil(deadline, spin);
+        EXPECT_GE(Clock::now(), deadline);
+    }
+
+    // A deadline in the past returns at once
+    waitUntil(Clock::now() - milliseconds(1), milliseconds(1));
+}
+
+TEST(FramePacerTest, BeginFrameKeepsPace) {
+    FramePacerConfig config;
+    config.timestep = milliseconds(2);
+    config.maxCatchUpSteps = 1000;
+    FramePacer pacer(config);
+
+    const int frames = 50;
+    uint64_t steps = 0;
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        uint32_t due = pacer.beginFrame();
+        EXPECT_GE(due, 1u);
+        steps += due;
+    }
+    const auto elapsed = Clock::now() - start;
+
+    // Every step is paid for by elapsed time, and no frame starts before its deadline
+    EXPECT_GE(elapsed, config.timestep * (steps - 1));
+    EXPECT_GE(steps, static_cast<uint64_t>(frames));
+    EXPECT_EQ(pacer.getWakeLatency().getCount(), static_cast<uint64_t>(frames - 1));
+    EXPECT_EQ(pacer.getDroppedSteps(), 0u);
+}
+
+} // namespace tests
+} // namespace hotplugpp
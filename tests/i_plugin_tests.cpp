@@ -189,6 +189,15 @@ TEST(IPluginTest, ResetClearsState) {
     EXPECT_FLOAT_EQ(plugin.getLastDeltaTime(), 0.0f);
 }
 
+TEST(IPluginTest, StateHooksDefaultToNoState) {
+    MockPlugin plugin;
+    char buffer[8] = {};
+    EXPECT_EQ(plugin.getStateVersion(), 0u);
+    EXPECT_EQ(plugin.getStateSize(), 0u);
+    EXPECT_FALSE(plugin.saveState(buffer, sizeof(buffer)));
+    EXPECT_FALSE(plugin.loadState(buffer, sizeof(buffer), 1));
+}
+
 // ============================================================================
 // Polymorphism Tests
 // ============================================================================
@@ -0,0 +1,145 @@
+#include "hotplugpp/latency_histogram.hpp"
+#include "hotplugpp/phase_timings.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+using std::chrono::nanoseconds;
+
+// ============================================================================
+// LatencyHistogram Tests
+// ============================================================================
+
+TEST(LatencyHistogramTest, InitiallyEmpty) {
+    LatencyHistogram histogram;
+    LatencyStats stats = histogram.getStats();
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_EQ(stats.p50.count(), 0);
+    EXPECT_EQ(stats.p99.count(), 0);
+    EXPECT_EQ(stats.max.count(), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 10; ++i) {
+        histogram.record(nanoseconds(i));
+    }
+    EXPECT_EQ(histogram.getCount(), 10u);
+    EXPECT_EQ(histogram.getPercentile(0.5).count(), 5);
+    EXPECT_EQ(histogram.getMax().count(), 10);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.record(std::chrono::microseconds(i));
+    }
+
+    double p50 = static_cast<double>(histogram.getPercentile(0.50).count());
+    double p99 = static_cast<double>(histogram.getPercentile(0.99).count());
+    EXPECT_NEAR(p50, 500000.0, 500000.0 * 0.125);
+    EXPECT_NEAR(p99, 990000.0, 990000.0 * 0.125);
+    EXPECT_EQ(histogram.getMax(), std::chrono::microseconds(1000));
+}
+
+TEST(LatencyHistogramTest, PercentileNeverExceedsMax) {
+    LatencyHistogram histogram;
+    histogram.record(nanoseconds(1001));
+    EXPECT_EQ(histogram.getPercentile(1.0).count(), 1001);
+    EXPECT_EQ(histogram.getPercentile(0.5).count(), 1001);
+}
+
+TEST(LatencyHistogramTest, OutlierShowsInMaxOnly) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 999; ++i) {
+        histogram.record(nanoseconds(100));
+    }
+    histogram.record(std::chrono::milliseconds(50));
+
+    EXPECT_LE(histogram.getPercentile(0.99).count(), 112);
+    EXPECT_EQ(histogram.getMax(), std::chrono::milliseconds(50));
+}
+
+TEST(LatencyHistogramTest, HandlesExtremeValues) {
+    LatencyHistogram histogram;
+    histogram.record(nanoseconds(-5));
+    histogram.record(nanoseconds(INT64_MAX));
+    EXPECT_EQ(histogram.getCount(), 2u);
+    EXPECT_EQ(histogram.getPercentile(0.0).count(), 0);
+    EXPECT_EQ(histogram.getMax().count(), INT64_MAX);
+}
+
+TEST(LatencyHistogramTest, ResetClearsSamples) {
+    LatencyHistogram histogram;
+    histogram.record(nanoseconds(42));
+    histogram.reset();
+    EXPECT_EQ(histogram.getCount(), 0u);
+    EXPECT_EQ(histogram.getMax().count(), 0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecording) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                histogram.record(nanoseconds(t * 1000 + i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.getCount(), 4000u);
+    EXPECT_EQ(histogram.getMax().count(), 3999);
+}
+
+// ============================================================================
+// PhaseTimings Tests
+// ============================================================================
+
+TEST(PhaseTimingsTest, RecordsPerPhase) {
+    PhaseTimings timings;
+    timings.record(LoadPhase::OnLoad, nanoseconds(10));
+    timings.record(LoadPhase::OnLoad, nanoseconds(20));
+    timings.record(LoadPhase::LoadLibrary, nanoseconds(30));
+
+    EXPECT_EQ(timings.getStats(LoadPhase::OnLoad).count, 2u);
+    EXPECT_EQ(timings.getStats(LoadPhase::LoadLibrary).count, 1u);
+    EXPECT_EQ(timings.getStats(LoadPhase::OnUnload).count, 0u);
+}
+
+TEST(PhaseTimingsTest, CallbackReceivesEveryPhase) {
+    PhaseTimings timings;
+    std::vector<LoadPhase> phases;
+    timings.setCallback([&phases](LoadPhase phase, nanoseconds) { phases.push_back(phase); });
+
+    timings.record(LoadPhase::CreateInstance, nanoseconds(1));
+    { ScopedPhaseTimer timer(&timings, LoadPhase::OnUnload); }
+
+    ASSERT_EQ(phases.size(), 2u);
+    EXPECT_EQ(phases[0], LoadPhase::CreateInstance);
+    EXPECT_EQ(phases[1], LoadPhase::OnUnload);
+}
+
+TEST(PhaseTimingsTest, NullTimerRecordsNothing) {
+    ScopedPhaseTimer timer(nullptr, LoadPhase::OnLoad);
+    SUCCEED();
+}
+
+TEST(PhaseTimingsTest, PhaseNames) {
+    EXPECT_STREQ(toString(LoadPhase::LoadLibrary), "LoadLibrary");
+    EXPECT_STREQ(toString(LoadPhase::Reload), "Reload");
+    for (size_t i = 0; i < LOAD_PHASE_COUNT; ++i) {
+        EXPECT_STRNE(toString(static_cast<LoadPhase>(i)), "Unknown");
+    }
+}
+
+} // namespace tests
+} // namespace hotplugpp
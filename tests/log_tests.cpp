@@ -0,0 +1,172 @@
+#include "hotplugpp/log.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+/// Collects messages so tests can inspect what was logged
+class CapturingSink : public ILogSink {
+  public:
+    void write(LogLevel level, const char* message, size_t length) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.emplace_back(level, std::string(message, length));
+    }
+
+    std::vector<std::pair<LogLevel, std::string>> messages() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_messages;
+    }
+
+    bool contains(LogLevel level, const std::string& text) {
+        for (const auto& message : messages()) {
+            if (message.first == level && message.second.find(text) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::vector<std::pair<LogLevel, std::string>> m_messages;
+};
+
+class LogTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_testPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "test_plugin" + SHARED_LIB_SUFFIX;
+        m_previousLevel = getLogLevel();
+        setLogSink(&m_sink);
+    }
+
+    void TearDown() override {
+        setLogSink(nullptr);
+        setLogLevel(m_previousLevel);
+    }
+
+    CapturingSink m_sink;
+    std::string m_testPluginPath;
+    LogLevel m_previousLevel = LogLevel::Info;
+};
+
+// ============================================================================
+// Routing and Filtering Tests
+// ============================================================================
+
+TEST_F(LogTest, CustomSinkReceivesMessages) {
+    EXPECT_EQ(getLogSink(), &m_sink);
+    logMessage(LogLevel::Warning, "value=%d name=%s", 42, "abc");
+
+    auto messages = m_sink.messages();
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0].first, LogLevel::Warning);
+    EXPECT_EQ(messages[0].second, "value=42 name=abc");
+}
+
+TEST_F(LogTest, LevelFiltersMessages) {
+    setLogLevel(LogLevel::Warning);
+    logMessage(LogLevel::Debug, "debug");
+    logMessage(LogLevel::Info, "info");
+    logMessage(LogLevel::Error, "error");
+    ASSERT_EQ(m_sink.messages().size(), 1u);
+    EXPECT_EQ(m_sink.messages()[0].second, "error");
+
+    setLogLevel(LogLevel::Off);
+    logMessage(LogLevel::Error, "silenced");
+    EXPECT_EQ(m_sink.messages().size(), 1u);
+}
+
+TEST_F(LogTest, LongMessagesAreTruncated) {
+    std::string longText(2000, 'x');
+    logMessage(LogLevel::Info, "%s", longText.c_str());
+    ASSERT_EQ(m_sink.messages().size(), 1u);
+    EXPECT_LT(m_sink.messages()[0].second.size(), longText.size());
+}
+
+TEST_F(LogTest, ResetRestoresDefaultSink) {
+    setLogSink(nullptr);
+    EXPECT_NE(getLogSink(), &m_sink);
+    EXPECT_NE(getLogSink(), nullptr);
+}
+
+TEST_F(LogTest, LoaderDiagnosticsReachSink) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_TRUE(m_sink.contains(LogLevel::Info, "Plugin loaded successfully: TestPlugin"));
+
+    EXPECT_FALSE(loader.loadPlugin("/nonexistent/plugin.so"));
+    EXPECT_TRUE(m_sink.contains(LogLevel::Error, "Failed to load library: /nonexistent/plugin.so"));
+}
+
+TEST(LogLevelTest, Names) {
+    EXPECT_STREQ(toString(LogLevel::Debug), "Debug");
+    EXPECT_STREQ(toString(LogLevel::Error), "Error");
+}
+
+// ============================================================================
+// AsyncLogSink Tests
+// ============================================================================
+
+TEST(AsyncLogSinkTest, FlushDeliversMessages) {
+    AsyncLogSink sink;
+    for (int i = 0; i < 10; ++i) {
+        sink.write(LogLevel::Debug, "async sink test", 15);
+    }
+    sink.flush();
+    EXPECT_EQ(sink.getDroppedCount(), 0u);
+}
+
+TEST(AsyncLogSinkTest, WritesAfterStopAreSynchronous) {
+    AsyncLogSink sink;
+    sink.stop();
+    sink.write(LogLevel::Debug, "after stop", 10);
+    sink.flush();
+    EXPECT_EQ(sink.getDroppedCount(), 0u);
+}
+
+TEST(AsyncLogSinkTest, ConcurrentWriters) {
+    AsyncLogSink sink;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&sink]() {
+            for (int i = 0; i < 100; ++i) {
+                sink.write(LogLevel::Debug, "concurrent", 10);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    sink.flush();
+    SUCCEED();
+}
+
+TEST(AsyncLogSinkTest, WritesRacingStopAreNotLost) {
+    for (int round = 0; round < 20; ++round) {
+        AsyncLogSink sink;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&sink]() {
+                for (int i = 0; i < 20; ++i) {
+                    sink.write(LogLevel::Debug, "racing stop", 11);
+                }
+            });
+        }
+        sink.stop();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // Every message was printed or counted as dropped, none is left in the ring
+        EXPECT_EQ(sink.getDeliveredCount() + sink.getDroppedCount(), 40u);
+    }
+}
+
+} // namespace tests
+} // namespace hotplugpp
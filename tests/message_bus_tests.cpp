@@ -0,0 +1,270 @@
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/message_bus.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+#include "test_plugin/bus_message.hpp"
+#include "test_plugin/plugin_files.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+struct TestMessage {
+    uint32_t id;
+    float value;
+};
+
+using TestChannel = MessageChannel<TestMessage, 8>;
+
+// ============================================================================
+// Channel Tests
+// ============================================================================
+
+TEST(MessageChannelTest, PublishWithoutSubscribersReturnsSlot) {
+    TestChannel channel;
+    for (size_t i = 0; i < 2 * TestChannel::capacity(); ++i) {
+        EXPECT_TRUE(channel.publish(TestMessage{static_cast<uint32_t>(i), 0.0f}));
+    }
+    EXPECT_EQ(channel.getPublishedCount(), 2 * TestChannel::capacity());
+    EXPECT_EQ(channel.getDroppedCount(), 0u);
+}
+
+TEST(MessageChannelTest, SubscriberReceivesInOrder) {
+    TestChannel channel;
+    uint32_t subscriber = channel.subscribe("reader");
+    ASSERT_NE(subscriber, TestChannel::INVALID_SUBSCRIBER);
+
+    EXPECT_TRUE(channel.publish(TestMessage{1, 1.5f}));
+    EXPECT_TRUE(channel.publish(TestMessage{2, 2.5f}));
+
+    const TestMessage* first = channel.receive(subscriber);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->id, 1u);
+    EXPECT_FLOAT_EQ(first->value, 1.5f);
+    channel.release(first);
+
+    const TestMessage* second = channel.receive(subscriber);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->id, 2u);
+    channel.release(second);
+
+    EXPECT_EQ(channel.receive(subscriber), nullptr);
+}
+
+TEST(MessageChannelTest, SubscribersShareOneSlot) {
+    TestChannel channel;
+    uint32_t a = channel.subscribe("a");
+    uint32_t b = channel.subscribe("b");
+    ASSERT_NE(a, b);
+
+    TestMessage* message = channel.acquire();
+    ASSERT_NE(message, nullptr);
+    message->id = 7;
+    channel.publish(message);
+
+    const TestMessage* fromA = channel.receive(a);
+    const TestMessage* fromB = channel.receive(b);
+    ASSERT_NE(fromA, nullptr);
+    EXPECT_EQ(fromA, fromB);
+    EXPECT_EQ(fromA->id, 7u);
+    channel.release(fromA);
+    channel.release(fromB);
+}
+
+TEST(MessageChannelTest, UnreleasedMessagesExhaustSlots) {
+    TestChannel channel;
+    uint32_t subscriber = channel.subscribe("slow");
+
+    for (size_t i = 0; i < TestChannel::capacity(); ++i) {
+        EXPECT_TRUE(channel.publish(TestMessage{static_cast<uint32_t>(i), 0.0f}));
+    }
+    EXPECT_EQ(channel.acquire(), nullptr);
+    EXPECT_FALSE(channel.publish(TestMessage{99, 0.0f}));
+    EXPECT_EQ(channel.getDroppedCount(), 2u);
+
+    EXPECT_EQ(channel.drain(subscriber, [](const TestMessage&) {}), TestChannel::capacity());
+    EXPECT_NE(channel.acquire(), nullptr);
+}
+
+TEST(MessageChannelTest, SubscribingAgainKeepsPendingMessages) {
+    TestChannel channel;
+    uint32_t subscriber = channel.subscribe("plugin");
+    EXPECT_TRUE(channel.publish(TestMessage{1, 0.0f}));
+
+    EXPECT_EQ(channel.subscribe("plugin"), subscriber);
+    const TestMessage* message = channel.receive(subscriber);
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->id, 1u);
+    channel.release(message);
+}
+
+TEST(MessageChannelTest, UnsubscribeReleasesPendingMessages) {
+    TestChannel channel;
+    uint32_t subscriber = channel.subscribe("leaving");
+    for (size_t i = 0; i < TestChannel::capacity(); ++i) {
+        EXPECT_TRUE(channel.publish(TestMessage{static_cast<uint32_t>(i), 0.0f}));
+    }
+
+    channel.unsubscribe(subscriber);
+    EXPECT_TRUE(channel.publish(TestMessage{0, 0.0f}));
+    EXPECT_EQ(channel.receive(channel.subscribe("other")), nullptr);
+}
+
+TEST(MessageChannelTest, SubscriberLimit) {
+    TestChannel channel;
+    for (uint32_t i = 0; i < TestChannel::MAX_SUBSCRIBERS; ++i) {
+        EXPECT_NE(channel.subscribe("s" + std::to_string(i)), TestChannel::INVALID_SUBSCRIBER);
+    }
+    EXPECT_EQ(channel.subscribe("one too many"), TestChannel::INVALID_SUBSCRIBER);
+}
+
+TEST(MessageChannelTest, ConcurrentProducersAndConsumers) {
+    constexpr int PRODUCERS = 3;
+    constexpr int CONSUMERS = 2;
+    constexpr uint32_t PER_PRODUCER = 20000;
+    MessageChannel<TestMessage, 64> channel;
+
+    std::vector<uint32_t> subscribers;
+    for (int i = 0; i < CONSUMERS; ++i) {
+        subscribers.push_back(channel.subscribe("consumer-" + std::to_string(i)));
+    }
+
+    std::atomic<int> producersDone{0};
+    std::vector<uint64_t> sums(CONSUMERS, 0);
+    std::vector<uint64_t> counts(CONSUMERS, 0);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&, c]() {
+            auto handle = [&](const TestMessage& message) {
+                sums[c] += message.id;
+                ++counts[c];
+            };
+            while (producersDone.load() < PRODUCERS) {
+                if (channel.drain(subscribers[c], handle) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            channel.drain(subscribers[c], handle);
+        });
+    }
+    for (int p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&]() {
+            for (uint32_t i = 1; i <= PER_PRODUCER; ++i) {
+                while (!channel.publish(TestMessage{i, 0.0f})) {
+                    std::this_thread::yield();
+                }
+            }
+            ++producersDone;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const uint64_t expectedSum = PRODUCERS * uint64_t(PER_PRODUCER) * (PER_PRODUCER + 1) / 2;
+    for (int c = 0; c < CONSUMERS; ++c) {
+        EXPECT_EQ(counts[c], PRODUCERS * uint64_t(PER_PRODUCER));
+        EXPECT_EQ(sums[c], expectedSum);
+    }
+    EXPECT_EQ(channel.getPublishedCount(), PRODUCERS * uint64_t(PER_PRODUCER));
+}
+
+// ============================================================================
+// Bus Tests
+// ============================================================================
+
+TEST(MessageBusTest, ChannelsAreSharedByName) {
+    MessageBus bus;
+    auto* first = bus.getChannel<TestMessage, 8>("events");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ((bus.getChannel<TestMessage, 8>("events")), first);
+    EXPECT_NE((bus.getChannel<TestMessage, 8>("other")), first);
+    EXPECT_EQ(bus.getChannelCount(), 2u);
+}
+
+TEST(MessageBusTest, MismatchedChannelTypeFails) {
+    MessageBus bus;
+    ASSERT_NE((bus.getChannel<TestMessage, 8>("events")), nullptr);
+    EXPECT_EQ((bus.getChannel<TestMessage, 16>("events")), nullptr);
+    EXPECT_EQ((bus.getChannel<uint64_t, 8>("events")), nullptr);
+}
+
+// ============================================================================
+// Plugin Tests
+// ============================================================================
+
+class MessageBusPluginTest : public ::testing::Test {
+  protected:
+    using Channel = MessageChannel<BusMessage, BUS_CHANNEL_CAPACITY>;
+
+    static std::string pluginPath(const std::string& name) {
+        return std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + name + SHARED_LIB_SUFFIX;
+    }
+
+    static uint64_t queryCounter(PluginLoader& loader, const char* name) {
+        uint64_t value = 0;
+        const HotPlugPPFunctionTable* table = loader.getFunctionTable();
+        if (table && table->query) {
+            table->query(loader.getPlugin(), fnv1a64(name), &value, sizeof(value));
+        }
+        return value;
+    }
+};
+
+TEST_F(MessageBusPluginTest, PluginWithoutBusFailsToLoad) {
+    PluginLoader loader;
+    EXPECT_FALSE(loader.loadPlugin(pluginPath("bus_consumer_plugin")));
+}
+
+TEST_F(MessageBusPluginTest, PluginsTalkThroughBus) {
+    MessageBus bus;
+    PluginLoader producer;
+    PluginLoader consumer;
+    producer.setMessageBus(&bus);
+    consumer.setMessageBus(&bus);
+    ASSERT_TRUE(consumer.loadPlugin(pluginPath("bus_consumer_plugin")));
+    ASSERT_TRUE(producer.loadPlugin(pluginPath("bus_producer_plugin")));
+
+    producer.getPlugin()->onUpdate(0.016f);
+    consumer.getPlugin()->onUpdate(0.016f);
+
+    const uint64_t sent = queryCounter(producer, "sent");
+    EXPECT_GT(sent, 0u);
+    EXPECT_EQ(queryCounter(consumer, "received"), sent);
+}
+
+TEST_F(MessageBusPluginTest, ReloadRebindsSubscription) {
+    const std::string source = pluginPath("bus_consumer_plugin");
+    const std::string path = copyPlugin(source, "bus_reload");
+
+    MessageBus bus;
+    PluginLoader loader;
+    loader.setMessageBus(&bus);
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    // Published while the old build is loaded but before it reads them
+    Channel* channel = bus.getChannel<BusMessage, BUS_CHANNEL_CAPACITY>(BUS_CHANNEL_NAME);
+    ASSERT_NE(channel, nullptr);
+    for (uint64_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(channel->publish(BusMessage{0, 0, i}));
+    }
+
+    replacePlugin(source, path);
+    ASSERT_TRUE(loader.checkAndReload());
+
+    EXPECT_EQ(queryCounter(loader, "received"), 0u);
+    loader.getPlugin()->onUpdate(0.016f);
+    EXPECT_EQ(queryCounter(loader, "received"), 5u);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,103 @@
+#include "hotplugpp/mpmc_queue.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+TEST(MpmcQueueTest, InitiallyEmpty) {
+    MpmcQueue<int, 8> queue;
+    int value = 0;
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MpmcQueueTest, FifoOrder) {
+    MpmcQueue<int, 8> queue;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.isEmpty());
+
+    for (int i = 0; i < 5; ++i) {
+        int value = -1;
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MpmcQueueTest, RejectsPushWhenFull) {
+    MpmcQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+TEST(MpmcQueueTest, WrapsAround) {
+    MpmcQueue<int, 4> queue;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.tryPush(i));
+        int value = -1;
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(MpmcQueueTest, ConcurrentProducersAndConsumers) {
+    MpmcQueue<int, 64> queue;
+    const int producerCount = 3;
+    const int perProducer = 5000;
+    const int total = producerCount * perProducer;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!queue.tryPush(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::atomic<int> consumed{0};
+    std::vector<std::atomic<int>> seen(total);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&]() {
+            while (consumed.load() < total) {
+                int value;
+                if (queue.tryPop(value)) {
+                    seen[value].fetch_add(1);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(queue.isEmpty());
+    for (int i = 0; i < total; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "value " << i;
+    }
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,178 @@
+#include "hotplugpp/plugin_index.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace fs = std::filesystem;
+
+#if defined(__ELF__)
+
+class PluginIndexTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_dir = fs::temp_directory_path() /
+                ("hotplugpp_index_" +
+                 std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(m_dir);
+        fs::create_directories(m_dir / "plugins");
+        m_pluginDir = (m_dir / "plugins").string();
+        m_indexPath = (m_dir / "plugins.index").string();
+
+        copyPlugin("test_plugin", "test");
+        copyPlugin("failing_plugin", "failing");
+        std::ofstream(m_dir / "plugins" / "readme.txt") << "not a library";
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    /// Copy a built test plugin into the plugin directory under a new name
+    fs::path copyPlugin(const std::string& target, const std::string& name) {
+        const std::string source =
+            std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + target + SHARED_LIB_SUFFIX;
+        const fs::path destination = m_dir / "plugins" / (name + SHARED_LIB_SUFFIX);
+        fs::copy_file(source, destination, fs::copy_options::overwrite_existing);
+        return destination;
+    }
+
+    fs::path m_dir;
+    std::string m_pluginDir;
+    std::string m_indexPath;
+};
+
+// ============================================================================
+// Scan Tests
+// ============================================================================
+
+TEST_F(PluginIndexTest, ScanFindsPluginsByName) {
+    PluginIndex index;
+    PluginScanStats stats = index.scan({m_pluginDir});
+
+    EXPECT_EQ(stats.files, 2u);
+    EXPECT_EQ(stats.probed, 2u);
+    EXPECT_EQ(stats.reused, 0u);
+    EXPECT_EQ(index.getEntries().size(), 2u);
+    EXPECT_EQ(index.getPluginCount(), 1u);
+
+    const PluginIndexEntry* entry = index.find("TestPlugin");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(fs::path(entry->path).filename(), fs::path(std::string("test") + SHARED_LIB_SUFFIX));
+    EXPECT_EQ(entry->metadata.version, Version(1, 2, 3));
+    EXPECT_EQ(index.find("FailingPlugin"), nullptr);
+}
+
+TEST_F(PluginIndexTest, HighestVersionOfANameWins) {
+    copyPlugin("stateful_plugin_v2", "a_stateful");
+    copyPlugin("stateful_plugin_v1", "b_stateful");
+    copyPlugin("stateful_plugin_v2", "c_stateful");
+
+    PluginIndex index;
+    index.scan({m_pluginDir});
+
+    const PluginIndexEntry* entry = index.find("StatefulPlugin");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->metadata.version, Version(1, 2, 0));
+    EXPECT_EQ(fs::path(entry->path).filename(),
+              fs::path(std::string("a_stateful") + SHARED_LIB_SUFFIX));
+}
+
+TEST_F(PluginIndexTest, ParallelScanProbesEveryFile) {
+    for (int i = 0; i < 100; ++i) {
+        copyPlugin("test_plugin", "copy_" + std::to_string(i));
+    }
+
+    PluginScanOptions options;
+    options.threadCount = 4;
+    PluginIndex index;
+    PluginScanStats stats = index.scan({m_pluginDir}, options);
+
+    EXPECT_EQ(stats.files, 102u);
+    EXPECT_EQ(stats.probed, 102u);
+    EXPECT_EQ(index.getPluginCount(), 101u);
+}
+
+TEST_F(PluginIndexTest, MissingDirectoryIsSkipped) {
+    PluginIndex index;
+    PluginScanStats stats = index.scan({(m_dir / "missing").string(), m_pluginDir});
+
+    EXPECT_EQ(stats.files, 2u);
+    EXPECT_NE(index.find("TestPlugin"), nullptr);
+}
+
+// ============================================================================
+// Persistence Tests
+// ============================================================================
+
+TEST_F(PluginIndexTest, WarmScanReusesUnchangedEntries) {
+    {
+        PluginIndex index;
+        index.scan({m_pluginDir});
+        ASSERT_TRUE(index.save(m_indexPath));
+    }
+
+    PluginIndex index;
+    ASSERT_TRUE(index.load(m_indexPath));
+    EXPECT_EQ(index.getEntries().size(), 2u);
+    ASSERT_NE(index.find("TestPlugin"), nullptr);
+    EXPECT_EQ(index.find("TestPlugin")->metadata.description, "A test plugin for unit tests");
+
+    PluginScanStats stats = index.scan({m_pluginDir});
+    EXPECT_EQ(stats.files, 2u);
+    EXPECT_EQ(stats.probed, 0u);
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_NE(index.find("TestPlugin"), nullptr);
+}
+
+TEST_F(PluginIndexTest, ChangedFileIsProbedAgain) {
+    PluginIndex index;
+    index.scan({m_pluginDir});
+    ASSERT_TRUE(index.save(m_indexPath));
+
+    // Replace the failing plugin with a real one under the same path
+    const fs::path replaced = copyPlugin("stateful_plugin_v1", "failing");
+    fs::last_write_time(replaced, fs::last_write_time(replaced) + std::chrono::seconds(1));
+
+    ASSERT_TRUE(index.load(m_indexPath));
+    PluginScanStats stats = index.scan({m_pluginDir});
+    EXPECT_EQ(stats.probed, 1u);
+    EXPECT_EQ(stats.reused, 1u);
+    ASSERT_NE(index.find("StatefulPlugin"), nullptr);
+    EXPECT_EQ(index.find("StatefulPlugin")->path, replaced.string());
+}
+
+TEST_F(PluginIndexTest, RemovedFileIsDropped) {
+    PluginIndex index;
+    index.scan({m_pluginDir});
+
+    fs::remove(m_dir / "plugins" / (std::string("test") + SHARED_LIB_SUFFIX));
+    PluginScanStats stats = index.scan({m_pluginDir});
+
+    EXPECT_EQ(stats.files, 1u);
+    EXPECT_EQ(stats.removed, 1u);
+    EXPECT_EQ(index.find("TestPlugin"), nullptr);
+}
+
+TEST_F(PluginIndexTest, CorruptIndexLoadsEmpty) {
+    PluginIndex index;
+    index.scan({m_pluginDir});
+    ASSERT_TRUE(index.save(m_indexPath));
+    fs::resize_file(m_indexPath, fs::file_size(m_indexPath) - 1);
+
+    EXPECT_FALSE(index.load(m_indexPath));
+    EXPECT_TRUE(index.getEntries().empty());
+    EXPECT_EQ(index.find("TestPlugin"), nullptr);
+
+    std::ofstream(m_indexPath, std::ios::trunc) << "garbage";
+    EXPECT_FALSE(index.load(m_indexPath));
+    EXPECT_FALSE(index.load((m_dir / "missing.index").string()));
+}
+
+#endif
+
+} // namespace tests
+} // namespace hotplugpp
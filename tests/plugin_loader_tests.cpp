@@ -1,9 +1,15 @@
+#include "hotplugpp/hash.hpp"
 #include "hotplugpp/plugin_loader.hpp"
+#include "test_plugin/async_init_gate.hpp"
+#include "test_plugin/plugin_files.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <thread>
+#include <vector>
 #include <cstdlib>
 
 namespace hotplugpp {
@@ -14,14 +20,60 @@ class PluginLoaderTest : public ::testing::Test {
     void SetUp() override {
         m_testPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "test_plugin" + SHARED_LIB_SUFFIX;
         m_failingPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "failing_plugin" + SHARED_LIB_SUFFIX;
+        m_tablePluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "table_plugin" + SHARED_LIB_SUFFIX;
+        m_arenaPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "arena_plugin" + SHARED_LIB_SUFFIX;
+        m_asyncInitPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "async_init_plugin" + SHARED_LIB_SUFFIX;
+        m_failingAsyncInitPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "failing_async_init_plugin" + SHARED_LIB_SUFFIX;
     }
 
     void TearDown() override {
         // Ensure plugin is unloaded after each test
     }
 
+    /// Atomically replace a plugin with the first bytes of another, like a linker mid-write
+    static void replacePluginPartially(const std::string& source, const std::string& dest,
+                                       size_t bytes) {
+        namespace fs = std::filesystem;
+        std::string tmp = dest + ".tmp";
+        std::ifstream in(source, std::ios::binary);
+        std::vector<char> contents(bytes);
+        in.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+        std::ofstream(tmp, std::ios::binary | std::ios::trunc)
+            .write(contents.data(), static_cast<std::streamsize>(in.gcount()));
+        fs::last_write_time(tmp, fs::file_time_type::clock::now() + std::chrono::seconds(10));
+        fs::rename(tmp, dest);
+    }
+
+    /// Call checkAndReload() until it reports a reload or the timeout expires
+    static bool waitForReload(PluginLoader& loader) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (loader.checkAndReload()) {
+                return true;
+            }
+            if (!loader.isReloadPending()) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    /// Call pollLoad() until the plugin leaves a load state or the timeout expires
+    static PluginLoadState pollWhile(PluginLoader& loader, PluginLoadState state) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (loader.pollLoad() == state && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return loader.getLoadState();
+    }
+
     std::string m_testPluginPath;
     std::string m_failingPluginPath;
+    std::string m_tablePluginPath;
+    std::string m_arenaPluginPath;
+    std::string m_asyncInitPluginPath;
+    std::string m_failingAsyncInitPluginPath;
 };
 
 // ============================================================================
@@ -186,6 +238,160 @@ TEST_F(PluginLoaderTest, PluginOnUpdateWorks) {
     plugin->onUpdate(0.016f);
 }
 
+TEST_F(PluginLoaderTest, PluginWithoutFunctionTable) {
+    PluginLoader loader;
+    EXPECT_EQ(loader.getFunctionTable(), nullptr);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_EQ(loader.getFunctionTable(), nullptr);
+}
+
+TEST_F(PluginLoaderTest, FunctionTableBypassesVirtualDispatch) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_tablePluginPath));
+    const HotPlugPPFunctionTable* table = loader.getFunctionTable();
+    ASSERT_NE(table, nullptr);
+    EXPECT_EQ(table->version, static_cast<uint32_t>(HOTPLUGPP_FUNCTION_TABLE_VERSION));
+    ASSERT_NE(table->update, nullptr);
+    ASSERT_NE(table->updateBatch, nullptr);
+    ASSERT_NE(table->query, nullptr);
+
+    void* instance = loader.getPlugin();
+    table->update(instance, 0.016f);
+    table->updateBatch(&instance, 1, 0.016f);
+    loader.getPlugin()->onUpdate(0.016f);
+
+    int updateCount = 0;
+    EXPECT_EQ(table->query(instance, fnv1a64("updateCount"), &updateCount, sizeof(updateCount)),
+              sizeof(updateCount));
+    EXPECT_EQ(updateCount, 3);
+    EXPECT_EQ(table->query(instance, fnv1a64("unknown"), &updateCount, sizeof(updateCount)), 0u);
+
+    loader.unloadPlugin();
+    EXPECT_EQ(loader.getFunctionTable(), nullptr);
+}
+
+TEST_F(PluginLoaderTest, ArenaPluginAllocatesFromItsArena) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_EQ(loader.getArena(), nullptr);
+
+    ASSERT_TRUE(loader.loadPlugin(m_arenaPluginPath));
+    const Arena* arena = loader.getArena();
+    ASSERT_NE(arena, nullptr);
+    const size_t loaded = arena->getBytesUsed();
+    EXPECT_GT(loaded, 0u);
+
+    for (int i = 0; i < 10; ++i) {
+        loader.getPlugin()->onUpdate(0.016f);
+    }
+    EXPECT_GT(arena->getBytesUsed(), loaded);
+
+    loader.unloadPlugin();
+    EXPECT_EQ(loader.getArena(), nullptr);
+}
+
+TEST_F(PluginLoaderTest, LoadersShareOneLibrary) {
+    PluginLoader first;
+    PluginLoader second;
+    EXPECT_EQ(first.getLibraryInstanceCount(), 0u);
+
+    ASSERT_TRUE(first.loadPlugin(m_testPluginPath));
+    ASSERT_TRUE(second.loadPlugin(m_testPluginPath));
+    EXPECT_EQ(first.getLibraryInstanceCount(), 2u);
+    EXPECT_EQ(PluginLoader::getLibraryInstanceCount(m_testPluginPath), 2u);
+    EXPECT_NE(first.getPlugin(), second.getPlugin());
+
+    // The library stays mapped for the remaining instance
+    first.unloadPlugin();
+    EXPECT_EQ(first.getLibraryInstanceCount(), 0u);
+    EXPECT_EQ(second.getLibraryInstanceCount(), 1u);
+    second.getPlugin()->onUpdate(0.016f);
+
+    second.unloadPlugin();
+    EXPECT_EQ(PluginLoader::getLibraryInstanceCount(m_testPluginPath), 0u);
+}
+
+// ============================================================================
+// Load Policy Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, DefaultLoadPolicyIsEager) {
+    PluginLoader loader;
+    EXPECT_EQ(loader.getLoadPolicy(), LoadPolicy::Eager);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_TRUE(loader.isInitialized());
+}
+
+TEST_F(PluginLoaderTest, DeferredLoadRunsOnLoadOnFirstUse) {
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_TRUE(loader.isLoaded());
+    EXPECT_FALSE(loader.isInitialized());
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnLoad).count, 0u);
+
+    EXPECT_EQ(loader.getPlugin(), nullptr);
+    ASSERT_NE(loader.acquirePlugin(), nullptr);
+    EXPECT_TRUE(loader.isInitialized());
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnLoad).count, 1u);
+    EXPECT_TRUE(loader.initializePlugin());
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnLoad).count, 1u);
+}
+
+TEST_F(PluginLoaderTest, GetPluginDoesNotInitialize) {
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+
+    EXPECT_EQ(loader.getPlugin(), nullptr);
+    EXPECT_FALSE(loader.isInitialized());
+    ASSERT_NE(loader.acquirePlugin(), nullptr);
+    EXPECT_EQ(loader.getPlugin(), loader.acquirePlugin());
+}
+
+TEST_F(PluginLoaderTest, UnusedDeferredPluginSkipsOnUnload) {
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    loader.unloadPlugin();
+
+    EXPECT_FALSE(loader.isLoaded());
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnUnload).count, 0u);
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::DestroyInstance).count, 1u);
+}
+
+TEST_F(PluginLoaderTest, FailedDeferredInitUnloadsPlugin) {
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    // onLoad() has not run yet, so the failing plugin loads
+    ASSERT_TRUE(loader.loadPlugin(m_failingPluginPath));
+
+    EXPECT_FALSE(loader.initializePlugin());
+    EXPECT_FALSE(loader.isLoaded());
+    EXPECT_EQ(loader.getPlugin(), nullptr);
+    EXPECT_EQ(PluginLoader::getLibraryInstanceCount(m_failingPluginPath), 0u);
+}
+
+TEST_F(PluginLoaderTest, ReloadKeepsDeferredPluginUninitialized) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_deferred_reload");
+
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    replacePlugin(m_testPluginPath, path);
+    ASSERT_TRUE(loader.checkAndReload());
+    EXPECT_FALSE(loader.isInitialized());
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnLoad).count, 0u);
+
+    ASSERT_NE(loader.acquirePlugin(), nullptr);
+    EXPECT_TRUE(loader.isInitialized());
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
 // ============================================================================
 // Reload Callback Tests
 // ============================================================================
@@ -229,6 +435,551 @@ TEST_F(PluginLoaderTest, CheckAndReloadNoChange) {
     EXPECT_TRUE(loader.isLoaded());
 }
 
+// ============================================================================
+// Staged Reload Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, DefaultReloadModeIsStaged) {
+    PluginLoader loader;
+    EXPECT_EQ(loader.getReloadMode(), ReloadMode::Staged);
+    EXPECT_FALSE(loader.isReloadPending());
+}
+
+TEST_F(PluginLoaderTest, StagedReloadKeepsOldVersionUntilReady) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_staged");
+
+    PluginLoader loader;
+    int callbackCount = 0;
+    loader.setReloadCallback([&callbackCount]() { callbackCount++; });
+    ASSERT_TRUE(loader.loadPlugin(path));
+    IPlugin* before = loader.getPlugin();
+
+    replacePlugin(m_testPluginPath, path);
+
+    // The first check only starts loading the new version
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_TRUE(loader.isReloadPending());
+    EXPECT_EQ(loader.getPlugin(), before);
+
+    EXPECT_TRUE(waitForReload(loader));
+    EXPECT_FALSE(loader.isReloadPending());
+    EXPECT_TRUE(loader.isLoaded());
+    EXPECT_EQ(callbackCount, 1);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, FailedReloadKeepsPreviousVersion) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_rollback");
+
+    PluginLoader loader;
+    int callbackCount = 0;
+    loader.setReloadCallback([&callbackCount]() { callbackCount++; });
+    ASSERT_TRUE(loader.loadPlugin(path));
+    IPlugin* before = loader.getPlugin();
+
+    replacePlugin(m_failingPluginPath, path);
+    EXPECT_FALSE(waitForReload(loader));
+
+    EXPECT_TRUE(loader.isLoaded());
+    EXPECT_EQ(loader.getPlugin(), before);
+    EXPECT_STREQ(loader.getPlugin()->getName(), "TestPlugin");
+    EXPECT_EQ(callbackCount, 0);
+
+    // The broken build is not retried until the file changes again
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_FALSE(loader.isReloadPending());
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, BlockingReloadCompletesInOneCall) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_blocking");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    EXPECT_EQ(loader.getReloadMode(), ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_TRUE(loader.checkAndReload());
+    EXPECT_FALSE(loader.isReloadPending());
+    EXPECT_TRUE(loader.isLoaded());
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, UnloadDiscardsPendingReload) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_discard");
+
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_FALSE(loader.checkAndReload());
+    loader.unloadPlugin();
+    EXPECT_FALSE(loader.isReloadPending());
+    EXPECT_FALSE(loader.isLoaded());
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, StagedReloadHandsOverState) {
+    std::string statefulPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "stateful_plugin_v2" + SHARED_LIB_SUFFIX;
+    std::string path = copyPlugin(statefulPath, "loader_state");
+
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(path));
+    for (int i = 0; i < 4; ++i) {
+        loader.getPlugin()->onUpdate(0.5f);
+    }
+
+    replacePlugin(statefulPath, path);
+    ASSERT_TRUE(waitForReload(loader));
+
+    // Layout 2 starts with the 64-bit update count
+    uint64_t state[2] = {0, 0};
+    ASSERT_EQ(loader.getPlugin()->getStateSize(), sizeof(state));
+    ASSERT_TRUE(loader.getPlugin()->saveState(state, sizeof(state)));
+    EXPECT_EQ(state[0], 4u);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Change Detection Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, ContentHashingDisabledByDefault) {
+    PluginLoader loader;
+    EXPECT_FALSE(loader.isContentHashingEnabled());
+}
+
+TEST_F(PluginLoaderTest, TouchedPluginSkippedWithContentHashing) {
+    namespace fs = std::filesystem;
+    std::string path = copyPlugin(m_testPluginPath, "loader_touch");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    loader.setContentHashing(true);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    fs::last_write_time(path, fs::file_time_type::clock::now() + std::chrono::seconds(10));
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_FALSE(loader.checkAndReload());
+
+    // A real rebuild is still picked up
+    std::string otherPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "stateful_plugin_v1" + SHARED_LIB_SUFFIX;
+    replacePlugin(otherPath, path);
+    EXPECT_TRUE(loader.checkAndReload());
+
+    loader.unloadPlugin();
+    fs::remove(path);
+}
+
+TEST_F(PluginLoaderTest, TouchedPluginReloadedWithoutContentHashing) {
+    namespace fs = std::filesystem;
+    std::string path = copyPlugin(m_testPluginPath, "loader_touch_nohash");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    fs::last_write_time(path, fs::file_time_type::clock::now() + std::chrono::seconds(10));
+    EXPECT_TRUE(loader.checkAndReload());
+
+    loader.unloadPlugin();
+    fs::remove(path);
+}
+
+TEST_F(PluginLoaderTest, RebuildWithinSameSecondIsDetected) {
+    namespace fs = std::filesystem;
+    std::string path = copyPlugin(m_testPluginPath, "loader_same_second");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    // Same timestamp down to the second, but a different file
+    auto modified = fs::last_write_time(path);
+    std::string tmp = path + ".tmp";
+    fs::copy_file(m_testPluginPath, tmp, fs::copy_options::overwrite_existing);
+    fs::last_write_time(tmp, modified + std::chrono::microseconds(1));
+    fs::rename(tmp, path);
+
+    EXPECT_TRUE(loader.checkAndReload());
+
+    loader.unloadPlugin();
+    fs::remove(path);
+}
+
+TEST_F(PluginLoaderTest, ReloadDebounceDisabledByDefault) {
+    PluginLoader loader;
+    EXPECT_EQ(loader.getReloadDebounce().count(), 0);
+}
+
+TEST_F(PluginLoaderTest, ReloadDebounceWaitsForWriterToFinish) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_debounce");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    loader.setReloadDebounce(std::chrono::milliseconds(100));
+    ASSERT_TRUE(loader.loadPlugin(path));
+    int reloads = 0;
+    loader.setReloadCallback([&reloads]() { ++reloads; });
+
+    // Every burst restarts the quiet period, so the half-written file is never loaded
+    replacePluginPartially(m_testPluginPath, path, 4096);
+    EXPECT_FALSE(loader.checkAndReload());
+    replacePluginPartially(m_testPluginPath, path, 8192);
+    EXPECT_FALSE(loader.checkAndReload());
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_FALSE(loader.checkAndReload());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_TRUE(loader.checkAndReload());
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_EQ(reloads, 1);
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::LoadLibrary).count, 2u);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Phase Timing Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, LoadAndUnloadRecordPhases) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    loader.unloadPlugin();
+
+    for (LoadPhase phase : {LoadPhase::LoadLibrary, LoadPhase::ResolveSymbols,
+                            LoadPhase::CreateInstance, LoadPhase::OnLoad, LoadPhase::OnUnload,
+                            LoadPhase::DestroyInstance, LoadPhase::UnloadLibrary}) {
+        EXPECT_EQ(loader.getPhaseStats(phase).count, 1u) << toString(phase);
+    }
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::Reload).count, 0u);
+    EXPECT_GT(loader.getPhaseStats(LoadPhase::LoadLibrary).max.count(), 0);
+}
+
+TEST_F(PluginLoaderTest, ReloadRecordsPhases) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_timings");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    replacePlugin(m_testPluginPath, path);
+    ASSERT_TRUE(loader.checkAndReload());
+
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::Reload).count, 1u);
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::CopyLibrary).count, 1u);
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::LoadLibrary).count, 2u);
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::OnUnload).count, 1u);
+
+    loader.resetPhaseTimings();
+    EXPECT_EQ(loader.getPhaseStats(LoadPhase::Reload).count, 0u);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, PhaseCallbackInvoked) {
+    PluginLoader loader;
+    std::vector<LoadPhase> phases;
+    loader.setPhaseCallback(
+        [&phases](LoadPhase phase, std::chrono::nanoseconds) { phases.push_back(phase); });
+
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    ASSERT_EQ(phases.size(), 4u);
+    EXPECT_EQ(phases.front(), LoadPhase::LoadLibrary);
+    EXPECT_EQ(phases.back(), LoadPhase::OnLoad);
+
+    loader.setPhaseCallback(nullptr);
+    loader.unloadPlugin();
+    EXPECT_EQ(phases.size(), 4u);
+}
+
+// ============================================================================
+// Asynchronous Load Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, LoadPluginAsyncIsAdoptedByPoll) {
+    PluginLoader loader;
+    loader.loadPluginAsync(m_testPluginPath);
+    EXPECT_EQ(loader.getLoadState(), PluginLoadState::Loading);
+    EXPECT_FALSE(loader.isLoaded());
+
+    EXPECT_EQ(pollWhile(loader, PluginLoadState::Loading), PluginLoadState::Ready);
+    EXPECT_TRUE(loader.isLoaded());
+    ASSERT_NE(loader.getPlugin(), nullptr);
+    EXPECT_STREQ(loader.getPlugin()->getName(), "TestPlugin");
+}
+
+TEST_F(PluginLoaderTest, FailedAsyncLoadLeavesNothingLoaded) {
+    PluginLoader loader;
+    loader.loadPluginAsync("/nonexistent/plugin.so");
+    EXPECT_EQ(pollWhile(loader, PluginLoadState::Loading), PluginLoadState::Unloaded);
+    EXPECT_FALSE(loader.isLoaded());
+    EXPECT_EQ(loader.getPlugin(), nullptr);
+}
+
+TEST_F(PluginLoaderTest, UnloadDiscardsAsyncLoad) {
+    PluginLoader loader;
+    loader.loadPluginAsync(m_testPluginPath);
+    loader.unloadPlugin();
+    EXPECT_EQ(loader.getLoadState(), PluginLoadState::Unloaded);
+    EXPECT_EQ(loader.getLibraryInstanceCount(m_testPluginPath), 0u);
+
+    // A synchronous load replaces one in flight
+    loader.loadPluginAsync(m_tablePluginPath);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_EQ(loader.pollLoad(), PluginLoadState::Ready);
+    EXPECT_EQ(loader.getPluginPath(), m_testPluginPath);
+}
+
+TEST_F(PluginLoaderTest, AcquirePluginWaitsForAsyncInit) {
+    AsyncInitGate gate;
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_asyncInitPluginPath));
+    EXPECT_TRUE(loader.isInitialized());
+    EXPECT_EQ(loader.getLoadState(), PluginLoadState::Initializing);
+    EXPECT_EQ(loader.acquirePlugin(), nullptr);
+    EXPECT_FALSE(loader.readPlugin());
+
+    gate.open();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!loader.acquirePlugin() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_NE(loader.getPlugin(), nullptr);
+    EXPECT_EQ(loader.getLoadState(), PluginLoadState::Ready);
+    EXPECT_TRUE(loader.readPlugin());
+}
+
+TEST_F(PluginLoaderTest, FailedAsyncInitUnloadsPlugin) {
+    AsyncInitGate gate;
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_failingAsyncInitPluginPath));
+    EXPECT_EQ(loader.pollLoad(), PluginLoadState::Initializing);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(loader, PluginLoadState::Initializing), PluginLoadState::Unloaded);
+    EXPECT_FALSE(loader.isLoaded());
+}
+
+TEST_F(PluginLoaderTest, StagedReloadWaitsForAsyncInit) {
+    std::string path = copyPlugin(m_asyncInitPluginPath, "loader_async_init_reload");
+    AsyncInitGate gate;
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(path));
+    gate.open();
+    ASSERT_EQ(pollWhile(loader, PluginLoadState::Initializing), PluginLoadState::Ready);
+    IPlugin* previous = loader.getPlugin();
+
+    // The old build keeps serving while the new one finishes its setup
+    gate.close();
+    replacePlugin(m_asyncInitPluginPath, path);
+    EXPECT_FALSE(loader.checkAndReload());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_TRUE(loader.isReloadPending());
+    EXPECT_EQ(loader.getPlugin(), previous);
+
+    gate.open();
+    EXPECT_TRUE(waitForReload(loader));
+    EXPECT_EQ(loader.getLoadState(), PluginLoadState::Ready);
+    EXPECT_NE(loader.getPlugin(), nullptr);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, StagedReloadInitializesOnWorkerAfterFirstUse) {
+    std::string path = copyPlugin(m_asyncInitPluginPath, "loader_async_init_first_use");
+    AsyncInitGate gate;
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    // Staged without onLoad(), then the running version is used before the swap
+    replacePlugin(m_asyncInitPluginPath, path);
+    EXPECT_FALSE(loader.checkAndReload());
+    gate.open();
+    loader.acquirePlugin();
+    ASSERT_EQ(pollWhile(loader, PluginLoadState::Initializing), PluginLoadState::Ready);
+    IPlugin* previous = loader.getPlugin();
+
+    // The new version's setup must not run inside checkAndReload()
+    gate.close();
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100)) {
+        EXPECT_FALSE(loader.checkAndReload());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_TRUE(loader.isReloadPending());
+    EXPECT_EQ(loader.getPlugin(), previous);
+
+    gate.open();
+    EXPECT_TRUE(waitForReload(loader));
+    EXPECT_TRUE(loader.isInitialized());
+    EXPECT_NE(loader.getPlugin(), nullptr);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Concurrent Access Tests
+// ============================================================================
+
+TEST_F(PluginLoaderTest, ReadPluginEmptyWhenNotLoaded) {
+    PluginLoader loader;
+    PluginLoader::ReadGuard plugin = loader.readPlugin();
+    EXPECT_FALSE(plugin);
+    EXPECT_EQ(plugin.getFunctionTable(), nullptr);
+}
+
+TEST_F(PluginLoaderTest, ReadPluginSeesLoadedInstance) {
+    PluginLoader loader;
+    ASSERT_TRUE(loader.loadPlugin(m_tablePluginPath));
+    {
+        PluginLoader::ReadGuard plugin = loader.readPlugin();
+        EXPECT_EQ(plugin.get(), loader.getPlugin());
+        EXPECT_EQ(plugin.getFunctionTable(), loader.getFunctionTable());
+    }
+    loader.unloadPlugin();
+    EXPECT_FALSE(loader.readPlugin());
+}
+
+TEST_F(PluginLoaderTest, ReadPluginWaitsForDeferredInitialization) {
+    PluginLoader loader;
+    loader.setLoadPolicy(LoadPolicy::Deferred);
+    ASSERT_TRUE(loader.loadPlugin(m_testPluginPath));
+    EXPECT_FALSE(loader.readPlugin());
+
+    ASSERT_TRUE(loader.initializePlugin());
+    EXPECT_TRUE(loader.readPlugin());
+}
+
+TEST_F(PluginLoaderTest, ReloadWaitsForReaders) {
+    std::string path = copyPlugin(m_testPluginPath, "loader_read_guard");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    std::atomic<bool> reloaded{false};
+    auto* held = new PluginLoader::ReadGuard(loader.readPlugin());
+    IPlugin* before = held->get();
+    replacePlugin(m_testPluginPath, path);
+    std::thread owner([&]() { reloaded = loader.checkAndReload(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // The old instance is still usable while the reload waits
+    EXPECT_STREQ((*held)->getName(), "TestPlugin");
+    EXPECT_FALSE(reloaded.load());
+
+    delete held;
+    owner.join();
+    EXPECT_TRUE(reloaded.load());
+    EXPECT_NE(loader.readPlugin().get(), before);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, ReadersRunDuringReloads) {
+    std::string path = copyPlugin(m_tablePluginPath, "loader_concurrent");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> calls{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                PluginLoader::ReadGuard plugin = loader.readPlugin();
+                // Read-only calls; the test plugin's counters are not thread-safe
+                int updateCount = 0;
+                if (plugin && plugin.getFunctionTable()->query(plugin.get(),
+                                                               fnv1a64("updateCount"),
+                                                               &updateCount, sizeof(updateCount))) {
+                    ++calls;
+                }
+            }
+        });
+    }
+
+    while (calls.load() == 0) {
+        std::this_thread::yield();
+    }
+    int reloads = 0;
+    for (int i = 0; i < 10; ++i) {
+        replacePlugin(m_tablePluginPath, path);
+        if (loader.checkAndReload()) {
+            ++reloads;
+        }
+    }
+    loader.unloadPlugin();
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(reloads, 10);
+    EXPECT_GT(calls.load(), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginLoaderTest, ReadersKeepInstanceDuringStateTransfer) {
+    std::string statefulPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "stateful_plugin_v2" + SHARED_LIB_SUFFIX;
+    std::string path = copyPlugin(statefulPath, "loader_state_readers");
+
+    PluginLoader loader;
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> updates{0};
+    std::thread reader([&]() {
+        while (!stop.load()) {
+            PluginLoader::ReadGuard plugin = loader.readPlugin();
+            if (plugin) {
+                plugin->onUpdate(0.016f);
+                ++updates;
+            }
+        }
+    });
+
+    while (updates.load() == 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 5; ++i) {
+        replacePlugin(statefulPath, path);
+        EXPECT_TRUE(loader.checkAndReload());
+    }
+    stop = true;
+    reader.join();
+
+    // No update lands on an old instance after its state was saved
+    uint64_t state[2] = {};
+    ASSERT_TRUE(loader.getPlugin()->saveState(state, sizeof(state)));
+    EXPECT_EQ(state[0], updates.load());
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
 // ============================================================================
 // Destructor Tests
 // ============================================================================
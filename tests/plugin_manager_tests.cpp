@@ -0,0 +1,1503 @@
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/plugin_loader.hpp"
+#include "hotplugpp/plugin_manager.hpp"
+#include "hotplugpp/shared_library.hpp"
+#include "test_plugin/async_init_gate.hpp"
+#include "test_plugin/plugin_files.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+class PluginManagerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_testPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "test_plugin" + SHARED_LIB_SUFFIX;
+        m_failingPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "failing_plugin" + SHARED_LIB_SUFFIX;
+        m_statefulV1Path = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "stateful_plugin_v1" + SHARED_LIB_SUFFIX;
+        m_statefulV2Path = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "stateful_plugin_v2" + SHARED_LIB_SUFFIX;
+        m_batchPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "batch_plugin" + SHARED_LIB_SUFFIX;
+        m_tablePluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "table_plugin" + SHARED_LIB_SUFFIX;
+        m_arenaPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "arena_plugin" + SHARED_LIB_SUFFIX;
+        m_asyncInitPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "async_init_plugin" + SHARED_LIB_SUFFIX;
+        m_failingAsyncInitPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "failing_async_init_plugin" + SHARED_LIB_SUFFIX;
+        m_blockingInitPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "blocking_init_plugin" + SHARED_LIB_SUFFIX;
+        m_slowPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "slow_plugin" + SHARED_LIB_SUFFIX;
+        m_legacyPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "legacy_plugin" + SHARED_LIB_SUFFIX;
+    }
+
+    /// Call pollLoads() until a plugin leaves a load state or the timeout expires
+    static PluginLoadState pollWhile(PluginManager& manager, PluginHandle handle,
+                                     PluginLoadState state) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (manager.getLoadState(handle) == state &&
+               std::chrono::steady_clock::now() < deadline) {
+            manager.pollLoads();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return manager.getLoadState(handle);
+    }
+
+    /// Call pollLoads() until a started reload is swapped in or dropped, or the timeout expires
+    static bool waitForReload(PluginManager& manager, PluginHandle handle) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (manager.isReloadPending(handle) && std::chrono::steady_clock::now() < deadline) {
+            manager.pollLoads();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return !manager.isReloadPending(handle);
+    }
+
+    /// Read the "updateCount" a plugin exposes through its function table
+    static uint64_t queryUpdateCount(PluginManager& manager, PluginHandle handle) {
+        const HotPlugPPFunctionTable* table = manager.getFunctionTable(handle);
+        IPlugin* plugin = manager.getPlugin(handle);
+        uint64_t count = 0;
+        if (table && plugin) {
+            table->query(plugin, fnv1a64("updateCount"), &count, sizeof(count));
+        }
+        return count;
+    }
+
+    /// Read the update count out of a StatefulPlugin through its state hooks
+    static uint64_t savedUpdateCount(IPlugin* plugin) {
+        std::vector<std::max_align_t> buffer(4);
+        size_t size = plugin->getStateSize();
+        if (size > buffer.size() * sizeof(std::max_align_t) ||
+            !plugin->saveState(buffer.data(), size)) {
+            return 0;
+        }
+        if (plugin->getStateVersion() == 1) {
+            uint32_t count = 0;
+            std::memcpy(&count, buffer.data(), sizeof(count));
+            return count;
+        }
+        uint64_t count = 0;
+        std::memcpy(&count, buffer.data(), sizeof(count));
+        return count;
+    }
+
+    std::string m_testPluginPath;
+    std::string m_failingPluginPath;
+    std::string m_statefulV1Path;
+    std::string m_statefulV2Path;
+    std::string m_batchPluginPath;
+    std::string m_tablePluginPath;
+    std::string m_arenaPluginPath;
+    std::string m_asyncInitPluginPath;
+    std::string m_failingAsyncInitPluginPath;
+    std::string m_blockingInitPluginPath;
+    std::string m_slowPluginPath;
+    std::string m_legacyPluginPath;
+};
+
+/// Reads the update counters exported by batch_plugin; keeps the library resident meanwhile
+class BatchCounters {
+  public:
+    explicit BatchCounters(const std::string& path) : m_library(loadLibrary(path)) {}
+    ~BatchCounters() { unloadLibrary(m_library); }
+
+    uint64_t batchCalls() const { return read("getBatchCallCount"); }
+    uint64_t batchedUpdates() const { return read("getBatchedUpdateCount"); }
+    uint64_t singleUpdates() const { return read("getSingleUpdateCount"); }
+
+  private:
+    uint64_t read(const char* name) const {
+        auto func = reinterpret_cast<uint64_t (*)()>(getFunction(m_library, name));
+        return func ? func() : 0;
+    }
+
+    LibraryHandle m_library;
+};
+
+// ============================================================================
+// Handle Tests
+// ============================================================================
+
+TEST(PluginHandleTest, DefaultHandleIsInvalid) {
+    PluginHandle handle;
+    EXPECT_FALSE(handle.isValid());
+}
+
+TEST(PluginHandleTest, IdRoundTrip) {
+    PluginHandle handle;
+    handle.index = 42;
+    handle.generation = 7;
+
+    PluginHandle restored = PluginHandle::fromId(handle.toId());
+    EXPECT_EQ(restored, handle);
+}
+
+// ============================================================================
+// Load / Unload Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, InitiallyEmpty) {
+    PluginManager manager;
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+    EXPECT_EQ(manager.getPlugin(PluginHandle()), nullptr);
+}
+
+TEST_F(PluginManagerTest, LoadValidPlugin) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+
+    ASSERT_TRUE(handle.isValid());
+    EXPECT_TRUE(manager.isValid(handle));
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+    EXPECT_EQ(manager.getPluginPath(handle), m_testPluginPath);
+
+    IPlugin* plugin = manager.getPlugin(handle);
+    ASSERT_NE(plugin, nullptr);
+    EXPECT_STREQ(plugin->getName(), "TestPlugin");
+}
+
+TEST_F(PluginManagerTest, LoadNonExistentPlugin) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin("/nonexistent/path/plugin.so");
+    EXPECT_FALSE(handle.isValid());
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+}
+
+TEST_F(PluginManagerTest, LoadPluginWithFailingOnLoad) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_failingPluginPath);
+    EXPECT_FALSE(handle.isValid());
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+}
+
+TEST_F(PluginManagerTest, UnloadInvalidatesHandle) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    EXPECT_TRUE(manager.unloadPlugin(handle));
+    EXPECT_FALSE(manager.isValid(handle));
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+    EXPECT_TRUE(manager.getPluginPath(handle).empty());
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+
+    // Second unload through the stale handle is a no-op
+    EXPECT_FALSE(manager.unloadPlugin(handle));
+}
+
+TEST_F(PluginManagerTest, ReusedSlotDoesNotResurrectStaleHandle) {
+    PluginManager manager;
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(manager.unloadPlugin(first));
+
+    PluginHandle second = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(second.isValid());
+
+    // Same slot, different generation
+    EXPECT_EQ(first.index, second.index);
+    EXPECT_NE(first.generation, second.generation);
+    EXPECT_EQ(manager.getPlugin(first), nullptr);
+    EXPECT_NE(manager.getPlugin(second), nullptr);
+}
+
+TEST_F(PluginManagerTest, OutOfRangeHandleResolvesToNull) {
+    PluginManager manager;
+    PluginHandle handle;
+    handle.index = 1000;
+    EXPECT_FALSE(manager.isValid(handle));
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+}
+
+TEST_F(PluginManagerTest, ManyPluginsStayAddressable) {
+    PluginManager manager;
+    std::vector<PluginHandle> handles;
+
+    for (int i = 0; i < 64; ++i) {
+        PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+        ASSERT_TRUE(handle.isValid());
+        handles.push_back(handle);
+    }
+    EXPECT_EQ(manager.getPluginCount(), 64u);
+
+    // Remove every other plugin, which moves rows around in the dense table
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        ASSERT_TRUE(manager.unloadPlugin(handles[i]));
+    }
+    EXPECT_EQ(manager.getPluginCount(), 32u);
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (i % 2 == 0) {
+            EXPECT_EQ(manager.getPlugin(handles[i]), nullptr);
+        } else {
+            EXPECT_NE(manager.getPlugin(handles[i]), nullptr);
+        }
+    }
+}
+
+TEST_F(PluginManagerTest, UnloadAll) {
+    PluginManager manager;
+    PluginHandle a = manager.loadPlugin(m_testPluginPath);
+    PluginHandle b = manager.loadPlugin(m_testPluginPath);
+
+    manager.unloadAll();
+
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+    EXPECT_FALSE(manager.isValid(a));
+    EXPECT_FALSE(manager.isValid(b));
+}
+
+// ============================================================================
+// Lookup Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, FindPluginByName) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+
+    EXPECT_EQ(manager.findPlugin("TestPlugin"), handle);
+    EXPECT_FALSE(manager.findPlugin("NoSuchPlugin").isValid());
+}
+
+TEST_F(PluginManagerTest, FindPluginFallsBackToRemainingInstance) {
+    PluginManager manager;
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    PluginHandle second = manager.loadPlugin(m_testPluginPath);
+
+    EXPECT_EQ(manager.findPlugin("TestPlugin"), first);
+
+    manager.unloadPlugin(first);
+    EXPECT_EQ(manager.findPlugin("TestPlugin"), second);
+
+    manager.unloadPlugin(second);
+    EXPECT_FALSE(manager.findPlugin("TestPlugin").isValid());
+}
+
+TEST_F(PluginManagerTest, GetHandleAtCoversAllPlugins) {
+    PluginManager manager;
+    PluginHandle a = manager.loadPlugin(m_testPluginPath);
+    PluginHandle b = manager.loadPlugin(m_testPluginPath);
+
+    ASSERT_EQ(manager.getPluginCount(), 2u);
+    EXPECT_EQ(manager.getHandleAt(0), a);
+    EXPECT_EQ(manager.getHandleAt(1), b);
+    EXPECT_FALSE(manager.getHandleAt(2).isValid());
+}
+
+// ============================================================================
+// Batch Load Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, LoadPluginsReportsPerPluginResults) {
+    PluginManager manager;
+    std::vector<std::string> paths = {m_testPluginPath, "/nonexistent/plugin.so",
+                                      m_failingPluginPath};
+
+    auto results = manager.loadPlugins(paths);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_TRUE(results[0].handle.isValid());
+    EXPECT_TRUE(results[0].error.empty());
+    EXPECT_FALSE(results[1].success);
+    EXPECT_FALSE(results[1].error.empty());
+    EXPECT_FALSE(results[2].success);
+    EXPECT_FALSE(results[2].handle.isValid());
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+    EXPECT_NE(manager.getPlugin(results[0].handle), nullptr);
+}
+
+TEST_F(PluginManagerTest, LoadPluginsManyInParallel) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 16; ++i) {
+        paths.push_back(copyPlugin(m_testPluginPath, "batch_" + std::to_string(i)));
+    }
+
+    PluginManager manager;
+    BatchLoadOptions options;
+    options.threadCount = 4;
+    auto results = manager.loadPlugins(paths, options);
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_TRUE(results[i].success) << results[i].error;
+        EXPECT_EQ(manager.getPluginPath(results[i].handle), paths[i]);
+    }
+    EXPECT_EQ(manager.getPluginCount(), paths.size());
+
+    manager.unloadAll();
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_F(PluginManagerTest, LoadPluginsFailedDependencyFailsDependents) {
+    std::string base = copyPlugin(m_failingPluginPath, "dep_base");
+    std::string middle = copyPlugin(m_testPluginPath, "dep_middle");
+    std::string top = copyPlugin(m_testPluginPath, "dep_top");
+    std::string independent = copyPlugin(m_testPluginPath, "dep_independent");
+
+    std::vector<PluginLoadRequest> requests(4);
+    requests[0].path = top;
+    requests[0].dependencies = {middle};
+    requests[1].path = middle;
+    requests[1].dependencies = {base};
+    requests[2].path = base;
+    requests[3].path = independent;
+
+    for (bool parallelInit : {true, false}) {
+        PluginManager manager;
+        BatchLoadOptions options;
+        options.parallelInit = parallelInit;
+        auto results = manager.loadPlugins(requests, options);
+
+        ASSERT_EQ(results.size(), 4u);
+        EXPECT_FALSE(results[0].success);
+        EXPECT_FALSE(results[1].success);
+        EXPECT_FALSE(results[2].success);
+        EXPECT_TRUE(results[3].success);
+        EXPECT_NE(results[1].error.find(base), std::string::npos);
+        EXPECT_EQ(manager.getPluginCount(), 1u);
+    }
+
+    for (const auto& path : {base, middle, top, independent}) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_F(PluginManagerTest, LoadPluginsDependencyChainSucceeds) {
+    std::string first = copyPlugin(m_testPluginPath, "chain_first");
+    std::string second = copyPlugin(m_testPluginPath, "chain_second");
+
+    std::vector<PluginLoadRequest> requests(2);
+    requests[0].path = second;
+    requests[0].dependencies = {first};
+    requests[1].path = first;
+
+    PluginManager manager;
+    auto results = manager.loadPlugins(requests);
+
+    EXPECT_TRUE(results[0].success) << results[0].error;
+    EXPECT_TRUE(results[1].success) << results[1].error;
+    EXPECT_EQ(manager.getPluginCount(), 2u);
+
+    manager.unloadAll();
+    std::filesystem::remove(first);
+    std::filesystem::remove(second);
+}
+
+TEST_F(PluginManagerTest, LoadPluginsRejectsCyclesAndUnknownDependencies) {
+    std::string a = copyPlugin(m_testPluginPath, "cycle_a");
+    std::string b = copyPlugin(m_testPluginPath, "cycle_b");
+
+    std::vector<PluginLoadRequest> requests(3);
+    requests[0].path = a;
+    requests[0].dependencies = {b};
+    requests[1].path = b;
+    requests[1].dependencies = {a};
+    requests[2].path = m_testPluginPath;
+    requests[2].dependencies = {"/not/in/batch.so"};
+
+    PluginManager manager;
+    auto results = manager.loadPlugins(requests);
+
+    for (const auto& result : results) {
+        EXPECT_FALSE(result.success);
+        EXPECT_FALSE(result.error.empty());
+    }
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+
+    std::filesystem::remove(a);
+    std::filesystem::remove(b);
+}
+
+TEST_F(PluginManagerTest, LoadPluginsEmptyBatch) {
+    PluginManager manager;
+    auto results = manager.loadPlugins(std::vector<std::string>());
+    EXPECT_TRUE(results.empty());
+}
+
+// ============================================================================
+// Update / Reload Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, UpdateAllWithPlugins) {
+    PluginManager manager;
+    manager.loadPlugin(m_testPluginPath);
+    manager.loadPlugin(m_testPluginPath);
+
+    // Should not throw or crash
+    for (int i = 0; i < 10; ++i) {
+        manager.updateAll(0.016f);
+    }
+}
+
+TEST_F(PluginManagerTest, ParallelUpdateRunsEveryPlugin) {
+    PluginManager manager;
+    EXPECT_FALSE(manager.isParallelUpdateEnabled());
+    manager.enableParallelUpdate(true, 4);
+    EXPECT_TRUE(manager.isParallelUpdateEnabled());
+
+    std::vector<PluginHandle> handles;
+    for (int i = 0; i < 8; ++i) {
+        handles.push_back(manager.loadPlugin(m_statefulV2Path));
+        ASSERT_TRUE(manager.setUpdateAccess(handles.back(), {"input"},
+                                            {"entity." + std::to_string(i)}));
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        manager.updateAll(0.016f);
+    }
+
+    for (PluginHandle handle : handles) {
+        EXPECT_EQ(savedUpdateCount(manager.getPlugin(handle)), 5u);
+        UpdateStats stats = manager.getUpdateStats(handle);
+        EXPECT_EQ(stats.updateCount, 5u);
+        EXPECT_GE(stats.maxDuration, stats.lastDuration);
+        EXPECT_GE(stats.totalDuration, stats.maxDuration);
+    }
+
+    // Nothing conflicts, so every plugin is a root of the graph
+    const UpdateScheduler* scheduler = manager.getUpdateScheduler();
+    ASSERT_NE(scheduler, nullptr);
+    EXPECT_EQ(scheduler->getTaskCount(), 8u);
+    EXPECT_EQ(scheduler->getCriticalPathLength(), 1u);
+
+    manager.enableParallelUpdate(false);
+    EXPECT_EQ(manager.getUpdateScheduler(), nullptr);
+    manager.updateAll(0.016f);
+    EXPECT_EQ(savedUpdateCount(manager.getPlugin(handles[0])), 6u);
+}
+
+TEST_F(PluginManagerTest, UndeclaredPluginsUpdateAlone) {
+    PluginManager manager;
+    manager.enableParallelUpdate(true, 2);
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    PluginHandle second = manager.loadPlugin(m_testPluginPath);
+    PluginHandle third = manager.loadPlugin(m_testPluginPath);
+    manager.updateAll(0.016f);
+    EXPECT_EQ(manager.getUpdateScheduler()->getCriticalPathLength(), 3u);
+
+    ASSERT_TRUE(manager.setUpdateAccess(first, {}, {"a"}));
+    ASSERT_TRUE(manager.setUpdateAccess(second, {}, {"b"}));
+    ASSERT_TRUE(manager.setUpdateAccess(third, {"a"}, {}));
+    manager.updateAll(0.016f);
+    EXPECT_EQ(manager.getUpdateScheduler()->getCriticalPathLength(), 2u);
+    EXPECT_EQ(manager.getUpdateStats(third).updateCount, 2u);
+}
+
+TEST_F(PluginManagerTest, UpdateGraphFollowsLoadOrderAfterRemoval) {
+    PluginManager manager;
+    manager.enableParallelUpdate(true, 1);
+    PluginHandle a = manager.loadPlugin(m_testPluginPath);
+    PluginHandle b = manager.loadPlugin(m_testPluginPath);
+    PluginHandle c = manager.loadPlugin(m_testPluginPath);
+    for (PluginHandle handle : {a, b, c}) {
+        ASSERT_TRUE(manager.setUpdateAccess(handle, {}, {"shared"}));
+    }
+
+    // Removing a moves c into a's dense row; the graph is rebuilt for the remaining two
+    ASSERT_TRUE(manager.unloadPlugin(a));
+    manager.updateAll(0.016f);
+
+    const UpdateScheduler* scheduler = manager.getUpdateScheduler();
+    ASSERT_EQ(scheduler->getTaskCount(), 2u);
+    EXPECT_EQ(scheduler->getDependencies(1), std::vector<uint32_t>({0}));
+    EXPECT_EQ(manager.getUpdateStats(b).updateCount, 1u);
+    EXPECT_EQ(manager.getUpdateStats(c).updateCount, 1u);
+}
+
+TEST_F(PluginManagerTest, BatchPluginUpdatesAllInstancesInOneCall) {
+    BatchCounters counters(m_batchPluginPath);
+    const uint64_t calls = counters.batchCalls();
+    const uint64_t batched = counters.batchedUpdates();
+    const uint64_t single = counters.singleUpdates();
+
+    PluginManager manager;
+    std::vector<PluginHandle> batchHandles;
+    for (int i = 0; i < 4; ++i) {
+        batchHandles.push_back(manager.loadPlugin(m_batchPluginPath));
+        // Interleave plugins without a batch entry point
+        PluginHandle other = manager.loadPlugin(m_testPluginPath);
+        EXPECT_FALSE(manager.isBatchUpdated(other));
+    }
+    EXPECT_TRUE(manager.isBatchUpdated(batchHandles[0]));
+
+    for (int i = 0; i < 3; ++i) {
+        manager.updateAll(0.016f);
+    }
+    EXPECT_EQ(counters.batchCalls() - calls, 3u);
+    EXPECT_EQ(counters.batchedUpdates() - batched, 12u);
+    EXPECT_EQ(counters.singleUpdates() - single, 0u);
+
+    // Unloading regroups the remaining instances
+    ASSERT_TRUE(manager.unloadPlugin(batchHandles[1]));
+    EXPECT_FALSE(manager.isBatchUpdated(batchHandles[1]));
+    manager.updateAll(0.016f);
+    EXPECT_EQ(counters.batchCalls() - calls, 4u);
+    EXPECT_EQ(counters.batchedUpdates() - batched, 15u);
+}
+
+TEST_F(PluginManagerTest, ParallelUpdateCallsOnUpdateOfBatchPlugins) {
+    BatchCounters counters(m_batchPluginPath);
+    const uint64_t calls = counters.batchCalls();
+    const uint64_t single = counters.singleUpdates();
+
+    PluginManager manager;
+    manager.enableParallelUpdate(true, 2);
+    for (int i = 0; i < 3; ++i) {
+        manager.loadPlugin(m_batchPluginPath);
+    }
+    manager.updateAll(0.016f);
+
+    EXPECT_EQ(counters.batchCalls() - calls, 0u);
+    EXPECT_EQ(counters.singleUpdates() - single, 3u);
+}
+
+TEST_F(PluginManagerTest, ReloadRefreshesBatchEntryPoint) {
+    std::string path = copyPlugin(m_batchPluginPath, "manager_batch_reload");
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    manager.updateAll(0.016f);
+
+    // The old library is closed by the reload; updating must go through the new one
+    replacePlugin(m_batchPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_TRUE(manager.isBatchUpdated(handle));
+    manager.updateAll(0.016f);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, FunctionTableDrivesUpdates) {
+    PluginManager manager;
+    PluginHandle plain = manager.loadPlugin(m_testPluginPath);
+    std::vector<PluginHandle> handles;
+    for (int i = 0; i < 3; ++i) {
+        handles.push_back(manager.loadPlugin(m_tablePluginPath));
+    }
+    EXPECT_EQ(manager.getFunctionTable(plain), nullptr);
+    ASSERT_NE(manager.getFunctionTable(handles[0]), nullptr);
+    // The generated table always has a batch entry point
+    EXPECT_TRUE(manager.isBatchUpdated(handles[0]));
+
+    auto updateCount = [&manager](PluginHandle handle) {
+        int count = -1;
+        const HotPlugPPFunctionTable* table = manager.getFunctionTable(handle);
+        table->query(manager.getPlugin(handle), fnv1a64("updateCount"), &count, sizeof(count));
+        return count;
+    };
+
+    manager.updateAll(0.016f);
+    manager.updateAll(0.016f);
+    manager.enableParallelUpdate(true, 2);
+    manager.updateAll(0.016f);
+    for (PluginHandle handle : handles) {
+        EXPECT_EQ(updateCount(handle), 3);
+    }
+}
+
+TEST_F(PluginManagerTest, EveryArenaPluginInstanceGetsItsOwnArena) {
+    PluginManager manager;
+    PluginHandle plain = manager.loadPlugin(m_testPluginPath);
+    PluginHandle first = manager.loadPlugin(m_arenaPluginPath);
+    PluginHandle second = manager.loadPlugin(m_arenaPluginPath);
+    EXPECT_EQ(manager.getArena(plain), nullptr);
+    ASSERT_NE(manager.getArena(first), nullptr);
+    ASSERT_NE(manager.getArena(second), nullptr);
+    EXPECT_NE(manager.getArena(first), manager.getArena(second));
+
+    // Unloading the first moves the second into its dense row; the arena moves with it
+    const Arena* secondArena = manager.getArena(second);
+    ASSERT_TRUE(manager.unloadPlugin(first));
+    EXPECT_EQ(manager.getArena(first), nullptr);
+    EXPECT_EQ(manager.getArena(second), secondArena);
+    manager.updateAll(0.016f);
+}
+
+TEST_F(PluginManagerTest, ReloadStartsWithFreshArena) {
+    std::string path = copyPlugin(m_arenaPluginPath, "manager_arena_reload");
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    for (int i = 0; i < 100; ++i) {
+        manager.updateAll(0.016f);
+    }
+    const size_t grown = manager.getArena(handle)->getBytesUsed();
+
+    // The leaked blocks of the old instance go away with its arena
+    replacePlugin(m_arenaPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    ASSERT_NE(manager.getArena(handle), nullptr);
+    EXPECT_LT(manager.getArena(handle)->getBytesUsed(), grown);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, SetUpdateAccessRejectsStaleHandle) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(manager.unloadPlugin(handle));
+    EXPECT_FALSE(manager.setUpdateAccess(handle, {}, {"a"}));
+    EXPECT_EQ(manager.getUpdateStats(handle).updateCount, 0u);
+}
+
+TEST_F(PluginManagerTest, CheckAndReloadNoChange) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+    EXPECT_TRUE(manager.isValid(handle));
+}
+
+TEST_F(PluginManagerTest, ReloadKeepsHandleValid) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_reload");
+
+    PluginManager manager;
+    PluginHandle reloadedHandle;
+    manager.setReloadCallback([&reloadedHandle](PluginHandle handle) { reloadedHandle = handle; });
+
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    EXPECT_TRUE(manager.isReloadPending(handle));
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(reloadedHandle, handle);
+    EXPECT_TRUE(manager.isValid(handle));
+    EXPECT_NE(manager.getPlugin(handle), nullptr);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, FailedReloadKeepsPreviousVersion) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_fail");
+
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    PluginHandle other = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    IPlugin* before = manager.getPlugin(handle);
+
+    replacePlugin(m_failingPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_TRUE(manager.isValid(handle));
+    EXPECT_EQ(manager.getPlugin(handle), before);
+    EXPECT_STREQ(manager.getPlugin(handle)->getName(), "TestPlugin");
+    EXPECT_TRUE(manager.isValid(other));
+
+    // The broken build is not retried until the file changes again
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, ContentHashingSkipsIdenticalRebuild) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_identical");
+
+    PluginManager manager;
+    EXPECT_FALSE(manager.isContentHashingEnabled());
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+
+    // Enabling it after loading adopts the file that is loaded
+    manager.setContentHashing(true);
+    EXPECT_TRUE(manager.isContentHashingEnabled());
+    IPlugin* before = manager.getPlugin(handle);
+
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+    EXPECT_EQ(manager.getPlugin(handle), before);
+
+    replacePlugin(m_statefulV1Path, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_STREQ(manager.getPlugin(handle)->getName(), "StatefulPlugin");
+
+    // Without hashing, a fresh copy of the same bytes is reloaded
+    manager.setContentHashing(false);
+    replacePlugin(m_statefulV1Path, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, ReloadDebounceReloadsOncePerBuild) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_debounce");
+
+    PluginManager manager;
+    manager.setReloadDebounce(std::chrono::milliseconds(100));
+    EXPECT_EQ(manager.getReloadDebounce(), std::chrono::milliseconds(100));
+    PluginHandle handle = manager.loadPlugin(path);
+    PluginHandle other = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(handle.isValid());
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+
+    // Two bursts of the same build: neither is acted on until the file is quiet
+    replacePlugin(m_statefulV1Path, path);
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+    replacePlugin(m_statefulV1Path, path);
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+    EXPECT_STREQ(manager.getPlugin(handle)->getName(), "TestPlugin");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(reloads, 1);
+    EXPECT_STREQ(manager.getPlugin(handle)->getName(), "StatefulPlugin");
+    EXPECT_TRUE(manager.isValid(other));
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, FileWatcherTriggersReload) {
+    std::string watched = copyPlugin(m_testPluginPath, "manager_watched");
+    std::string untouched = copyPlugin(m_testPluginPath, "manager_untouched");
+
+    PluginManager manager;
+    PluginHandle watchedHandle = manager.loadPlugin(watched);
+    PluginHandle untouchedHandle = manager.loadPlugin(untouched);
+    ASSERT_TRUE(manager.enableFileWatcher());
+    EXPECT_TRUE(manager.isFileWatcherEnabled());
+
+    std::vector<PluginHandle> reloadedHandles;
+    manager.setReloadCallback(
+        [&reloadedHandles](PluginHandle handle) { reloadedHandles.push_back(handle); });
+
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+
+    replacePlugin(m_testPluginPath, watched);
+
+    size_t reloaded = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (reloaded == 0 && std::chrono::steady_clock::now() < deadline) {
+        reloaded = manager.checkAndReload();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(reloaded, 1u);
+    ASSERT_TRUE(waitForReload(manager, watchedHandle));
+    ASSERT_EQ(reloadedHandles.size(), 1u);
+    EXPECT_EQ(reloadedHandles[0], watchedHandle);
+    EXPECT_TRUE(manager.isValid(watchedHandle));
+    EXPECT_TRUE(manager.isValid(untouchedHandle));
+
+    manager.unloadAll();
+    std::filesystem::remove(watched);
+    std::filesystem::remove(untouched);
+}
+
+// ============================================================================
+// Load Policy Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, DeferredPluginsInitializeOnFirstUpdate) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    PluginHandle second = manager.loadPlugin(m_batchPluginPath);
+    EXPECT_EQ(manager.getPendingInitCount(), 2u);
+    EXPECT_FALSE(manager.isInitialized(first));
+
+    // Lookup by name does not count as use
+    EXPECT_EQ(manager.findPlugin("TestPlugin"), first);
+    EXPECT_EQ(manager.getPendingInitCount(), 2u);
+
+    manager.updateAll(0.016f);
+    EXPECT_EQ(manager.getPendingInitCount(), 0u);
+    EXPECT_TRUE(manager.isInitialized(first));
+    EXPECT_TRUE(manager.isInitialized(second));
+}
+
+TEST_F(PluginManagerTest, AcquirePluginInitializesOnlyThatPlugin) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    PluginHandle second = manager.loadPlugin(m_testPluginPath);
+
+    ASSERT_NE(manager.acquirePlugin(second), nullptr);
+    EXPECT_TRUE(manager.isInitialized(second));
+    EXPECT_FALSE(manager.isInitialized(first));
+    EXPECT_EQ(manager.getPendingInitCount(), 1u);
+}
+
+TEST_F(PluginManagerTest, GetPluginDoesNotInitialize) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+    EXPECT_FALSE(manager.isInitialized(handle));
+    ASSERT_NE(manager.acquirePlugin(handle), nullptr);
+    EXPECT_EQ(manager.getPlugin(handle), manager.acquirePlugin(handle));
+}
+
+TEST_F(PluginManagerTest, InitializePendingHonorsBudget) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(manager.loadPlugin(m_testPluginPath).isValid());
+    }
+
+    // The smallest budget still initializes at least one plugin per call
+    size_t initialized = manager.initializePending(std::chrono::microseconds(1));
+    EXPECT_GE(initialized, 1u);
+    EXPECT_EQ(manager.getPendingInitCount(), 4u - initialized);
+    EXPECT_EQ(manager.initializePending(), 4u - initialized);
+    EXPECT_EQ(manager.getPendingInitCount(), 0u);
+}
+
+TEST_F(PluginManagerTest, FailedDeferredInitRemovesPlugin) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    PluginHandle failing = manager.loadPlugin(m_failingPluginPath);
+    PluginHandle valid = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(failing.isValid());
+
+    EXPECT_EQ(manager.acquirePlugin(failing), nullptr);
+    EXPECT_FALSE(manager.isValid(failing));
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+    EXPECT_EQ(manager.initializePending(), 1u);
+    EXPECT_TRUE(manager.isInitialized(valid));
+}
+
+TEST_F(PluginManagerTest, DeferredBatchLoadSkipsOnLoad) {
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    std::vector<PluginLoadRequest> requests(2);
+    requests[0].path = m_batchPluginPath;
+    requests[0].dependencies = {m_testPluginPath};
+    requests[1].path = m_testPluginPath;
+
+    auto results = manager.loadPlugins(requests);
+    ASSERT_TRUE(results[0].success);
+    ASSERT_TRUE(results[1].success);
+    EXPECT_EQ(manager.getPendingInitCount(), 2u);
+
+    // Registered in dependency order, so the dependency comes first
+    EXPECT_EQ(manager.getHandleAt(0), results[1].handle);
+    EXPECT_EQ(manager.initializePending(), 2u);
+}
+
+TEST_F(PluginManagerTest, ReloadKeepsDeferredPluginUninitialized) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_deferred_reload");
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    PluginHandle handle = manager.loadPlugin(path);
+
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_FALSE(manager.isInitialized(handle));
+    ASSERT_NE(manager.acquirePlugin(handle), nullptr);
+    EXPECT_TRUE(manager.isInitialized(handle));
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, DeferredPluginUsedDuringReloadGetsInitializedBuild) {
+    std::string path = copyPlugin(m_testPluginPath, "manager_deferred_reload_used");
+    PluginManager manager;
+    manager.setLoadPolicy(LoadPolicy::Deferred);
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+    PluginHandle handle = manager.loadPlugin(path);
+
+    // The reload was started without onLoad(); the new build catches up before the swap
+    replacePlugin(m_testPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_NE(manager.acquirePlugin(handle), nullptr);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(reloads, 1);
+    EXPECT_TRUE(manager.isInitialized(handle));
+    EXPECT_EQ(manager.getPendingInitCount(), 0u);
+    ASSERT_NE(manager.getPlugin(handle), nullptr);
+    manager.updateAll(0.016f);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Asynchronous Load Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, LoadPluginAsyncIsAdoptedByPoll) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPluginAsync(m_testPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    // Nothing is visible until a poll adopts the finished load
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Loading);
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Loading), PluginLoadState::Ready);
+    ASSERT_NE(manager.getPlugin(handle), nullptr);
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+    EXPECT_EQ(manager.findPlugin("TestPlugin"), handle);
+}
+
+TEST_F(PluginManagerTest, FailedAsyncLoadGoesStale) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPluginAsync("/nonexistent/plugin.so");
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Loading), PluginLoadState::Unloaded);
+    EXPECT_EQ(manager.getPluginCount(), 0u);
+
+    // The slot is reused without resurrecting the handle
+    PluginHandle next = manager.loadPlugin(m_testPluginPath);
+    EXPECT_EQ(next.index, handle.index);
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+}
+
+TEST_F(PluginManagerTest, UnloadCancelsAsyncLoad) {
+    PluginManager manager;
+    PluginHandle cancelled = manager.loadPluginAsync(m_testPluginPath);
+    PluginHandle kept = manager.loadPluginAsync(m_tablePluginPath);
+    EXPECT_TRUE(manager.unloadPlugin(cancelled));
+    EXPECT_FALSE(manager.unloadPlugin(cancelled));
+    EXPECT_EQ(manager.getLoadState(cancelled), PluginLoadState::Unloaded);
+
+    EXPECT_EQ(pollWhile(manager, kept, PluginLoadState::Loading), PluginLoadState::Ready);
+    EXPECT_EQ(manager.getPlugin(cancelled), nullptr);
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+
+    // The destructor waits for loads still in flight
+    manager.loadPluginAsync(m_testPluginPath);
+}
+
+TEST_F(PluginManagerTest, GetPluginHidesPluginsUntilReady) {
+    AsyncInitGate gate;
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_asyncInitPluginPath);
+    ASSERT_EQ(manager.getLoadState(handle), PluginLoadState::Initializing);
+    EXPECT_EQ(manager.getPlugin(handle), nullptr);
+    EXPECT_EQ(manager.acquirePlugin(handle), nullptr);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+    EXPECT_NE(manager.getPlugin(handle), nullptr);
+    EXPECT_EQ(manager.acquirePlugin(handle), manager.getPlugin(handle));
+}
+
+TEST_F(PluginManagerTest, UpdateAllSkipsPluginsUntilReady) {
+    AsyncInitGate gate;
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_asyncInitPluginPath);
+    ASSERT_TRUE(handle.isValid());
+    EXPECT_TRUE(manager.isInitialized(handle));
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Initializing);
+
+    for (int i = 0; i < 3; ++i) {
+        manager.updateAll(0.016f);
+    }
+    EXPECT_EQ(queryUpdateCount(manager, handle), 0u);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+    manager.updateAll(0.016f);
+    EXPECT_EQ(queryUpdateCount(manager, handle), 1u);
+}
+
+TEST_F(PluginManagerTest, ParallelUpdateSkipsPluginsUntilReady) {
+    AsyncInitGate gate;
+    PluginManager manager;
+    manager.enableParallelUpdate(true, 2);
+    PluginHandle initializing = manager.loadPlugin(m_asyncInitPluginPath);
+    PluginHandle ready = manager.loadPlugin(m_tablePluginPath);
+
+    manager.updateAll(0.016f);
+    EXPECT_EQ(queryUpdateCount(manager, initializing), 0u);
+    EXPECT_EQ(manager.getUpdateStats(ready).updateCount, 1u);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(manager, initializing, PluginLoadState::Initializing),
+              PluginLoadState::Ready);
+    manager.updateAll(0.016f);
+    EXPECT_EQ(queryUpdateCount(manager, initializing), 1u);
+    EXPECT_EQ(manager.getUpdateStats(ready).updateCount, 2u);
+}
+
+TEST_F(PluginManagerTest, AsyncLoadWaitsForAsyncInit) {
+    AsyncInitGate gate;
+    PluginManager manager;
+    PluginHandle handle = manager.loadPluginAsync(m_asyncInitPluginPath);
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Loading),
+              PluginLoadState::Initializing);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+}
+
+TEST_F(PluginManagerTest, FailedAsyncInitUnloadsPlugin) {
+    AsyncInitGate gate;
+    PluginManager manager;
+    PluginHandle failing = manager.loadPlugin(m_failingAsyncInitPluginPath);
+    PluginHandle valid = manager.loadPlugin(m_testPluginPath);
+    EXPECT_EQ(manager.getLoadState(failing), PluginLoadState::Initializing);
+
+    gate.open();
+    EXPECT_EQ(pollWhile(manager, failing, PluginLoadState::Initializing),
+              PluginLoadState::Unloaded);
+    EXPECT_FALSE(manager.isValid(failing));
+    EXPECT_EQ(manager.getPluginCount(), 1u);
+    EXPECT_EQ(manager.getLoadState(valid), PluginLoadState::Ready);
+}
+
+TEST_F(PluginManagerTest, ReloadWaitsForAsyncInit) {
+    std::string path = copyPlugin(m_asyncInitPluginPath, "manager_async_init_reload");
+    AsyncInitGate gate;
+    PluginManager manager;
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+    PluginHandle handle = manager.loadPlugin(path);
+    gate.open();
+    ASSERT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+    manager.updateAll(0.016f);
+    const IPlugin* previous = manager.getPlugin(handle);
+
+    // checkAndReload() does not wait for the new build's setup; the old one keeps running
+    gate.close();
+    replacePlugin(m_asyncInitPluginPath, path);
+    std::future<size_t> reloaded =
+        std::async(std::launch::async, [&manager]() { return manager.checkAndReload(); });
+    ASSERT_EQ(reloaded.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(reloaded.get(), 1u);
+    for (int i = 0; i < 5; ++i) {
+        manager.updateAll(0.016f);
+    }
+    EXPECT_EQ(manager.getPlugin(handle), previous);
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Ready);
+    EXPECT_EQ(queryUpdateCount(manager, handle), 6u);
+    EXPECT_EQ(reloads, 0);
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+
+    // Swapped in by the first frame that sees it ready
+    gate.open();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (reloads == 0 && std::chrono::steady_clock::now() < deadline) {
+        manager.pollLoads();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(reloads, 1);
+    EXPECT_NE(manager.getPlugin(handle), previous);
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Ready);
+
+    manager.updateAll(0.016f);
+    EXPECT_EQ(queryUpdateCount(manager, handle), 1u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, CheckAndReloadDoesNotWaitForOnLoad) {
+    std::string path = copyPlugin(m_blockingInitPluginPath, "manager_blocking_reload");
+    AsyncInitGate gate;
+    PluginManager manager;
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+    gate.open();
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    const IPlugin* previous = manager.getPlugin(handle);
+
+    // The new build's onLoad() blocks until the gate opens; the caller must not
+    gate.close();
+    replacePlugin(m_blockingInitPluginPath, path);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    for (int i = 0; i < 5; ++i) {
+        manager.updateAll(0.016f);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_TRUE(manager.isReloadPending(handle));
+    EXPECT_EQ(manager.getPlugin(handle), previous);
+    EXPECT_EQ(queryUpdateCount(manager, handle), 5u);
+    EXPECT_EQ(reloads, 0);
+
+    gate.open();
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(reloads, 1);
+    manager.updateAll(0.016f);
+    EXPECT_EQ(queryUpdateCount(manager, handle), 1u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, UnloadWaitsForReloadStillLoading) {
+    std::string path = copyPlugin(m_blockingInitPluginPath, "manager_blocking_reload_unload");
+    AsyncInitGate gate;
+    PluginManager manager;
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+    gate.open();
+    PluginHandle handle = manager.loadPlugin(path);
+
+    gate.close();
+    replacePlugin(m_blockingInitPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    EXPECT_TRUE(manager.unloadPlugin(handle));
+    EXPECT_FALSE(manager.isReloadPending(handle));
+
+    // The cancelled build is released once its onLoad() returns, without a callback
+    gate.open();
+    manager.unloadAll();
+    EXPECT_EQ(reloads, 0);
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, ReloadFailingAsyncInitKeepsPreviousVersion) {
+    std::string path = copyPlugin(m_asyncInitPluginPath, "manager_async_init_reload_fail");
+    AsyncInitGate gate;
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    gate.open();
+    ASSERT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+    const IPlugin* previous = manager.getPlugin(handle);
+
+    gate.close();
+    replacePlugin(m_failingAsyncInitPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    gate.open();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < deadline) {
+        manager.updateAll(0.016f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(manager.getPlugin(handle), previous);
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Ready);
+
+    // The broken build is not retried until the file changes again
+    EXPECT_EQ(manager.checkAndReload(), 0u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, UnloadDiscardsPendingReload) {
+    std::string path = copyPlugin(m_asyncInitPluginPath, "manager_async_init_reload_unload");
+    AsyncInitGate gate;
+    PluginManager manager;
+    int reloads = 0;
+    manager.setReloadCallback([&reloads](PluginHandle) { ++reloads; });
+    PluginHandle handle = manager.loadPlugin(path);
+    gate.open();
+    ASSERT_EQ(pollWhile(manager, handle, PluginLoadState::Initializing), PluginLoadState::Ready);
+
+    gate.close();
+    replacePlugin(m_asyncInitPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 1u);
+    EXPECT_TRUE(manager.unloadPlugin(handle));
+    EXPECT_FALSE(manager.isReloadPending(handle));
+
+    gate.open();
+    EXPECT_EQ(manager.pollLoads(), 0u);
+    EXPECT_EQ(reloads, 0);
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Interface Version Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, HooksMissingFromPluginInterfaceAreNotCalled) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_legacyPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    // Its getInitStatus() reports Failed and would get it unloaded if it were called
+    EXPECT_EQ(manager.pollLoads(), 0u);
+    EXPECT_EQ(manager.getLoadState(handle), PluginLoadState::Ready);
+    EXPECT_EQ(manager.getUpdateBudget(handle), std::chrono::nanoseconds::zero());
+    manager.updateAll(0.016f);
+    EXPECT_NE(manager.getPlugin(handle), nullptr);
+}
+
+// ============================================================================
+// Library Sharing Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, InstancesOfOneFileShareOneLibrary) {
+    PluginManager manager;
+    PluginHandle first = manager.loadPlugin(m_testPluginPath);
+    PluginHandle second = manager.loadPlugin(m_testPluginPath);
+    PluginHandle third = manager.loadPlugin(m_testPluginPath);
+    EXPECT_EQ(manager.getLibraryInstanceCount(first), 3u);
+    EXPECT_EQ(manager.getLibraryInstanceCount(third), 3u);
+    EXPECT_EQ(PluginLoader::getLibraryInstanceCount(m_testPluginPath), 3u);
+
+    ASSERT_TRUE(manager.unloadPlugin(second));
+    EXPECT_EQ(manager.getLibraryInstanceCount(first), 2u);
+    EXPECT_EQ(manager.getLibraryInstanceCount(second), 0u);
+
+    manager.unloadAll();
+    EXPECT_EQ(PluginLoader::getLibraryInstanceCount(m_testPluginPath), 0u);
+}
+
+TEST_F(PluginManagerTest, ReloadedInstancesShareOneCopy) {
+    std::string path = copyPlugin(m_batchPluginPath, "manager_shared_reload");
+    PluginManager manager;
+    std::vector<PluginHandle> handles;
+    for (int i = 0; i < 3; ++i) {
+        handles.push_back(manager.loadPlugin(path));
+        ASSERT_TRUE(handles.back().isValid());
+    }
+
+    // One copy of the new build serves every instance, so they stay in one batch
+    replacePlugin(m_batchPluginPath, path);
+    EXPECT_EQ(manager.checkAndReload(), 3u);
+    for (PluginHandle handle : handles) {
+        ASSERT_TRUE(waitForReload(manager, handle));
+    }
+    for (PluginHandle handle : handles) {
+        EXPECT_EQ(manager.getLibraryInstanceCount(handle), 3u);
+        EXPECT_TRUE(manager.isBatchUpdated(handle));
+    }
+    manager.updateAll(0.016f);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// State Handoff Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, ReloadHandsOverState) {
+    std::string path = copyPlugin(m_statefulV2Path, "manager_state");
+
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    for (int i = 0; i < 5; ++i) {
+        manager.updateAll(0.016f);
+    }
+
+    replacePlugin(m_statefulV2Path, path);
+    ASSERT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(savedUpdateCount(manager.getPlugin(handle)), 5u);
+
+    manager.updateAll(0.016f);
+    EXPECT_EQ(savedUpdateCount(manager.getPlugin(handle)), 6u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, ReloadMigratesOlderStateLayout) {
+    std::string path = copyPlugin(m_statefulV1Path, "manager_migrate");
+
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    for (int i = 0; i < 3; ++i) {
+        manager.updateAll(0.016f);
+    }
+
+    replacePlugin(m_statefulV2Path, path);
+    ASSERT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(manager.getPlugin(handle)->getStateVersion(), 2u);
+    EXPECT_EQ(savedUpdateCount(manager.getPlugin(handle)), 3u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, RejectedStateStartsFresh) {
+    std::string path = copyPlugin(m_statefulV2Path, "manager_reject");
+
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+    manager.updateAll(0.016f);
+
+    // Layout 1 does not know how to read layout 2
+    replacePlugin(m_statefulV1Path, path);
+    ASSERT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(manager.getPlugin(handle)->getStateVersion(), 1u);
+    EXPECT_EQ(savedUpdateCount(manager.getPlugin(handle)), 0u);
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+
+// ============================================================================
+// Update Timing Tests
+// ============================================================================
+
+TEST_F(PluginManagerTest, UpdatesAreUntimedByDefault) {
+    PluginManager manager;
+    PluginHandle handle = manager.loadPlugin(m_testPluginPath);
+    ASSERT_TRUE(handle.isValid());
+    EXPECT_FALSE(manager.isUpdateTimingEnabled());
+
+    manager.updateAll(0.016f);
+    EXPECT_EQ(manager.getUpdateStats(handle).updateCount, 0u);
+    EXPECT_EQ(manager.getUpdateHistogram(handle), nullptr);
+}
+
+TEST_F(PluginManagerTest, TimedUpdatesFillHistogram) {
+    PluginManager manager;
+    manager.enableUpdateTiming();
+    EXPECT_TRUE(manager.isUpdateTimingEnabled());
+    PluginHandle handle = manager.loadPlugin(m_slowPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    for (int i = 0; i < 3; ++i) {
+        manager.updateAll(0.002f);
+    }
+
+    UpdateStats stats = manager.getUpdateStats(handle);
+    EXPECT_EQ(stats.updateCount, 3u);
+    EXPECT_GE(stats.maxDuration, std::chrono::milliseconds(2));
+    const LatencyHistogram* histogram = manager.getUpdateHistogram(handle);
+    ASSERT_NE(histogram, nullptr);
+    EXPECT_EQ(histogram->getCount(), 3u);
+    EXPECT_GE(histogram->getStats().p50, std::chrono::milliseconds(1));
+}
+
+TEST_F(PluginManagerTest, BatchedPluginsAreTimedEach) {
+    BatchCounters counters(m_batchPluginPath);
+    const uint64_t calls = counters.batchCalls();
+    const uint64_t single = counters.singleUpdates();
+
+    PluginManager manager;
+    manager.enableUpdateTiming();
+    PluginHandle first = manager.loadPlugin(m_batchPluginPath);
+    PluginHandle second = manager.loadPlugin(m_batchPluginPath);
+    ASSERT_TRUE(manager.isBatchUpdated(first));
+
+    // Timing keeps the batch together and charges each instance its share
+    manager.updateAll(0.016f);
+    EXPECT_EQ(counters.batchCalls() - calls, 1u);
+    EXPECT_EQ(counters.singleUpdates() - single, 0u);
+    EXPECT_EQ(manager.getUpdateStats(first).updateCount, 1u);
+    EXPECT_EQ(manager.getUpdateStats(second).updateCount, 1u);
+}
+
+TEST_F(PluginManagerTest, PluginDeclaresUpdateBudget) {
+    PluginManager manager;
+    PluginHandle slow = manager.loadPlugin(m_slowPluginPath);
+    PluginHandle plain = manager.loadPlugin(m_testPluginPath);
+    EXPECT_EQ(manager.getUpdateBudget(slow), std::chrono::milliseconds(1));
+    EXPECT_EQ(manager.getUpdateBudget(plain), std::chrono::nanoseconds::zero());
+    EXPECT_EQ(manager.getUpdateBudget(PluginHandle()), std::chrono::nanoseconds::zero());
+}
+
+TEST_F(PluginManagerTest, BudgetOverrunFiresCallback) {
+    PluginManager manager;
+    manager.enableUpdateTiming();
+    std::vector<UpdateOverrun> overruns;
+    std::string name;
+    manager.setBudgetCallback([&](const UpdateOverrun& overrun) {
+        overruns.push_back(overrun);
+        name = overrun.name;
+    });
+    PluginHandle handle = manager.loadPlugin(m_slowPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    manager.updateAll(0.0f);
+    EXPECT_TRUE(overruns.empty());
+
+    manager.updateAll(0.003f);
+    ASSERT_EQ(overruns.size(), 1u);
+    EXPECT_EQ(overruns[0].handle, handle);
+    EXPECT_EQ(name, "SlowPlugin");
+    EXPECT_GE(overruns[0].duration, std::chrono::milliseconds(3));
+    EXPECT_EQ(overruns[0].limit, std::chrono::milliseconds(1));
+    EXPECT_EQ(manager.getUpdateStats(handle).overBudgetCount, 1u);
+}
+
+TEST_F(PluginManagerTest, HostBudgetOverridesDeclaredBudget) {
+    std::string path = copyPlugin(m_slowPluginPath, "manager_budget");
+    PluginManager manager;
+    manager.enableUpdateTiming();
+    int overruns = 0;
+    manager.setBudgetCallback([&](const UpdateOverrun&) { ++overruns; });
+    PluginHandle handle = manager.loadPlugin(path);
+    ASSERT_TRUE(handle.isValid());
+
+    ASSERT_TRUE(manager.setUpdateBudget(handle, std::chrono::seconds(1)));
+    EXPECT_FALSE(manager.setUpdateBudget(PluginHandle(), std::chrono::seconds(1)));
+    manager.updateAll(0.003f);
+    EXPECT_EQ(overruns, 0);
+
+    // The override survives a reload
+    replacePlugin(m_slowPluginPath, path);
+    ASSERT_EQ(manager.checkAndReload(), 1u);
+    ASSERT_TRUE(waitForReload(manager, handle));
+    EXPECT_EQ(manager.getUpdateBudget(handle), std::chrono::seconds(1));
+
+    manager.unloadAll();
+    std::filesystem::remove(path);
+}
+
+TEST_F(PluginManagerTest, WatchdogFlagsStalledUpdate) {
+    PluginManager manager;
+    std::atomic<int> stalls{0};
+    std::string name;
+    ASSERT_TRUE(manager.startWatchdog(std::chrono::milliseconds(20),
+                                      [&](const UpdateOverrun& overrun) {
+                                          name = overrun.name;
+                                          EXPECT_GE(overrun.duration,
+                                                    std::chrono::milliseconds(20));
+                                          stalls.fetch_add(1);
+                                      }));
+    EXPECT_TRUE(manager.isWatchdogRunning());
+    EXPECT_TRUE(manager.isUpdateTimingEnabled());
+    PluginHandle slow = manager.loadPlugin(m_slowPluginPath);
+    ASSERT_TRUE(manager.loadPlugin(m_testPluginPath).isValid());
+
+    manager.updateAll(0.0f);
+    EXPECT_EQ(stalls.load(), 0);
+
+    // Reported while the update is still running
+    manager.updateAll(0.2f);
+    EXPECT_EQ(stalls.load(), 1);
+    EXPECT_EQ(name, "SlowPlugin");
+    EXPECT_EQ(manager.getUpdateStats(slow).updateCount, 2u);
+
+    manager.stopWatchdog();
+    EXPECT_FALSE(manager.isWatchdogRunning());
+    EXPECT_FALSE(manager.startWatchdog(std::chrono::nanoseconds(0)));
+}
+
+TEST_F(PluginManagerTest, WatchdogCoversParallelUpdate) {
+    PluginManager manager;
+    manager.enableParallelUpdate(true, 2);
+    std::atomic<int> stalls{0};
+    ASSERT_TRUE(manager.startWatchdog(std::chrono::milliseconds(20),
+                                      [&](const UpdateOverrun&) { stalls.fetch_add(1); }));
+    PluginHandle handle = manager.loadPlugin(m_slowPluginPath);
+    ASSERT_TRUE(handle.isValid());
+
+    manager.updateAll(0.2f);
+    EXPECT_EQ(stalls.load(), 1);
+    EXPECT_EQ(manager.getUpdateHistogram(handle)->getCount(), 1u);
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,99 @@
+#include "hotplugpp/plugin_metadata.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+namespace hotplugpp {
+namespace tests {
+
+namespace fs = std::filesystem;
+
+class PluginMetadataTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_testPluginPath =
+            std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + "test_plugin" + SHARED_LIB_SUFFIX;
+        m_failingPluginPath = std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX +
+                              "failing_plugin" + SHARED_LIB_SUFFIX;
+        m_dir = fs::temp_directory_path() /
+                ("hotplugpp_metadata_" +
+                 std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::create_directories(m_dir);
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    std::string m_testPluginPath;
+    std::string m_failingPluginPath;
+    fs::path m_dir;
+};
+
+#if defined(__ELF__)
+
+// ============================================================================
+// Reading Tests
+// ============================================================================
+
+TEST_F(PluginMetadataTest, ReadsEmbeddedRecord) {
+    PluginMetadata metadata;
+    ASSERT_TRUE(readPluginMetadata(m_testPluginPath, metadata));
+    EXPECT_EQ(metadata.name, "TestPlugin");
+    EXPECT_EQ(metadata.version, Version(1, 2, 3));
+    EXPECT_EQ(metadata.description, "A test plugin for unit tests");
+
+    EXPECT_TRUE(metadata.version.isCompatible(Version(1, 0, 0)));
+    EXPECT_FALSE(metadata.version.isCompatible(Version(2, 0, 0)));
+}
+
+TEST_F(PluginMetadataTest, ReadingDoesNotLoadLibrary) {
+    // A private copy, so no other test can have loaded it
+    const fs::path copy = m_dir / fs::path(m_testPluginPath).filename();
+    fs::copy_file(m_testPluginPath, copy);
+
+    PluginMetadata metadata;
+    ASSERT_TRUE(readPluginMetadata(copy.string(), metadata));
+    EXPECT_EQ(dlopen(copy.c_str(), RTLD_NOW | RTLD_NOLOAD), nullptr);
+}
+
+#endif
+
+// ============================================================================
+// Rejection Tests
+// ============================================================================
+
+TEST_F(PluginMetadataTest, PluginWithoutRecordFails) {
+    PluginMetadata metadata;
+    EXPECT_FALSE(readPluginMetadata(m_failingPluginPath, metadata));
+}
+
+TEST_F(PluginMetadataTest, MissingFileFails) {
+    PluginMetadata metadata;
+    EXPECT_FALSE(readPluginMetadata((m_dir / "missing.so").string(), metadata));
+}
+
+TEST_F(PluginMetadataTest, NonLibraryFileFails) {
+    const fs::path text = m_dir / "plugin.so";
+    std::ofstream(text) << "not a shared library";
+
+    PluginMetadata metadata;
+    EXPECT_FALSE(readPluginMetadata(text.string(), metadata));
+}
+
+TEST_F(PluginMetadataTest, TruncatedLibraryFails) {
+    // Section headers live at the end of the file, so half a library has none
+    const fs::path truncated = m_dir / "truncated.so";
+    fs::copy_file(m_testPluginPath, truncated);
+    fs::resize_file(truncated, fs::file_size(truncated) / 2);
+
+    PluginMetadata metadata;
+    EXPECT_FALSE(readPluginMetadata(truncated.string(), metadata));
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,136 @@
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/remote_plugin.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace hotplugpp {
+namespace tests {
+
+#if defined(__linux__)
+
+class RemotePluginTest : public ::testing::Test {
+  protected:
+    static std::string pluginPath(const std::string& name) {
+        return std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + name + SHARED_LIB_SUFFIX;
+    }
+};
+
+// ============================================================================
+// Lifecycle Tests
+// ============================================================================
+
+TEST_F(RemotePluginTest, StartReportsPluginInfo) {
+    RemotePlugin remote;
+    ASSERT_TRUE(remote.start(pluginPath("test_plugin")));
+
+    EXPECT_TRUE(remote.isRunning());
+    EXPECT_NE(remote.getProcessId(), 0);
+    EXPECT_NE(remote.getProcessId(), getpid());
+    EXPECT_EQ(remote.getName(), "TestPlugin");
+    EXPECT_EQ(remote.getVersion(), Version(1, 2, 3));
+    EXPECT_EQ(remote.getDescription(), "A test plugin for unit tests");
+
+    remote.stop();
+    EXPECT_FALSE(remote.isRunning());
+    EXPECT_EQ(remote.getProcessId(), 0);
+    EXPECT_FALSE(remote.update(0.016f));
+}
+
+TEST_F(RemotePluginTest, FailingPluginDoesNotStart) {
+    RemotePlugin remote;
+    EXPECT_FALSE(remote.start(pluginPath("failing_plugin")));
+    EXPECT_FALSE(remote.isRunning());
+}
+
+TEST_F(RemotePluginTest, MissingHostExecutableFails) {
+    RemotePluginOptions options;
+    options.hostExecutable = "/nonexistent/hotplugpp_plugin_host";
+
+    RemotePlugin remote;
+    EXPECT_FALSE(remote.start(pluginPath("test_plugin"), options));
+    EXPECT_FALSE(remote.isRunning());
+}
+
+TEST_F(RemotePluginTest, DestructorEndsProcess) {
+    int pid = 0;
+    {
+        RemotePlugin remote;
+        ASSERT_TRUE(remote.start(pluginPath("test_plugin")));
+        pid = remote.getProcessId();
+    }
+    // Reaped, so the process ID no longer exists
+    EXPECT_EQ(kill(pid, 0), -1);
+    EXPECT_EQ(errno, ESRCH);
+}
+
+TEST_F(RemotePluginTest, OutlivesThreadThatStartedIt) {
+    RemotePlugin remote;
+    bool started = false;
+    std::thread starter([&]() { started = remote.start(pluginPath("test_plugin")); });
+    starter.join();
+    ASSERT_TRUE(started);
+
+    // Give a process tied to the starting thread time to go away
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_TRUE(remote.update(0.016f));
+    EXPECT_TRUE(remote.isRunning());
+}
+
+// ============================================================================
+// Call Tests
+// ============================================================================
+
+TEST_F(RemotePluginTest, UpdatesRunInPluginProcess) {
+    RemotePlugin remote;
+    ASSERT_TRUE(remote.start(pluginPath("table_plugin")));
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(remote.update(0.016f));
+    }
+
+    int updateCount = 0;
+    EXPECT_EQ(remote.query(fnv1a64("updateCount"), &updateCount, sizeof(updateCount)),
+              sizeof(updateCount));
+    EXPECT_EQ(updateCount, 3);
+    EXPECT_EQ(remote.query(fnv1a64("unknown"), &updateCount, sizeof(updateCount)), 0u);
+}
+
+TEST_F(RemotePluginTest, QueryWithoutFunctionTableFails) {
+    RemotePlugin remote;
+    ASSERT_TRUE(remote.start(pluginPath("test_plugin")));
+
+    int updateCount = 0;
+    EXPECT_EQ(remote.query(fnv1a64("updateCount"), &updateCount, sizeof(updateCount)), 0u);
+    EXPECT_TRUE(remote.isRunning());
+}
+
+// ============================================================================
+// Isolation Tests
+// ============================================================================
+
+TEST_F(RemotePluginTest, CrashingPluginLeavesHostRunning) {
+    RemotePlugin remote;
+    ASSERT_TRUE(remote.start(pluginPath("crashing_plugin")));
+
+    EXPECT_FALSE(remote.update(0.016f));
+    EXPECT_FALSE(remote.isRunning());
+    EXPECT_FALSE(remote.update(0.016f));
+
+    // The same object can host a new process afterwards
+    ASSERT_TRUE(remote.start(pluginPath("test_plugin")));
+    EXPECT_TRUE(remote.update(0.016f));
+}
+
+#endif
+
+} // namespace tests
+} // namespace hotplugpp
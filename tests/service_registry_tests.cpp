@@ -0,0 +1,224 @@
+#include "hotplugpp/plugin_loader.hpp"
+#include "hotplugpp/plugin_manager.hpp"
+#include "hotplugpp/service_registry.hpp"
+#include "test_plugin/counter_service.hpp"
+#include "test_plugin/plugin_files.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace {
+
+class IGreeter {
+  public:
+    HOTPLUGPP_SERVICE("IGreeter", 2, 1)
+
+    virtual ~IGreeter() = default;
+    virtual int greet() = 0;
+};
+
+class Greeter : public IGreeter {
+  public:
+    explicit Greeter(int value) : m_value(value) {}
+    int greet() override { return m_value; }
+
+  private:
+    int m_value;
+};
+
+// Owners are only compared, never called
+const IPlugin* const OWNER_A = reinterpret_cast<const IPlugin*>(0x1000);
+const IPlugin* const OWNER_B = reinterpret_cast<const IPlugin*>(0x2000);
+
+} // namespace
+
+// ============================================================================
+// Service ID Tests
+// ============================================================================
+
+TEST(ServiceIdTest, ComputedAtCompileTime) {
+    static_assert(IGreeter::SERVICE_ID == serviceId("IGreeter", Version(2, 1, 0)),
+                  "IDs are constant expressions");
+    static_assert(serviceId("IGreeter", Version(2, 0, 0)) ==
+                      serviceId("IGreeter", Version(2, 7, 3)),
+                  "Minor and patch versions stay compatible");
+    static_assert(serviceId("IGreeter", Version(1, 0, 0)) !=
+                      serviceId("IGreeter", Version(2, 0, 0)),
+                  "Major versions are incompatible");
+    static_assert(serviceId("IGreeter", Version(2, 0, 0)) != serviceId("IOther", Version(2, 0, 0)),
+                  "Names are distinct");
+    EXPECT_EQ(IGreeter::SERVICE_VERSION, Version(2, 1, 0));
+}
+
+// ============================================================================
+// Registry Tests
+// ============================================================================
+
+TEST(ServiceRegistryTest, FindBeforeProvide) {
+    ServiceRegistry registry;
+    ServiceRef<IGreeter> greeter = registry.find<IGreeter>();
+    EXPECT_FALSE(greeter);
+    EXPECT_EQ(greeter.get(), nullptr);
+
+    Greeter implementation(7);
+    EXPECT_TRUE(registry.provide<IGreeter>(OWNER_A, &implementation));
+    ASSERT_TRUE(greeter);
+    EXPECT_EQ(greeter->greet(), 7);
+    EXPECT_EQ(registry.getServiceCount(), 1u);
+}
+
+TEST(ServiceRegistryTest, ProvideNullFails) {
+    ServiceRegistry registry;
+    EXPECT_FALSE(registry.provide<IGreeter>(OWNER_A, static_cast<IGreeter*>(nullptr)));
+    EXPECT_EQ(registry.getServiceCount(), 0u);
+}
+
+TEST(ServiceRegistryTest, DefaultRefIsEmpty) {
+    ServiceRef<IGreeter> greeter;
+    EXPECT_EQ(greeter.get(), nullptr);
+    EXPECT_EQ(greeter.getGeneration(), 0u);
+}
+
+TEST(ServiceRegistryTest, RevokeClearsOnlyOwnServices) {
+    ServiceRegistry registry;
+    Greeter implementation(1);
+    registry.provide<IGreeter>(OWNER_A, &implementation);
+    ServiceRef<IGreeter> greeter = registry.find<IGreeter>();
+
+    EXPECT_EQ(registry.revoke(OWNER_B), 0u);
+    EXPECT_TRUE(greeter);
+
+    const uint32_t generation = greeter.getGeneration();
+    EXPECT_EQ(registry.revoke(OWNER_A), 1u);
+    EXPECT_FALSE(greeter);
+    EXPECT_NE(greeter.getGeneration(), generation);
+    EXPECT_EQ(registry.getServiceCount(), 0u);
+}
+
+TEST(ServiceRegistryTest, ReplacementRebindsRefs) {
+    ServiceRegistry registry;
+    Greeter first(1);
+    Greeter second(2);
+    ServiceRef<IGreeter> greeter = registry.find<IGreeter>();
+
+    registry.provide<IGreeter>(OWNER_A, &first);
+    const uint32_t generation = greeter.getGeneration();
+    registry.provide<IGreeter>(OWNER_B, &second);
+    EXPECT_EQ(greeter->greet(), 2);
+    EXPECT_NE(greeter.getGeneration(), generation);
+
+    // The replaced owner going away leaves its successor alone
+    EXPECT_EQ(registry.revoke(OWNER_A), 0u);
+    EXPECT_EQ(greeter->greet(), 2);
+}
+
+TEST(ServiceRegistryTest, RevokingReplacementRestoresPrevious) {
+    ServiceRegistry registry;
+    Greeter first(1);
+    Greeter second(2);
+    ServiceRef<IGreeter> greeter = registry.find<IGreeter>();
+
+    registry.provide<IGreeter>(OWNER_A, &first);
+    registry.provide<IGreeter>(OWNER_B, &second);
+    EXPECT_EQ(registry.revoke(OWNER_B), 1u);
+    ASSERT_TRUE(greeter);
+    EXPECT_EQ(greeter->greet(), 1);
+}
+
+// ============================================================================
+// Plugin Tests
+// ============================================================================
+
+class ServicePluginTest : public ::testing::Test {
+  protected:
+    static std::string pluginPath(const std::string& name) {
+        return std::string(TEST_PLUGIN_DIR) + "/" + SHARED_LIB_PREFIX + name + SHARED_LIB_SUFFIX;
+    }
+};
+
+TEST_F(ServicePluginTest, PluginProvidesService) {
+    ServiceRegistry registry;
+    ServiceRef<ICounterService> counter = registry.find<ICounterService>();
+
+    PluginLoader loader;
+    loader.setServiceRegistry(&registry);
+    EXPECT_EQ(loader.getServiceRegistry(), &registry);
+    ASSERT_TRUE(loader.loadPlugin(pluginPath("service_plugin")));
+    ASSERT_TRUE(counter);
+    EXPECT_EQ(counter->next(), 1u);
+    EXPECT_EQ(counter->next(), 2u);
+
+    loader.unloadPlugin();
+    EXPECT_FALSE(counter);
+}
+
+TEST_F(ServicePluginTest, PluginWithoutRegistryLoads) {
+    PluginLoader loader;
+    EXPECT_TRUE(loader.loadPlugin(pluginPath("service_plugin")));
+}
+
+TEST_F(ServicePluginTest, ReloadRebindsService) {
+    std::string path = copyPlugin(pluginPath("service_plugin"), "service_reload");
+    ServiceRegistry registry;
+    ServiceRef<ICounterService> counter = registry.find<ICounterService>();
+
+    PluginLoader loader;
+    loader.setServiceRegistry(&registry);
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+    ICounterService* before = counter.get();
+    ASSERT_NE(before, nullptr);
+    EXPECT_EQ(counter->next(), 1u);
+
+    replacePlugin(pluginPath("service_plugin"), path);
+    ASSERT_TRUE(loader.checkAndReload());
+    ASSERT_TRUE(counter);
+    EXPECT_NE(counter.get(), before);
+    EXPECT_EQ(counter->next(), 1u);
+
+    loader.unloadPlugin();
+    EXPECT_FALSE(counter);
+    std::filesystem::remove(path);
+}
+
+TEST_F(ServicePluginTest, FailedReloadKeepsPreviousService) {
+    std::string path = copyPlugin(pluginPath("service_plugin"), "service_rollback");
+    ServiceRegistry registry;
+    ServiceRef<ICounterService> counter = registry.find<ICounterService>();
+
+    PluginLoader loader;
+    loader.setServiceRegistry(&registry);
+    loader.setReloadMode(ReloadMode::Blocking);
+    ASSERT_TRUE(loader.loadPlugin(path));
+    ICounterService* before = counter.get();
+    EXPECT_EQ(counter->next(), 1u);
+
+    replacePlugin(pluginPath("failing_service_plugin"), path);
+    EXPECT_FALSE(loader.checkAndReload());
+    EXPECT_EQ(counter.get(), before);
+    EXPECT_EQ(counter->next(), 2u);
+
+    loader.unloadPlugin();
+    std::filesystem::remove(path);
+}
+
+TEST_F(ServicePluginTest, ManagerRevokesOnUnload) {
+    ServiceRegistry registry;
+    ServiceRef<ICounterService> counter = registry.find<ICounterService>();
+
+    PluginManager manager;
+    manager.setServiceRegistry(&registry);
+    PluginHandle handle = manager.loadPlugin(pluginPath("service_plugin"));
+    ASSERT_TRUE(handle.isValid());
+    EXPECT_TRUE(counter);
+
+    manager.unloadPlugin(handle);
+    EXPECT_FALSE(counter);
+}
+
+} // namespace tests
+} // namespace hotplugpp
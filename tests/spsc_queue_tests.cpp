@@ -0,0 +1,79 @@
+#include "hotplugpp/spsc_queue.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace hotplugpp {
+namespace tests {
+
+TEST(SpscQueueTest, InitiallyEmpty) {
+    SpscQueue<int, 8> queue;
+    int value = 0;
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(SpscQueueTest, FifoOrder) {
+    SpscQueue<int, 8> queue;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        int value = -1;
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFull) {
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+TEST(SpscQueueTest, WrapsAround) {
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.tryPush(i));
+        int value = -1;
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(SpscQueueTest, ConcurrentProducerConsumer) {
+    SpscQueue<int, 64> queue;
+    const int count = 20000;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < count) {
+        int value;
+        if (queue.tryPop(value)) {
+            ASSERT_EQ(value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,46 @@
+#include "hotplugpp/plugin_allocator.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A test plugin that allocates through the host-provided allocator
+ *
+ * Every update appends to a vector backed by the allocator, and every update
+ * also leaks a small block on purpose; both are reclaimed with the arena.
+ */
+class ArenaPlugin : public hotplugpp::IPlugin {
+  public:
+    explicit ArenaPlugin(const HotPlugPPAllocator* allocator = nullptr)
+        : m_allocator(allocator), m_samples(hotplugpp::PluginAllocator<uint64_t>(allocator)) {}
+
+    ~ArenaPlugin() override = default;
+
+    bool onLoad() override {
+        m_samples.reserve(64);
+        return true;
+    }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        m_samples.push_back(static_cast<uint64_t>(deltaTime * 1000000.0f));
+        if (m_allocator) {
+            m_allocator->allocate(m_allocator->context, 128, alignof(std::max_align_t));
+        }
+    }
+
+    const char* getName() const override { return "ArenaPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin that allocates from a host arena";
+    }
+
+  private:
+    const HotPlugPPAllocator* m_allocator;
+    std::vector<uint64_t, hotplugpp::PluginAllocator<uint64_t>> m_samples;
+};
+
+HOTPLUGPP_CREATE_PLUGIN_WITH_ALLOCATOR(ArenaPlugin)
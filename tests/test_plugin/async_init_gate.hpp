@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#include <process.h>
+#define ASYNC_INIT_GETPID _getpid
+#else
+#include <unistd.h>
+#define ASYNC_INIT_GETPID getpid
+#endif
+
+/**
+ * @brief Gate file that releases the background setup of async_init_plugin
+ *
+ * A file rather than a variable, so that it also releases the private copies
+ * of the library a reload loads. Named after the process, so concurrent test
+ * processes do not release each other.
+ *
+ * @return Path of the gate file of this process
+ */
+inline std::string asyncInitGatePath() {
+    const std::string name = "hotplugpp_init_gate_" + std::to_string(ASYNC_INIT_GETPID());
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/**
+ * @brief Closes the gate on construction and destruction; open() lets setups finish
+ */
+class AsyncInitGate {
+  public:
+    AsyncInitGate() { close(); }
+    ~AsyncInitGate() { close(); }
+
+    // Disable copy
+    AsyncInitGate(const AsyncInitGate&) = delete;
+    AsyncInitGate& operator=(const AsyncInitGate&) = delete;
+
+    void open() { std::ofstream(asyncInitGatePath()).put('\n'); }
+
+    void close() {
+        std::error_code ec;
+        std::filesystem::remove(asyncInitGatePath(), ec);
+    }
+};
@@ -0,0 +1,107 @@
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/i_plugin.hpp"
+
+#include "async_init_gate.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <thread>
+
+// Both builds are loaded into one process; distinct class names keep their
+// vague-linkage symbols (vtables, inline members) from interposing each other
+#if defined(ASYNC_INIT_PLUGIN_FAIL)
+#define AsyncInitPlugin FailingAsyncInitPlugin
+#elif defined(ASYNC_INIT_PLUGIN_BLOCKING)
+#define AsyncInitPlugin BlockingInitPlugin
+#endif
+
+/**
+ * @brief A test plugin that finishes its setup on a background thread
+ *
+ * onLoad() starts a thread that waits until the test opens the
+ * AsyncInitGate and then reports InitStatus::Ready, or with
+ * ASYNC_INIT_PLUGIN_FAIL InitStatus::Failed. With ASYNC_INIT_PLUGIN_BLOCKING
+ * onLoad() waits for the gate itself, for at most ten seconds, and the plugin
+ * is ready once it returns. onUpdate() calls are counted under "updateCount"
+ * in the function table.
+ */
+class AsyncInitPlugin : public hotplugpp::IPlugin {
+  public:
+    AsyncInitPlugin() = default;
+    ~AsyncInitPlugin() override = default;
+
+    bool onLoad() override {
+#ifdef ASYNC_INIT_PLUGIN_BLOCKING
+        const std::string gate = asyncInitGatePath();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        std::error_code ec;
+        while (!std::filesystem::exists(gate, ec) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        m_status.store(hotplugpp::InitStatus::Ready, std::memory_order_release);
+#else
+        m_status.store(hotplugpp::InitStatus::Initializing, std::memory_order_release);
+        m_worker = std::thread([this]() {
+            const std::string gate = asyncInitGatePath();
+            std::error_code ec;
+            while (!m_stop.load(std::memory_order_acquire) &&
+                   !std::filesystem::exists(gate, ec)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+#ifdef ASYNC_INIT_PLUGIN_FAIL
+            m_status.store(hotplugpp::InitStatus::Failed, std::memory_order_release);
+#else
+            m_status.store(hotplugpp::InitStatus::Ready, std::memory_order_release);
+#endif
+        });
+#endif
+        return true;
+    }
+
+    void onUnload() override {
+        // Unloading may interrupt the setup
+        m_stop.store(true, std::memory_order_release);
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+    }
+
+    void onUpdate(float deltaTime) override {
+        (void)deltaTime;
+        ++m_updateCount;
+    }
+
+    hotplugpp::InitStatus getInitStatus() override {
+        return m_status.load(std::memory_order_acquire);
+    }
+
+    const char* getName() const override { return "AsyncInitPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin that initializes in the background";
+    }
+
+    size_t onQuery(uint64_t key, void* buffer, size_t size) {
+        if (key != hotplugpp::fnv1a64("updateCount") || size < sizeof(m_updateCount)) {
+            return 0;
+        }
+        std::memcpy(buffer, &m_updateCount, sizeof(m_updateCount));
+        return sizeof(m_updateCount);
+    }
+
+  private:
+    std::thread m_worker;
+    std::atomic<bool> m_stop{false};
+    std::atomic<hotplugpp::InitStatus> m_status{hotplugpp::InitStatus::Initializing};
+    uint64_t m_updateCount = 0;
+};
+
+HOTPLUGPP_CREATE_PLUGIN(AsyncInitPlugin)
+HOTPLUGPP_FUNCTION_TABLE(AsyncInitPlugin)
@@ -0,0 +1,70 @@
+#include "hotplugpp/i_plugin.hpp"
+
+#include <cstdint>
+
+namespace {
+
+// Shared by every instance of the library; read by the tests through the exports below
+uint64_t s_batchCalls = 0;
+uint64_t s_batchedUpdates = 0;
+uint64_t s_singleUpdates = 0;
+
+} // namespace
+
+/**
+ * @brief A test plugin that exports a batch update entry point
+ *
+ * Each instance integrates a position; onUpdateBatch() does the same for all
+ * instances of the library in one loop.
+ */
+class BatchPlugin : public hotplugpp::IPlugin {
+  public:
+    BatchPlugin() = default;
+    ~BatchPlugin() override = default;
+
+    bool onLoad() override { return true; }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        s_singleUpdates++;
+        m_position += m_velocity * deltaTime;
+    }
+
+    static void onUpdateBatch(hotplugpp::IPlugin* const* instances, size_t count,
+                              float deltaTime) {
+        s_batchCalls++;
+        s_batchedUpdates += count;
+        for (size_t i = 0; i < count; ++i) {
+            BatchPlugin* plugin = static_cast<BatchPlugin*>(instances[i]);
+            plugin->m_position += plugin->m_velocity * deltaTime;
+        }
+    }
+
+    const char* getName() const override { return "BatchPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin that updates all of its instances in one call";
+    }
+
+  private:
+    float m_position = 0.0f;
+    float m_velocity = 1.0f;
+};
+
+HOTPLUGPP_CREATE_PLUGIN(BatchPlugin)
+HOTPLUGPP_UPDATE_BATCH(BatchPlugin)
+
+HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API uint64_t getBatchCallCount() {
+    return s_batchCalls;
+}
+
+HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API uint64_t getBatchedUpdateCount() {
+    return s_batchedUpdates;
+}
+
+HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API uint64_t getSingleUpdateCount() {
+    return s_singleUpdates;
+}
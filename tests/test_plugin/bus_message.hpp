@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/// Channel the bus test plugins talk through
+#define BUS_CHANNEL_NAME "test.bus"
+/// Message slots of BUS_CHANNEL_NAME
+#define BUS_CHANNEL_CAPACITY 1024
+
+/**
+ * @brief Message published by bus_producer_plugin and received by bus_consumer_plugin
+ */
+struct BusMessage {
+    uint32_t producer;
+    uint32_t reserved;
+    uint64_t sequence;
+};
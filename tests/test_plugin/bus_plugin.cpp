@@ -0,0 +1,120 @@
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/message_bus.hpp"
+
+#include "bus_message.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#ifndef BUS_PLUGIN_BATCH
+#define BUS_PLUGIN_BATCH 64
+#endif
+
+// Both builds are loaded into one process; distinct class names keep their
+// vague-linkage symbols (vtables, inline members) from interposing each other
+#ifdef BUS_PLUGIN_PRODUCER
+#define BusPlugin BusProducerPlugin
+#else
+#define BusPlugin BusConsumerPlugin
+#endif
+
+HOTPLUGPP_USE_MESSAGE_BUS()
+
+namespace {
+/// Numbers the instances of this build; a reloaded build counts from 0 again
+std::atomic<uint32_t> s_instanceCount{0};
+} // namespace
+
+/**
+ * @brief A test plugin that talks through the host's message bus
+ *
+ * Built twice: with BUS_PLUGIN_PRODUCER it publishes BUS_PLUGIN_BATCH
+ * messages per update, otherwise it subscribes as "consumer-<n>" and
+ * drains its subscription on every update. Counters are exposed through the
+ * function table under "sent" and "received".
+ */
+class BusPlugin : public hotplugpp::IPlugin {
+  public:
+    using Channel = hotplugpp::MessageChannel<BusMessage, BUS_CHANNEL_CAPACITY>;
+
+    BusPlugin() = default;
+    ~BusPlugin() override = default;
+
+    bool onLoad() override {
+        if (!hotplugppMessageBus) {
+            return false;
+        }
+        m_channel =
+            hotplugppMessageBus->getChannel<BusMessage, BUS_CHANNEL_CAPACITY>(BUS_CHANNEL_NAME);
+        if (!m_channel) {
+            return false;
+        }
+        m_instance = s_instanceCount++;
+#ifndef BUS_PLUGIN_PRODUCER
+        // The same name re-binds a reloaded build to the messages published meanwhile
+        m_subscriber = m_channel->subscribe("consumer-" + std::to_string(m_instance));
+        return m_subscriber != Channel::INVALID_SUBSCRIBER;
+#else
+        return true;
+#endif
+    }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        (void)deltaTime;
+#ifdef BUS_PLUGIN_PRODUCER
+        for (int i = 0; i < BUS_PLUGIN_BATCH; ++i) {
+            BusMessage* message = m_channel->acquire();
+            if (!message) {
+                break;
+            }
+            message->producer = m_instance;
+            message->sequence = m_sent++;
+            m_channel->publish(message);
+        }
+#else
+        m_received += m_channel->drain(m_subscriber, [](const BusMessage&) {});
+#endif
+    }
+
+    const char* getName() const override {
+#ifdef BUS_PLUGIN_PRODUCER
+        return "BusProducer";
+#else
+        return "BusConsumer";
+#endif
+    }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin that talks through the message bus";
+    }
+
+    size_t onQuery(uint64_t key, void* buffer, size_t size) {
+        const uint64_t* value = nullptr;
+        if (key == hotplugpp::fnv1a64("sent")) {
+            value = &m_sent;
+        } else if (key == hotplugpp::fnv1a64("received")) {
+            value = &m_received;
+        }
+        if (!value || size < sizeof(*value)) {
+            return 0;
+        }
+        std::memcpy(buffer, value, sizeof(*value));
+        return sizeof(*value);
+    }
+
+  private:
+    Channel* m_channel = nullptr;
+    uint32_t m_subscriber = Channel::INVALID_SUBSCRIBER;
+    uint32_t m_instance = 0;
+    uint64_t m_sent = 0;
+    uint64_t m_received = 0;
+};
+
+HOTPLUGPP_CREATE_PLUGIN(BusPlugin)
+HOTPLUGPP_FUNCTION_TABLE(BusPlugin)
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "hotplugpp/service_registry.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Service provided by service_plugin
+ */
+class ICounterService {
+  public:
+    HOTPLUGPP_SERVICE("ICounterService", 1, 0)
+
+    virtual ~ICounterService() = default;
+
+    /**
+     * @brief Count up
+     * @return Number of calls on this instance so far, including this one
+     */
+    virtual uint32_t next() = 0;
+};
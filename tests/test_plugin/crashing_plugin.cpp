@@ -0,0 +1,33 @@
+#include "hotplugpp/i_plugin.hpp"
+
+#include <cstdlib>
+
+/**
+ * @brief A test plugin that aborts its process on the first update
+ *
+ * Only ever run out of process, to check that the host survives it.
+ */
+class CrashingPlugin : public hotplugpp::IPlugin {
+  public:
+    CrashingPlugin() = default;
+    ~CrashingPlugin() override = default;
+
+    bool onLoad() override { return true; }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        (void)deltaTime;
+        std::abort();
+    }
+
+    const char* getName() const override { return "CrashingPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A plugin that crashes on its first update";
+    }
+};
+
+HOTPLUGPP_CREATE_PLUGIN(CrashingPlugin)
@@ -0,0 +1,46 @@
+#include "hotplugpp/i_plugin.hpp"
+
+#include <chrono>
+
+/**
+ * @brief A test plugin that looks like it was built before the interface version export
+ *
+ * Exports only the factory functions, so the host must treat it as interface
+ * version 1 and leave every optional hook alone. The hooks it does override
+ * would make the host unload it, or report an update budget, if they were
+ * called.
+ */
+class LegacyPlugin : public hotplugpp::IPlugin {
+  public:
+    LegacyPlugin() = default;
+    ~LegacyPlugin() override = default;
+
+    bool onLoad() override { return true; }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override { (void)deltaTime; }
+
+    hotplugpp::InitStatus getInitStatus() override { return hotplugpp::InitStatus::Failed; }
+
+    std::chrono::microseconds getUpdateBudget() const override {
+        return std::chrono::milliseconds(1);
+    }
+
+    const char* getName() const override { return "LegacyPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin without an interface version";
+    }
+};
+
+// No HOTPLUGPP_CREATE_PLUGIN: that would export hotplugppInterfaceVersion
+HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API hotplugpp::IPlugin* createPlugin() {
+    return new LegacyPlugin();
+}
+
+HOTPLUGPP_PLUGIN_EXPORT HOTPLUGPP_API void destroyPlugin(hotplugpp::IPlugin* plugin) {
+    delete plugin;
+}
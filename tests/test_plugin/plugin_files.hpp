@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Copy a plugin to a uniquely named file in the temp directory
+ * @param source Plugin library to copy
+ * @param name Unique part of the file name
+ * @return Path of the copy, with the platform's library suffix
+ */
+inline std::string copyPlugin(const std::string& source, const std::string& name) {
+    namespace fs = std::filesystem;
+    std::string path =
+        (fs::temp_directory_path() / ("hotplugpp_" + name + SHARED_LIB_SUFFIX)).string();
+    fs::copy_file(source, path, fs::copy_options::overwrite_existing);
+    return path;
+}
+
+/**
+ * @brief Atomically replace a plugin with a newer build of another one
+ *
+ * The copy is renamed over @p dest with its modification time pushed
+ * forward, so it counts as changed even within the file system's timestamp
+ * resolution.
+ *
+ * @param source Plugin library to copy
+ * @param dest Plugin file to replace
+ */
+inline void replacePlugin(const std::string& source, const std::string& dest) {
+    namespace fs = std::filesystem;
+    std::string tmp = dest + ".tmp";
+    fs::copy_file(source, tmp, fs::copy_options::overwrite_existing);
+    fs::last_write_time(tmp, fs::file_time_type::clock::now() + std::chrono::seconds(10));
+    fs::rename(tmp, dest);
+}
@@ -0,0 +1,52 @@
+#include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/service_registry.hpp"
+
+#include "counter_service.hpp"
+
+HOTPLUGPP_USE_SERVICE_REGISTRY()
+
+// Both builds are loaded into one process; distinct class names keep their
+// vague-linkage symbols (vtables, inline members) from interposing each other
+#ifdef SERVICE_PLUGIN_FAIL
+#define ServicePlugin FailingServicePlugin
+#endif
+
+/**
+ * @brief A test plugin that provides ICounterService
+ *
+ * With SERVICE_PLUGIN_FAIL, onLoad() fails after providing the service, like
+ * a broken build that gets part of the way through initialization.
+ */
+class ServicePlugin : public hotplugpp::IPlugin, public ICounterService {
+  public:
+    ServicePlugin() = default;
+    ~ServicePlugin() override = default;
+
+    bool onLoad() override {
+        if (hotplugppServiceRegistry) {
+            hotplugppServiceRegistry->provide<ICounterService>(this, this);
+        }
+#ifdef SERVICE_PLUGIN_FAIL
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override { (void)deltaTime; }
+
+    const char* getName() const override { return "ServicePlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override { return "A test plugin that provides a service"; }
+
+    uint32_t next() override { return ++m_count; }
+
+  private:
+    uint32_t m_count = 0;
+};
+
+HOTPLUGPP_CREATE_PLUGIN(ServicePlugin)
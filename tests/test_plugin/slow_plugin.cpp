@@ -0,0 +1,40 @@
+#include "hotplugpp/i_plugin.hpp"
+
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief A test plugin whose updates take as long as the test asks for
+ *
+ * onUpdate() sleeps for deltaTime seconds, so a test controls how long each
+ * update runs, up to one that looks stuck. Declares an update budget of 1 ms.
+ */
+class SlowPlugin : public hotplugpp::IPlugin {
+  public:
+    SlowPlugin() = default;
+    ~SlowPlugin() override = default;
+
+    bool onLoad() override { return true; }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        if (deltaTime > 0.0f) {
+            std::this_thread::sleep_for(std::chrono::duration<float>(deltaTime));
+        }
+    }
+
+    std::chrono::microseconds getUpdateBudget() const override {
+        return std::chrono::milliseconds(1);
+    }
+
+    const char* getName() const override { return "SlowPlugin"; }
+
+    hotplugpp::Version getVersion() const override { return hotplugpp::Version(1, 0, 0); }
+
+    const char* getDescription() const override {
+        return "A test plugin that sleeps through its updates";
+    }
+};
+
+HOTPLUGPP_CREATE_PLUGIN(SlowPlugin)
@@ -0,0 +1,109 @@
+#include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/plugin_metadata.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#ifndef STATEFUL_PLUGIN_STATE_VERSION
+#define STATEFUL_PLUGIN_STATE_VERSION 2
+#endif
+
+/**
+ * @brief A test plugin that hands its state over across reloads
+ *
+ * Built once per state layout to exercise migration: layout 1 stores the
+ * update count as a 32-bit integer, layout 2 stores a 64-bit count followed
+ * by the accumulated time and migrates from layout 1.
+ */
+class StatefulPlugin : public hotplugpp::IPlugin {
+  public:
+    StatefulPlugin() = default;
+    ~StatefulPlugin() override = default;
+
+    bool onLoad() override { return true; }
+
+    void onUnload() override {}
+
+    void onUpdate(float deltaTime) override {
+        m_updateCount++;
+        m_totalTime += deltaTime;
+    }
+
+    const char* getName() const override { return "StatefulPlugin"; }
+
+    hotplugpp::Version getVersion() const override {
+        return hotplugpp::Version(1, STATEFUL_PLUGIN_STATE_VERSION, 0);
+    }
+
+    const char* getDescription() const override {
+        return "A test plugin that keeps its state across reloads";
+    }
+
+    uint32_t getStateVersion() const override { return STATEFUL_PLUGIN_STATE_VERSION; }
+
+#if STATEFUL_PLUGIN_STATE_VERSION == 1
+    size_t getStateSize() const override { return sizeof(uint32_t); }
+
+    bool saveState(void* buffer, size_t size) override {
+        if (size < sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t count = static_cast<uint32_t>(m_updateCount);
+        std::memcpy(buffer, &count, sizeof(count));
+        return true;
+    }
+
+    bool loadState(const void* data, size_t size, uint32_t version) override {
+        if (version != 1 || size < sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t count = 0;
+        std::memcpy(&count, data, sizeof(count));
+        m_updateCount = count;
+        return true;
+    }
+#else
+    size_t getStateSize() const override { return sizeof(State); }
+
+    bool saveState(void* buffer, size_t size) override {
+        if (size < sizeof(State)) {
+            return false;
+        }
+        State* state = static_cast<State*>(buffer);
+        state->updateCount = m_updateCount;
+        state->totalTime = m_totalTime;
+        return true;
+    }
+
+    bool loadState(const void* data, size_t size, uint32_t version) override {
+        if (version == 1 && size >= sizeof(uint32_t)) {
+            // Migrate from layout 1, which did not track time
+            uint32_t count = 0;
+            std::memcpy(&count, data, sizeof(count));
+            m_updateCount = count;
+            m_totalTime = 0.0;
+            return true;
+        }
+        if (version != 2 || size < sizeof(State)) {
+            return false;
+        }
+        const State* state = static_cast<const State*>(data);
+        m_updateCount = state->updateCount;
+        m_totalTime = state->totalTime;
+        return true;
+    }
+#endif
+
+  private:
+    struct State {
+        uint64_t updateCount;
+        double totalTime;
+    };
+
+    uint64_t m_updateCount = 0;
+    double m_totalTime = 0.0;
+};
+
+HOTPLUGPP_CREATE_PLUGIN(StatefulPlugin)
+HOTPLUGPP_PLUGIN_METADATA("StatefulPlugin", 1, STATEFUL_PLUGIN_STATE_VERSION, 0,
+                          "A test plugin that keeps its state across reloads")
@@ -1,4 +1,12 @@
 #include "hotplugpp/i_plugin.hpp"
+#include "hotplugpp/plugin_metadata.hpp"
+
+#ifdef TEST_PLUGIN_FUNCTION_TABLE
+#include "hotplugpp/function_table.hpp"
+#include "hotplugpp/hash.hpp"
+
+#include <cstring>
+#endif
 
 #include <iostream>
 
@@ -33,6 +41,16 @@ class TestPlugin : public hotplugpp::IPlugin {
         return "A test plugin for unit tests";
     }
 
+#ifdef TEST_PLUGIN_FUNCTION_TABLE
+    size_t onQuery(uint64_t key, void* buffer, size_t size) {
+        if (key != hotplugpp::fnv1a64("updateCount") || size < sizeof(m_updateCount)) {
+            return 0;
+        }
+        std::memcpy(buffer, &m_updateCount, sizeof(m_updateCount));
+        return sizeof(m_updateCount);
+    }
+#endif
+
   private:
     bool m_loadCalled;
     bool m_unloadCalled;
@@ -41,3 +59,8 @@ class TestPlugin : public hotplugpp::IPlugin {
 };
 
 HOTPLUGPP_CREATE_PLUGIN(TestPlugin)
+HOTPLUGPP_PLUGIN_METADATA("TestPlugin", 1, 2, 3, "A test plugin for unit tests")
+
+#ifdef TEST_PLUGIN_FUNCTION_TABLE
+HOTPLUGPP_FUNCTION_TABLE(TestPlugin)
+#endif
@@ -0,0 +1,64 @@
+#include "hotplugpp/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace hotplugpp {
+namespace tests {
+
+TEST(ThreadPoolTest, DefaultThreadCountIsPositive) {
+    ThreadPool pool;
+    EXPECT_GT(pool.getThreadCount(), 0u);
+}
+
+TEST(ThreadPoolTest, ExplicitThreadCount) {
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.getThreadCount(), 3u);
+}
+
+TEST(ThreadPoolTest, RunsAllTasks) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([&counter]() { counter++; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, WaitCoversNestedTasks) {
+    ThreadPool pool(2);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &counter]() {
+            counter++;
+            pool.submit([&counter]() { counter++; });
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(counter.load(), 20);
+}
+
+TEST(ThreadPoolTest, WaitOnIdlePoolReturns) {
+    ThreadPool pool(2);
+    pool.wait();
+    SUCCEED();
+}
+
+TEST(ThreadPoolTest, DestructorDrainsQueue) {
+    std::atomic<int> counter{0};
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(counter.load(), 100);
+}
+
+} // namespace tests
+} // namespace hotplugpp
@@ -0,0 +1,217 @@
+#include "hotplugpp/hash.hpp"
+#include "hotplugpp/update_scheduler.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace {
+
+UpdateAccess reads(std::initializer_list<const char*> resources) {
+    UpdateAccess access;
+    for (const char* resource : resources) {
+        access.reads.push_back(fnv1a64(resource));
+    }
+    return access;
+}
+
+UpdateAccess writes(std::initializer_list<const char*> resources) {
+    UpdateAccess access;
+    for (const char* resource : resources) {
+        access.writes.push_back(fnv1a64(resource));
+    }
+    return access;
+}
+
+UpdateAccess exclusive() {
+    UpdateAccess access;
+    access.exclusive = true;
+    return access;
+}
+
+/// Records the order in which tasks finish
+class Recorder {
+  public:
+    explicit Recorder(size_t taskCount) : m_finishedAt(taskCount) {
+        for (auto& slot : m_finishedAt) {
+            slot.store(0);
+        }
+    }
+
+    void finish(uint32_t task) { m_finishedAt[task].store(++m_clock); }
+    uint64_t finishedAt(uint32_t task) const { return m_finishedAt[task].load(); }
+
+  private:
+    std::atomic<uint64_t> m_clock{0};
+    std::vector<std::atomic<uint64_t>> m_finishedAt;
+};
+
+} // namespace
+
+// ============================================================================
+// Graph Tests
+// ============================================================================
+
+TEST(UpdateSchedulerTest, IndependentTasksHaveNoDependencies) {
+    UpdateScheduler scheduler(1);
+    scheduler.build({writes({"a"}), writes({"b"}), reads({"c"}), reads({"c"})});
+
+    EXPECT_EQ(scheduler.getTaskCount(), 4u);
+    for (uint32_t task = 0; task < 4; ++task) {
+        EXPECT_TRUE(scheduler.getDependencies(task).empty()) << "task " << task;
+    }
+    EXPECT_EQ(scheduler.getCriticalPathLength(), 1u);
+}
+
+TEST(UpdateSchedulerTest, ConflictsBecomeEdges) {
+    UpdateScheduler scheduler(1);
+    scheduler.build({
+        writes({"world"}),  // 0
+        reads({"world"}),   // 1: read after write
+        reads({"world"}),   // 2: read after write, parallel to 1
+        writes({"world"}),  // 3: write after read
+        writes({"other"}),  // 4: unrelated
+    });
+
+    EXPECT_EQ(scheduler.getDependencies(1), std::vector<uint32_t>({0}));
+    EXPECT_EQ(scheduler.getDependencies(2), std::vector<uint32_t>({0}));
+    EXPECT_EQ(scheduler.getDependencies(3), std::vector<uint32_t>({0, 1, 2}));
+    EXPECT_TRUE(scheduler.getDependencies(4).empty());
+    EXPECT_EQ(scheduler.getCriticalPathLength(), 3u);
+}
+
+TEST(UpdateSchedulerTest, ReadWriteOfSameResourceIsNoSelfEdge) {
+    UpdateScheduler scheduler(1);
+    UpdateAccess access = writes({"a"});
+    access.reads.push_back(fnv1a64("a"));
+    scheduler.build({access, access});
+
+    EXPECT_TRUE(scheduler.getDependencies(0).empty());
+    EXPECT_EQ(scheduler.getDependencies(1), std::vector<uint32_t>({0}));
+}
+
+TEST(UpdateSchedulerTest, ExclusiveTaskIsABarrier) {
+    UpdateScheduler scheduler(1);
+    scheduler.build({writes({"a"}), writes({"b"}), exclusive(), writes({"c"})});
+
+    EXPECT_EQ(scheduler.getDependencies(2), std::vector<uint32_t>({0, 1}));
+    EXPECT_EQ(scheduler.getDependencies(3), std::vector<uint32_t>({2}));
+}
+
+// ============================================================================
+// Execution Tests
+// ============================================================================
+
+TEST(UpdateSchedulerTest, EmptyGraphRuns) {
+    UpdateScheduler scheduler(4);
+    scheduler.build({});
+    bool called = false;
+    scheduler.run([&called](uint32_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(UpdateSchedulerTest, SingleThreadRunsInlineInOrder) {
+    UpdateScheduler scheduler(1);
+    EXPECT_EQ(scheduler.getThreadCount(), 1u);
+    scheduler.build({writes({"a"}), writes({"a"}), writes({"a"})});
+
+    std::vector<uint32_t> order;
+    const auto caller = std::this_thread::get_id();
+    scheduler.run([&](uint32_t task) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        order.push_back(task);
+    });
+    EXPECT_EQ(order, std::vector<uint32_t>({0, 1, 2}));
+}
+
+TEST(UpdateSchedulerTest, EveryTaskRunsOncePerRun) {
+    const size_t taskCount = 200;
+    UpdateScheduler scheduler(4);
+    std::vector<UpdateAccess> accesses(taskCount);
+    scheduler.build(accesses);
+
+    std::vector<std::atomic<int>> runs(taskCount);
+    for (int round = 0; round < 20; ++round) {
+        scheduler.run([&runs](uint32_t task) { runs[task].fetch_add(1); });
+    }
+
+    for (size_t task = 0; task < taskCount; ++task) {
+        EXPECT_EQ(runs[task].load(), 20) << "task " << task;
+    }
+
+    uint64_t executed = 0;
+    for (size_t worker = 0; worker < scheduler.getThreadCount(); ++worker) {
+        executed += scheduler.getWorkerStats(worker).executed;
+    }
+    EXPECT_EQ(executed, taskCount * 20);
+
+    scheduler.resetStats();
+    EXPECT_EQ(scheduler.getWorkerStats(0).executed, 0u);
+}
+
+TEST(UpdateSchedulerTest, DependenciesFinishFirst) {
+    UpdateScheduler scheduler(4);
+    std::vector<UpdateAccess> accesses;
+    accesses.push_back(writes({"state"}));
+    for (int i = 0; i < 16; ++i) {
+        accesses.push_back(reads({"state"}));
+    }
+    accesses.push_back(writes({"state"}));
+    scheduler.build(accesses);
+
+    for (int round = 0; round < 50; ++round) {
+        Recorder recorder(accesses.size());
+        scheduler.run([&recorder](uint32_t task) { recorder.finish(task); });
+
+        const uint32_t last = static_cast<uint32_t>(accesses.size() - 1);
+        for (uint32_t reader = 1; reader < last; ++reader) {
+            EXPECT_LT(recorder.finishedAt(0), recorder.finishedAt(reader));
+            EXPECT_LT(recorder.finishedAt(reader), recorder.finishedAt(last));
+        }
+    }
+}
+
+TEST(UpdateSchedulerTest, WritersOfOneResourceNeverOverlap) {
+    const size_t taskCount = 64;
+    UpdateScheduler scheduler(4);
+    std::vector<UpdateAccess> accesses;
+    for (size_t i = 0; i < taskCount; ++i) {
+        // Two chains that may interleave with each other but not within themselves
+        accesses.push_back(writes({i % 2 ? "odd" : "even"}));
+    }
+    scheduler.build(accesses);
+    EXPECT_EQ(scheduler.getCriticalPathLength(), taskCount / 2);
+
+    std::atomic<int> inside[2] = {{0}, {0}};
+    std::atomic<bool> overlapped{false};
+    scheduler.run([&](uint32_t task) {
+        auto& counter = inside[task % 2];
+        if (counter.fetch_add(1) != 0) {
+            overlapped = true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        counter.fetch_sub(1);
+    });
+    EXPECT_FALSE(overlapped.load());
+}
+
+TEST(UpdateSchedulerTest, RebuildReplacesGraph) {
+    UpdateScheduler scheduler(2);
+    scheduler.build({writes({"a"}), writes({"a"})});
+    scheduler.build({writes({"a"}), writes({"b"}), writes({"c"})});
+
+    EXPECT_EQ(scheduler.getTaskCount(), 3u);
+    EXPECT_TRUE(scheduler.getDependencies(1).empty());
+
+    std::atomic<int> runs{0};
+    scheduler.run([&runs](uint32_t) { runs++; });
+    EXPECT_EQ(runs.load(), 3);
+}
+
+} // namespace tests
+} // namespace hotplugpp
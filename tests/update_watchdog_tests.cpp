@@ -0,0 +1,128 @@
+#include "hotplugpp/update_watchdog.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace hotplugpp {
+namespace tests {
+
+namespace {
+
+/// Poll until the condition holds or a generous deadline passes
+template <typename Condition>
+bool waitFor(Condition condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle Tests
+// ============================================================================
+
+TEST(UpdateWatchdogTest, StartAndStop) {
+    UpdateWatchdog watchdog;
+    EXPECT_FALSE(watchdog.isRunning());
+
+    ASSERT_TRUE(watchdog.start(std::chrono::milliseconds(10), nullptr));
+    EXPECT_TRUE(watchdog.isRunning());
+    EXPECT_EQ(watchdog.getLimit(), std::chrono::milliseconds(10));
+
+    watchdog.stop();
+    EXPECT_FALSE(watchdog.isRunning());
+    watchdog.stop();
+}
+
+TEST(UpdateWatchdogTest, RejectsNonPositiveLimit) {
+    UpdateWatchdog watchdog;
+    EXPECT_FALSE(watchdog.start(std::chrono::nanoseconds(0), nullptr));
+    EXPECT_FALSE(watchdog.isRunning());
+}
+
+TEST(UpdateWatchdogTest, ResizeSetsSlotCount) {
+    UpdateWatchdog watchdog;
+    EXPECT_EQ(watchdog.size(), 0u);
+    watchdog.resize(8);
+    EXPECT_EQ(watchdog.size(), 8u);
+    watchdog.resize(0);
+    EXPECT_EQ(watchdog.size(), 0u);
+}
+
+// ============================================================================
+// Stall Tests
+// ============================================================================
+
+TEST(UpdateWatchdogTest, ReportsStalledCallOnce) {
+    UpdateWatchdog watchdog;
+    watchdog.resize(4);
+
+    std::atomic<int> reports{0};
+    std::atomic<uint32_t> reportedSlot{~0u};
+    ASSERT_TRUE(watchdog.start(std::chrono::milliseconds(5),
+                               [&](uint32_t slot, std::chrono::nanoseconds elapsed) {
+                                   EXPECT_GE(elapsed, std::chrono::milliseconds(5));
+                                   reportedSlot.store(slot);
+                                   reports.fetch_add(1);
+                               }));
+
+    watchdog.begin(2);
+    ASSERT_TRUE(waitFor([&]() { return reports.load() > 0; }));
+    // Several more scans of the same call
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    watchdog.end(2);
+    watchdog.quiesce();
+
+    EXPECT_EQ(reports.load(), 1);
+    EXPECT_EQ(reportedSlot.load(), 2u);
+    EXPECT_EQ(watchdog.getStallCount(), 1u);
+}
+
+TEST(UpdateWatchdogTest, ShortCallsAreNotReported) {
+    UpdateWatchdog watchdog;
+    watchdog.resize(1);
+
+    std::atomic<int> reports{0};
+    ASSERT_TRUE(watchdog.start(std::chrono::seconds(1),
+                               [&](uint32_t, std::chrono::nanoseconds) { reports.fetch_add(1); }));
+
+    for (int i = 0; i < 100; ++i) {
+        watchdog.begin(0);
+        watchdog.end(0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    watchdog.stop();
+
+    EXPECT_EQ(reports.load(), 0);
+    EXPECT_EQ(watchdog.getStallCount(), 0u);
+}
+
+TEST(UpdateWatchdogTest, EachStalledCallIsReported) {
+    UpdateWatchdog watchdog;
+    watchdog.resize(1);
+
+    std::atomic<int> reports{0};
+    ASSERT_TRUE(watchdog.start(std::chrono::milliseconds(2),
+                               [&](uint32_t, std::chrono::nanoseconds) { reports.fetch_add(1); }));
+
+    for (int call = 1; call <= 2; ++call) {
+        watchdog.begin(0);
+        ASSERT_TRUE(waitFor([&]() { return reports.load() >= call; }));
+        watchdog.end(0);
+    }
+    watchdog.stop();
+
+    EXPECT_EQ(reports.load(), 2);
+}
+
+} // namespace tests
+} // namespace hotplugpp